@@ -0,0 +1,50 @@
+#include <benchmark/benchmark.h>
+#include <sg14/flat_map.h>
+#include <sg14/flat_set.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+// Compares like std::less, but isn't std::less, so it takes the comparison-sort path.
+struct OpaqueLess {
+    bool operator()(std::uint32_t a, std::uint32_t b) const { return a < b; }
+};
+
+static std::vector<std::uint32_t> get_sample_keys(size_t n)
+{
+    std::mt19937 g;
+    std::vector<std::uint32_t> v(n);
+    std::generate(v.begin(), v.end(), std::ref(g));
+    return v;
+}
+
+template<class FS>
+static void FlatSetReplace(benchmark::State& state)
+{
+    auto keys = get_sample_keys(state.range(0));
+    FS fs;
+    for (auto _ : state) {
+        fs.replace(keys);
+        benchmark::DoNotOptimize(fs.begin());
+    }
+    state.SetItemsProcessed(state.iterations() * keys.size());
+}
+BENCHMARK_TEMPLATE(FlatSetReplace, sg14::flat_set<std::uint32_t>)->RangeMultiplier(8)->Range(1 << 10, 1 << 22);
+BENCHMARK_TEMPLATE(FlatSetReplace, sg14::flat_set<std::uint32_t, OpaqueLess>)->RangeMultiplier(8)->Range(1 << 10, 1 << 22);
+
+template<class FM>
+static void FlatMapReplace(benchmark::State& state)
+{
+    auto keys = get_sample_keys(state.range(0));
+    std::vector<std::uint64_t> values(keys.begin(), keys.end());
+    FM fm;
+    for (auto _ : state) {
+        fm.replace(keys, values);
+        benchmark::DoNotOptimize(fm.begin());
+    }
+    state.SetItemsProcessed(state.iterations() * keys.size());
+}
+BENCHMARK_TEMPLATE(FlatMapReplace, sg14::flat_map<std::uint32_t, std::uint64_t>)->RangeMultiplier(8)->Range(1 << 10, 1 << 22);
+BENCHMARK_TEMPLATE(FlatMapReplace, sg14::flat_map<std::uint32_t, std::uint64_t, OpaqueLess>)->RangeMultiplier(8)->Range(1 << 10, 1 << 22);
@@ -0,0 +1,133 @@
+#include <benchmark/benchmark.h>
+#include <sg14/flat_index.h>
+#include <sg14/flat_set.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+static sg14::flat_set<std::uint32_t> get_sample_set(size_t n)
+{
+    std::mt19937 g;
+    std::vector<std::uint32_t> v(n);
+    std::generate(v.begin(), v.end(), std::ref(g));
+    return sg14::flat_set<std::uint32_t>(std::move(v));
+}
+
+static std::vector<std::uint32_t> get_sample_probes()
+{
+    std::mt19937 g(42);
+    std::vector<std::uint32_t> v(4096);
+    std::generate(v.begin(), v.end(), std::ref(g));
+    return v;
+}
+
+static void StdPartitionPoint(benchmark::State& state)
+{
+    auto fs = get_sample_set(state.range(0));
+    auto probes = get_sample_probes();
+    for (auto _ : state) {
+        for (std::uint32_t k : probes) {
+            auto it = std::partition_point(fs.begin(), fs.end(), [&](std::uint32_t elt) { return elt < k; });
+            benchmark::DoNotOptimize(it);
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * probes.size());
+}
+BENCHMARK(StdPartitionPoint)->RangeMultiplier(8)->Range(1 << 10, 1 << 22);
+
+static void FlatSetLowerBound(benchmark::State& state)
+{
+    auto fs = get_sample_set(state.range(0));
+    auto probes = get_sample_probes();
+    for (auto _ : state) {
+        for (std::uint32_t k : probes) {
+            auto it = fs.lower_bound(k);
+            benchmark::DoNotOptimize(it);
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * probes.size());
+}
+BENCHMARK(FlatSetLowerBound)->RangeMultiplier(8)->Range(1 << 10, 1 << 22);
+
+static void FlatIndexLowerBound(benchmark::State& state)
+{
+    auto fs = get_sample_set(state.range(0));
+    auto probes = get_sample_probes();
+    sg14::flat_index<sg14::flat_set<std::uint32_t>> idx(fs);
+    for (auto _ : state) {
+        for (std::uint32_t k : probes) {
+            auto it = idx.lower_bound(k);
+            benchmark::DoNotOptimize(it);
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * probes.size());
+}
+BENCHMARK(FlatIndexLowerBound)->RangeMultiplier(8)->Range(1 << 10, 1 << 22);
+
+// A comparator that isn't std::less opts out of the vectorized final stage.
+struct OpaqueLess {
+    bool operator()(std::uint32_t a, std::uint32_t b) const { return a < b; }
+};
+
+static void FlatSetLowerBoundOpaqueLess(benchmark::State& state)
+{
+    auto v = get_sample_set(state.range(0)).extract();
+    auto fs = sg14::flat_set<std::uint32_t, OpaqueLess>(std::move(v));
+    auto probes = get_sample_probes();
+    for (auto _ : state) {
+        for (std::uint32_t k : probes) {
+            auto it = fs.lower_bound(k);
+            benchmark::DoNotOptimize(it);
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * probes.size());
+}
+BENCHMARK(FlatSetLowerBoundOpaqueLess)->RangeMultiplier(8)->Range(1 << 10, 1 << 22);
+
+static void FlatSetFindLoop(benchmark::State& state)
+{
+    auto fs = get_sample_set(state.range(0));
+    auto probes = get_sample_probes();
+    std::vector<sg14::flat_set<std::uint32_t>::iterator> results(probes.size());
+    for (auto _ : state) {
+        auto out = results.begin();
+        for (std::uint32_t k : probes) {
+            *out++ = fs.find(k);
+        }
+        benchmark::DoNotOptimize(results.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * probes.size());
+}
+BENCHMARK(FlatSetFindLoop)->RangeMultiplier(8)->Range(1 << 10, 1 << 22);
+
+static void FlatSetFindMany(benchmark::State& state)
+{
+    auto fs = get_sample_set(state.range(0));
+    auto probes = get_sample_probes();
+    std::vector<sg14::flat_set<std::uint32_t>::iterator> results(probes.size());
+    for (auto _ : state) {
+        fs.find_many(probes.begin(), probes.end(), results.begin());
+        benchmark::DoNotOptimize(results.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * probes.size());
+}
+BENCHMARK(FlatSetFindMany)->RangeMultiplier(8)->Range(1 << 10, 1 << 22);
+
+static void FlatSetFindManySorted(benchmark::State& state)
+{
+    auto fs = get_sample_set(state.range(0));
+    auto probes = get_sample_probes();
+    std::sort(probes.begin(), probes.end());
+    std::vector<sg14::flat_set<std::uint32_t>::iterator> results(probes.size());
+    for (auto _ : state) {
+        fs.find_many(probes.begin(), probes.end(), results.begin());
+        benchmark::DoNotOptimize(results.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * probes.size());
+}
+BENCHMARK(FlatSetFindManySorted)->RangeMultiplier(8)->Range(1 << 10, 1 << 22);
@@ -0,0 +1,111 @@
+#include <benchmark/benchmark.h>
+#include <sg14/flat_map.h>
+#include <sg14/flat_set.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <map>
+#include <random>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+template<class K> K make_key(std::uint32_t i) { return K(i); }
+template<> std::string make_key<std::string>(std::uint32_t i) { return "key" + std::to_string(i); }
+
+template<class K>
+static std::vector<K> get_sample_keys(size_t n, unsigned seed = 0)
+{
+    std::mt19937 g(seed);
+    std::vector<K> v;
+    v.reserve(n);
+    for (size_t i = 0; i < n; ++i) {
+        v.push_back(make_key<K>(g()));
+    }
+    return v;
+}
+
+template<class M>
+static void MapBulkInsert(benchmark::State& state)
+{
+    using K = typename M::key_type;
+    auto keys = get_sample_keys<K>(state.range(0));
+    std::vector<std::pair<K, int>> pairs;
+    for (const auto& k : keys) {
+        pairs.emplace_back(k, 0);
+    }
+    for (auto _ : state) {
+        M m;
+        m.insert(pairs.begin(), pairs.end());
+        benchmark::DoNotOptimize(m);
+    }
+    state.SetItemsProcessed(state.iterations() * pairs.size());
+}
+BENCHMARK_TEMPLATE(MapBulkInsert, sg14::flat_map<std::uint32_t, int>)->RangeMultiplier(16)->Range(1 << 6, 1 << 18);
+BENCHMARK_TEMPLATE(MapBulkInsert, std::map<std::uint32_t, int>)->RangeMultiplier(16)->Range(1 << 6, 1 << 18);
+BENCHMARK_TEMPLATE(MapBulkInsert, sg14::flat_map<std::string, int>)->RangeMultiplier(16)->Range(1 << 6, 1 << 18);
+BENCHMARK_TEMPLATE(MapBulkInsert, std::map<std::string, int>)->RangeMultiplier(16)->Range(1 << 6, 1 << 18);
+
+template<class M>
+static void MapLookup(benchmark::State& state)
+{
+    using K = typename M::key_type;
+    auto keys = get_sample_keys<K>(state.range(0));
+    M m;
+    for (const auto& k : keys) {
+        m.emplace(k, 0);
+    }
+    // Half of the probes are drawn from the map's keys, so they hit whatever its size;
+    // the other half (almost certainly) miss.
+    std::mt19937 g(1);
+    std::vector<K> probes;
+    for (int i = 0; i < 2048; ++i) {
+        probes.push_back(keys[g() % keys.size()]);
+    }
+    auto misses = get_sample_keys<K>(2048, 42);
+    probes.insert(probes.end(), misses.begin(), misses.end());
+    std::shuffle(probes.begin(), probes.end(), g);
+    for (auto _ : state) {
+        for (const auto& k : probes) {
+            benchmark::DoNotOptimize(m.find(k));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * probes.size());
+}
+BENCHMARK_TEMPLATE(MapLookup, sg14::flat_map<std::uint32_t, int>)->RangeMultiplier(16)->Range(1 << 6, 1 << 18);
+BENCHMARK_TEMPLATE(MapLookup, std::map<std::uint32_t, int>)->RangeMultiplier(16)->Range(1 << 6, 1 << 18);
+BENCHMARK_TEMPLATE(MapLookup, sg14::flat_map<std::string, int>)->RangeMultiplier(16)->Range(1 << 6, 1 << 18);
+BENCHMARK_TEMPLATE(MapLookup, std::map<std::string, int>)->RangeMultiplier(16)->Range(1 << 6, 1 << 18);
+
+template<class S>
+static void SetBulkInsert(benchmark::State& state)
+{
+    using K = typename S::key_type;
+    auto keys = get_sample_keys<K>(state.range(0));
+    for (auto _ : state) {
+        S s;
+        s.insert(keys.begin(), keys.end());
+        benchmark::DoNotOptimize(s);
+    }
+    state.SetItemsProcessed(state.iterations() * keys.size());
+}
+BENCHMARK_TEMPLATE(SetBulkInsert, sg14::flat_set<std::uint32_t>)->RangeMultiplier(16)->Range(1 << 6, 1 << 18);
+BENCHMARK_TEMPLATE(SetBulkInsert, std::set<std::uint32_t>)->RangeMultiplier(16)->Range(1 << 6, 1 << 18);
+
+template<class S>
+static void SetLookup(benchmark::State& state)
+{
+    using K = typename S::key_type;
+    auto keys = get_sample_keys<K>(state.range(0));
+    S s(keys.begin(), keys.end());
+    auto probes = get_sample_keys<K>(4096, 42);
+    for (auto _ : state) {
+        for (const auto& k : probes) {
+            benchmark::DoNotOptimize(s.find(k));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * probes.size());
+}
+BENCHMARK_TEMPLATE(SetLookup, sg14::flat_set<std::uint32_t>)->RangeMultiplier(16)->Range(1 << 6, 1 << 18);
+BENCHMARK_TEMPLATE(SetLookup, std::set<std::uint32_t>)->RangeMultiplier(16)->Range(1 << 6, 1 << 18);
@@ -0,0 +1,130 @@
+#if __cplusplus >= 201703
+
+#include <benchmark/benchmark.h>
+#include <sg14/hive.h>
+
+#include <algorithm>
+#include <array>
+#include <list>
+#include <random>
+#include <utility>
+#include <vector>
+
+// A value type big enough that a hive's per-element overhead is small beside it.
+struct Payload64 {
+    int key;
+    std::array<int, 15> rest;
+    Payload64(int k = 0) : key(k), rest{} {}
+    friend bool operator<(const Payload64& a, const Payload64& b) { return a.key < b.key; }
+};
+
+static int key_of(int i) { return i; }
+static int key_of(const Payload64& p) { return p.key; }
+
+template<class T> static void add(sg14::hive<T>& h, T value) { h.insert(std::move(value)); }
+template<class T> static void add(std::list<T>& lst, T value) { lst.push_back(std::move(value)); }
+
+template<class C>
+static C make_filled(size_t n)
+{
+    std::mt19937 g;
+    C c;
+    for (size_t i = 0; i < n; ++i) {
+        add(c, typename C::value_type(int(g() % 1'000'000)));
+    }
+    return c;
+}
+
+// Erases percent% of the elements, chosen at random.
+template<class C>
+static void erase_randomly(C& c, int percent)
+{
+    std::mt19937 g(42);
+    for (auto it = c.begin(); it != c.end(); ) {
+        it = (int(g() % 100) < percent) ? c.erase(it) : std::next(it);
+    }
+}
+
+template<class C>
+static void InsertEraseChurn(benchmark::State& state)
+{
+    auto c = make_filled<C>(state.range(0));
+    std::mt19937 g;
+    for (auto _ : state) {
+        // Erase about a tenth of the elements, then put as many back.
+        size_t erased = 0;
+        for (auto it = c.begin(); it != c.end(); ) {
+            if (g() % 10 == 0) {
+                it = c.erase(it);
+                ++erased;
+            } else {
+                ++it;
+            }
+        }
+        for (size_t i = 0; i < erased; ++i) {
+            add(c, typename C::value_type(int(i)));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK_TEMPLATE(InsertEraseChurn, sg14::hive<int>)->RangeMultiplier(16)->Range(1 << 10, 1 << 18);
+BENCHMARK_TEMPLATE(InsertEraseChurn, std::list<int>)->RangeMultiplier(16)->Range(1 << 10, 1 << 18);
+BENCHMARK_TEMPLATE(InsertEraseChurn, sg14::hive<Payload64>)->RangeMultiplier(16)->Range(1 << 10, 1 << 18);
+BENCHMARK_TEMPLATE(InsertEraseChurn, std::list<Payload64>)->RangeMultiplier(16)->Range(1 << 10, 1 << 18);
+
+// Args: number of elements inserted, and the percentage of them erased before iterating.
+template<class C>
+static void Iterate(benchmark::State& state)
+{
+    auto c = make_filled<C>(state.range(0));
+    erase_randomly(c, int(state.range(1)));
+    for (auto _ : state) {
+        long long sum = 0;
+        for (const auto& x : c) {
+            sum += key_of(x);
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * c.size());
+}
+BENCHMARK_TEMPLATE(Iterate, sg14::hive<int>)->ArgsProduct({{1 << 12, 1 << 20}, {0, 25, 50, 90}});
+BENCHMARK_TEMPLATE(Iterate, std::list<int>)->ArgsProduct({{1 << 12, 1 << 20}, {0, 25, 50, 90}});
+BENCHMARK_TEMPLATE(Iterate, sg14::hive<Payload64>)->ArgsProduct({{1 << 12, 1 << 20}, {0, 25, 50, 90}});
+
+template<class T>
+static void HiveSort(benchmark::State& state)
+{
+    // Copying a hive packs it, so erase from the copy; sort() must then skip the holes.
+    auto orig = make_filled<sg14::hive<T>>(state.range(0));
+    size_t n = 0;
+    for (auto _ : state) {
+        state.PauseTiming();
+        auto h = orig;
+        erase_randomly(h, 25);
+        n = h.size();
+        state.ResumeTiming();
+        h.sort();
+        benchmark::DoNotOptimize(*h.begin());
+    }
+    state.SetItemsProcessed(state.iterations() * n);
+}
+BENCHMARK_TEMPLATE(HiveSort, int)->RangeMultiplier(16)->Range(1 << 10, 1 << 18);
+BENCHMARK_TEMPLATE(HiveSort, Payload64)->RangeMultiplier(16)->Range(1 << 10, 1 << 18);
+
+template<class T>
+static void StdListSort(benchmark::State& state)
+{
+    auto orig = make_filled<std::list<T>>(state.range(0));
+    erase_randomly(orig, 25);
+    for (auto _ : state) {
+        state.PauseTiming();
+        auto lst = orig;
+        state.ResumeTiming();
+        lst.sort();
+        benchmark::DoNotOptimize(*lst.begin());
+    }
+    state.SetItemsProcessed(state.iterations() * orig.size());
+}
+BENCHMARK_TEMPLATE(StdListSort, int)->RangeMultiplier(16)->Range(1 << 10, 1 << 18);
+
+#endif // __cplusplus >= 201703
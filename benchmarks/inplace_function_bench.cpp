@@ -0,0 +1,69 @@
+#include <benchmark/benchmark.h>
+#include <sg14/inplace_function.h>
+
+#include <array>
+#include <functional>
+#include <utility>
+#include <vector>
+
+// A callable that carries Bytes bytes of state, so that std::function
+// must allocate once it outgrows its small-buffer optimization.
+template<size_t Bytes>
+struct Adder {
+    std::array<unsigned char, Bytes> pad{};
+    int k;
+    explicit Adder(int k) : k(k) {}
+    int operator()(int x) const { return x + k + pad[0]; }
+};
+
+template<class F, size_t Bytes>
+static void Call(benchmark::State& state)
+{
+    std::vector<F> fs;
+    for (int i = 0; i < 256; ++i) {
+        fs.emplace_back(Adder<Bytes>(i));
+    }
+    int acc = 0;
+    for (auto _ : state) {
+        for (auto& f : fs) {
+            acc = f(acc);
+        }
+        benchmark::DoNotOptimize(acc);
+    }
+    state.SetItemsProcessed(state.iterations() * fs.size());
+}
+BENCHMARK_TEMPLATE(Call, sg14::inplace_function<int(int), 64>, 8);
+BENCHMARK_TEMPLATE(Call, std::function<int(int)>, 8);
+BENCHMARK_TEMPLATE(Call, sg14::inplace_function<int(int), 64>, 48);
+BENCHMARK_TEMPLATE(Call, std::function<int(int)>, 48);
+
+template<class F, size_t Bytes>
+static void Construct(benchmark::State& state)
+{
+    for (auto _ : state) {
+        F f = Adder<Bytes>(1);
+        benchmark::DoNotOptimize(f);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK_TEMPLATE(Construct, sg14::inplace_function<int(int), 64>, 8);
+BENCHMARK_TEMPLATE(Construct, std::function<int(int)>, 8);
+BENCHMARK_TEMPLATE(Construct, sg14::inplace_function<int(int), 64>, 48);
+BENCHMARK_TEMPLATE(Construct, std::function<int(int)>, 48);
+
+template<class F, size_t Bytes>
+static void Move(benchmark::State& state)
+{
+    F a = Adder<Bytes>(1);
+    F b;
+    for (auto _ : state) {
+        b = std::move(a);
+        a = std::move(b);
+        benchmark::DoNotOptimize(a);
+    }
+    state.SetItemsProcessed(state.iterations() * 2);
+}
+BENCHMARK_TEMPLATE(Move, sg14::inplace_function<int(int), 64>, 8);
+BENCHMARK_TEMPLATE(Move, std::function<int(int)>, 8);
+BENCHMARK_TEMPLATE(Move, sg14::inplace_function<int(int), 64>, 48);
+BENCHMARK_TEMPLATE(Move, std::function<int(int)>, 48);
@@ -0,0 +1,76 @@
+#if __cplusplus >= 201703
+
+#include <benchmark/benchmark.h>
+#include <sg14/inplace_vector.h>
+
+#include <array>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+template<class T> T make_value(int i) { return T(i); }
+template<> std::string make_value<std::string>(int i) { return std::string(size_t(i % 32), 'x'); }
+
+// Fills a fresh vector with N elements; std::vector gets a reserve() to match.
+template<class V>
+static void PushBack(benchmark::State& state)
+{
+    using T = typename V::value_type;
+    std::vector<T> values;
+    for (int i = 0; i < 64; ++i) {
+        values.push_back(make_value<T>(i));
+    }
+    for (auto _ : state) {
+        V v;
+        if constexpr (std::is_same_v<V, std::vector<T>>) {
+            v.reserve(64);
+        }
+        for (const auto& x : values) {
+            v.push_back(x);
+        }
+        benchmark::DoNotOptimize(v.data());
+    }
+    state.SetItemsProcessed(state.iterations() * values.size());
+}
+BENCHMARK_TEMPLATE(PushBack, sg14::inplace_vector<int, 64>);
+BENCHMARK_TEMPLATE(PushBack, sg14::small_vector<int, 64>);
+BENCHMARK_TEMPLATE(PushBack, std::vector<int>);
+BENCHMARK_TEMPLATE(PushBack, sg14::inplace_vector<std::string, 64>);
+BENCHMARK_TEMPLATE(PushBack, sg14::small_vector<std::string, 64>);
+BENCHMARK_TEMPLATE(PushBack, std::vector<std::string>);
+
+// Copies a vector of state.range(0) elements into a small_vector<T, 16>,
+// which spills to the heap once the size exceeds 16.
+template<class T>
+static void SmallVectorCopy(benchmark::State& state)
+{
+    sg14::small_vector<T, 16> v;
+    for (int i = 0; i < state.range(0); ++i) {
+        v.push_back(make_value<T>(i));
+    }
+    for (auto _ : state) {
+        auto w = v;
+        benchmark::DoNotOptimize(w.data());
+    }
+    state.SetItemsProcessed(state.iterations() * v.size());
+}
+BENCHMARK_TEMPLATE(SmallVectorCopy, int)->RangeMultiplier(2)->Range(4, 64);
+BENCHMARK_TEMPLATE(SmallVectorCopy, std::string)->RangeMultiplier(2)->Range(4, 64);
+
+template<class V>
+static void Iterate(benchmark::State& state)
+{
+    V v(64);
+    for (auto _ : state) {
+        long long sum = 0;
+        for (const auto& x : v) {
+            sum += x[0];
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * v.size());
+}
+BENCHMARK_TEMPLATE(Iterate, sg14::inplace_vector<std::array<int, 4>, 64>);
+BENCHMARK_TEMPLATE(Iterate, std::vector<std::array<int, 4>>);
+
+#endif // __cplusplus >= 201703
@@ -0,0 +1,60 @@
+#include <benchmark/benchmark.h>
+#include <sg14/ring_span.h>
+
+#include <array>
+#include <cstdint>
+#include <deque>
+#include <vector>
+
+// Keeps the buffer half full, pushing one element and popping one per step.
+template<class T>
+static void RingSpanPushPop(benchmark::State& state)
+{
+    std::vector<T> buffer(state.range(0));
+    sg14::ring_span<T> r(buffer.begin(), buffer.end());
+    for (size_t i = 0; i < buffer.size() / 2; ++i) {
+        r.push_back(T());
+    }
+    for (auto _ : state) {
+        for (int i = 0; i < 1024; ++i) {
+            r.push_back(T());
+            benchmark::DoNotOptimize(r.pop_front());
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * 1024);
+}
+BENCHMARK_TEMPLATE(RingSpanPushPop, std::uint32_t)->RangeMultiplier(16)->Range(1 << 4, 1 << 16);
+BENCHMARK_TEMPLATE(RingSpanPushPop, std::array<int, 16>)->RangeMultiplier(16)->Range(1 << 4, 1 << 16);
+
+template<class T>
+static void StdDequePushPop(benchmark::State& state)
+{
+    std::deque<T> d(state.range(0) / 2);
+    for (auto _ : state) {
+        for (int i = 0; i < 1024; ++i) {
+            d.push_back(T());
+            benchmark::DoNotOptimize(d.front());
+            d.pop_front();
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * 1024);
+}
+BENCHMARK_TEMPLATE(StdDequePushPop, std::uint32_t)->RangeMultiplier(16)->Range(1 << 4, 1 << 16);
+BENCHMARK_TEMPLATE(StdDequePushPop, std::array<int, 16>)->RangeMultiplier(16)->Range(1 << 4, 1 << 16);
+
+// Pushes a batch of state.range(1) elements at a time, then drains it.
+template<class T>
+static void RingSpanBatchPush(benchmark::State& state)
+{
+    std::vector<T> buffer(state.range(0));
+    std::vector<T> batch(state.range(1));
+    sg14::ring_span<T> r(buffer.begin(), buffer.end());
+    for (auto _ : state) {
+        r.push_back(batch.begin(), batch.end());
+        while (!r.empty()) {
+            benchmark::DoNotOptimize(r.pop_front());
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * batch.size());
+}
+BENCHMARK_TEMPLATE(RingSpanBatchPush, std::uint32_t)->ArgsProduct({{1 << 10, 1 << 16}, {16, 256, 1024}});
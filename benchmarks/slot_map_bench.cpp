@@ -0,0 +1,78 @@
+#include <benchmark/benchmark.h>
+#include <sg14/slot_map.h>
+
+#include <algorithm>
+#include <array>
+#include <random>
+#include <unordered_map>
+#include <vector>
+
+// slot_map hands out its own keys; std::unordered_map is given sequential ones.
+template<class T>
+struct SlotMapAdaptor {
+    using key_type = typename sg14::slot_map<T>::key_type;
+    sg14::slot_map<T> m;
+    key_type insert(const T& value) { return m.insert(value); }
+    void erase(const key_type& k) { m.erase(k); }
+    const T *find(const key_type& k) const { auto it = m.find(k); return it == m.end() ? nullptr : &*it; }
+};
+
+template<class T>
+struct UnorderedMapAdaptor {
+    using key_type = unsigned;
+    std::unordered_map<unsigned, T> m;
+    unsigned next = 0;
+    key_type insert(const T& value) { m.emplace(next, value); return next++; }
+    void erase(const key_type& k) { m.erase(k); }
+    const T *find(const key_type& k) const { auto it = m.find(k); return it == m.end() ? nullptr : &it->second; }
+};
+
+using Payload64 = std::array<int, 16>;
+
+template<class M>
+static void InsertErase(benchmark::State& state)
+{
+    size_t n = state.range(0);
+    for (auto _ : state) {
+        M m;
+        std::vector<typename M::key_type> keys;
+        keys.reserve(n);
+        for (size_t i = 0; i < n; ++i) {
+            keys.push_back(m.insert({}));
+        }
+        for (size_t i = 0; i < n; i += 2) {
+            m.erase(keys[i]);
+        }
+        for (size_t i = 0; i < n / 2; ++i) {
+            keys[2 * i] = m.insert({});
+        }
+        benchmark::DoNotOptimize(m);
+    }
+    state.SetItemsProcessed(state.iterations() * n * 2);
+}
+BENCHMARK_TEMPLATE(InsertErase, SlotMapAdaptor<int>)->RangeMultiplier(16)->Range(1 << 8, 1 << 20);
+BENCHMARK_TEMPLATE(InsertErase, UnorderedMapAdaptor<int>)->RangeMultiplier(16)->Range(1 << 8, 1 << 20);
+BENCHMARK_TEMPLATE(InsertErase, SlotMapAdaptor<Payload64>)->RangeMultiplier(16)->Range(1 << 8, 1 << 20);
+BENCHMARK_TEMPLATE(InsertErase, UnorderedMapAdaptor<Payload64>)->RangeMultiplier(16)->Range(1 << 8, 1 << 20);
+
+template<class M>
+static void Find(benchmark::State& state)
+{
+    size_t n = state.range(0);
+    M m;
+    std::vector<typename M::key_type> keys;
+    for (size_t i = 0; i < n; ++i) {
+        keys.push_back(m.insert({}));
+    }
+    std::shuffle(keys.begin(), keys.end(), std::mt19937());
+    for (auto _ : state) {
+        for (const auto& k : keys) {
+            benchmark::DoNotOptimize(m.find(k));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * n);
+}
+BENCHMARK_TEMPLATE(Find, SlotMapAdaptor<int>)->RangeMultiplier(16)->Range(1 << 8, 1 << 20);
+BENCHMARK_TEMPLATE(Find, UnorderedMapAdaptor<int>)->RangeMultiplier(16)->Range(1 << 8, 1 << 20);
+BENCHMARK_TEMPLATE(Find, SlotMapAdaptor<Payload64>)->RangeMultiplier(16)->Range(1 << 8, 1 << 20);
+BENCHMARK_TEMPLATE(Find, UnorderedMapAdaptor<Payload64>)->RangeMultiplier(16)->Range(1 << 8, 1 << 20);
@@ -1,8 +1,14 @@
 
 #include <benchmark/benchmark.h>
 #include <sg14/algorithm_ext.h>
+#include <algorithm>
+#include <array>
+#include <functional>
 #include <random>
 #include <vector>
+#if SG14_EXECUTION_POLICIES
+#include <execution>
+#endif
 
 static std::vector<std::array<int, 16>> get_sample_data()
 {
@@ -77,4 +83,64 @@ static void StdRemoveIf(benchmark::State& state)
 }
 BENCHMARK(StdRemoveIf);
 
+// A cheap predicate over a trivially copyable type, where unstable_remove_if
+// works a block at a time instead of branching on each element.
+static std::vector<int> get_int_sample_data()
+{
+    std::mt19937 g;
+    auto v = std::vector<int>(1'000'000);
+    std::generate(v.begin(), v.end(), std::ref(g));
+    return v;
+}
+
+static auto isOddInt = [](int t) { return (t & 1) != 0; };
+
+template<class F>
+static void RemoveInts(benchmark::State& state, F algorithm)
+{
+    auto orig = get_int_sample_data();
+    auto v = orig;
+
+    for (auto _ : state) {
+        auto it = algorithm(v.begin(), v.end(), isOddInt);
+        state.PauseTiming();
+        benchmark::DoNotOptimize(it);
+        benchmark::ClobberMemory();
+        std::copy(orig.begin(), orig.end(), v.begin());
+        state.ResumeTiming();
+    }
+}
+
+static void UnstableRemoveIfInts(benchmark::State& state)
+{
+    RemoveInts(state, [](auto first, auto last, auto p) { return sg14::unstable_remove_if(first, last, p); });
+}
+BENCHMARK(UnstableRemoveIfInts);
+
+static void StdPartitionInts(benchmark::State& state)
+{
+    RemoveInts(state, [](auto first, auto last, auto p) { return std::partition(first, last, p); });
+}
+BENCHMARK(StdPartitionInts);
+
+static void StdRemoveIfInts(benchmark::State& state)
+{
+    RemoveInts(state, [](auto first, auto last, auto p) { return std::remove_if(first, last, p); });
+}
+BENCHMARK(StdRemoveIfInts);
+
+#if SG14_EXECUTION_POLICIES
+static void ParallelUnstableRemoveIfInts(benchmark::State& state)
+{
+    RemoveInts(state, [](auto first, auto last, auto p) { return sg14::unstable_remove_if(std::execution::par, first, last, p); });
+}
+BENCHMARK(ParallelUnstableRemoveIfInts);
+
+static void ParallelStdRemoveIfInts(benchmark::State& state)
+{
+    RemoveInts(state, [](auto first, auto last, auto p) { return std::remove_if(std::execution::par, first, last, p); });
+}
+BENCHMARK(ParallelStdRemoveIfInts);
+#endif // SG14_EXECUTION_POLICIES
+
 BENCHMARK_MAIN();
@@ -1,21 +1,62 @@
 #pragma once
 
+#include <stdint.h>
+#include <string.h>
 #include <algorithm>
 #include <iterator>
 #include <memory>
+#include <type_traits>
 #include <utility>
 
+#ifndef SG14_EXECUTION_POLICIES
+ #define SG14_EXECUTION_POLICIES 0  // opt in to the std::execution overloads; this may require linking TBB
+#endif
+
+#if SG14_EXECUTION_POLICIES
+#include <execution>
+#include <vector>
+#endif
+
 namespace sg14 {
 
+namespace relocate_detail {
+
+// A type whose bytes can be moved with memmove, ending the old object's lifetime.
+template<class T>
+struct is_trivially_relocatable : std::integral_constant<bool,
+#if defined(__cpp_lib_trivially_relocatable)
+  std::is_trivially_relocatable<T>::value
+#else
+  std::is_trivially_move_constructible<T>::value && std::is_trivially_destructible<T>::value
+#endif // __cpp_lib_trivially_relocatable
+> {};
+
+template<class It, class Out>
+struct can_memmove : std::false_type {};
+
+template<class T>
+struct can_memmove<T*, T*> : is_trivially_relocatable<T> {};
+
 template<class FwdIt>
-void destroy(FwdIt begin, FwdIt end) {
+void destroy(FwdIt, FwdIt, std::true_type) {}
+
+template<class FwdIt>
+void destroy(FwdIt begin, FwdIt end, std::false_type) {
   typedef typename std::iterator_traits<FwdIt>::value_type T;
   while (begin != end) {
-    begin->~T();
+    std::addressof(*begin)->~T();
     ++begin;
   }
 }
 
+} // namespace relocate_detail
+
+template<class FwdIt>
+void destroy(FwdIt begin, FwdIt end) {
+  typedef typename std::iterator_traits<FwdIt>::value_type T;
+  relocate_detail::destroy(begin, end, std::is_trivially_destructible<T>());
+}
+
 template<class SrcIt, class Sentinel, class FwdIt>
 FwdIt uninitialized_move(SrcIt SrcBegin, Sentinel SrcEnd, FwdIt Dst) {
   typedef typename std::iterator_traits<FwdIt>::value_type T;
@@ -65,11 +106,74 @@ FwdIt uninitialized_default_construct(FwdIt first, Sentinel last) {
   }
 }
 
+namespace relocate_detail {
+
+template<class T>
+T *uninitialized_relocate(T *first, T *last, T *dest, std::true_type) {
+  size_t n = size_t(last - first);
+  if (n != 0) {
+    ::memmove(static_cast<void*>(dest), static_cast<const void*>(first), n * sizeof(T));
+  }
+  return dest + n;
+}
+
+template<class SrcIt, class FwdIt>
+FwdIt uninitialized_relocate(SrcIt first, SrcIt last, FwdIt dest, std::false_type) {
+  typedef typename std::iterator_traits<FwdIt>::value_type T;
+  FwdIt current = dest;
+  try {
+    while (first != last) {
+      ::new (static_cast<void*>(std::addressof(*current))) T(std::move(*first));
+      std::addressof(*first)->~T();
+      ++current;
+      ++first;
+    }
+    return current;
+  } catch (...) {
+    sg14::destroy(first, last);
+    sg14::destroy(dest, current);
+    throw;
+  }
+}
+
+template<class T>
+T *relocate_at(T *source, T *dest, std::true_type) {
+  ::memmove(static_cast<void*>(dest), static_cast<const void*>(source), sizeof(T));
+  return dest;
+}
+
+template<class T>
+T *relocate_at(T *source, T *dest, std::false_type) {
+  struct guard {
+    T *t_;
+    ~guard() { t_->~T(); }
+  } g{source};
+  return ::new (static_cast<void*>(dest)) T(std::move(*source));
+}
+
+} // namespace relocate_detail
+
+// Moves [first, last) into the uninitialized range at dest, ending the lifetimes of the
+// originals, as proposed in P1144. Between pointers to a trivially relocatable T this is
+// a single memmove, so dest may overlap the source range; otherwise it is a move and a
+// destroy per element, and dest may overlap only by preceding first. If an exception is
+// thrown, the elements not yet relocated and those already relocated are all destroyed.
+template<class SrcIt, class FwdIt>
+FwdIt uninitialized_relocate(SrcIt first, SrcIt last, FwdIt dest) {
+  return relocate_detail::uninitialized_relocate(first, last, dest, relocate_detail::can_memmove<SrcIt, FwdIt>());
+}
+
+// Moves *source into the uninitialized storage at dest and ends the lifetime of *source,
+// even if the move throws.
+template<class T>
+T *relocate_at(T *source, T *dest) {
+  return relocate_detail::relocate_at(source, dest, relocate_detail::is_trivially_relocatable<T>());
+}
+
+namespace unstable_remove_detail {
+
 template<class BidirIt, class UnaryPredicate>
-#if __cplusplus >= 201703L
-[[nodiscard]]
-#endif
-BidirIt unstable_remove_if(BidirIt first, BidirIt last, UnaryPredicate p) {
+BidirIt remove_if_scalar(BidirIt first, BidirIt last, UnaryPredicate& p) {
   while (true) {
     // Find the first instance of "p"...
     while (true) {
@@ -97,36 +201,194 @@ BidirIt unstable_remove_if(BidirIt first, BidirIt last, UnaryPredicate p) {
   }
 }
 
+inline int countr_zero(uint64_t m) {
+#if defined(__GNUC__) || defined(__clang__)
+  return __builtin_ctzll(m);
+#else
+  int i = 0;
+  for (; !(m & 1); m >>= 1) {
+    ++i;
+  }
+  return i;
+#endif
+}
+
+inline int highest_bit(uint64_t m) {
+#if defined(__GNUC__) || defined(__clang__)
+  return 63 - __builtin_clzll(m);
+#else
+  int i = 63;
+  for (; !(m >> 63); m <<= 1) {
+    --i;
+  }
+  return i;
+#endif
+}
+
+// Bit i of the result is set if p(first[i]) == want. The loop has no branches, so
+// for a cheap predicate on a trivially copyable type the compiler can vectorize it.
+template<class RandomIt, class UnaryPredicate>
+uint64_t mask64(RandomIt first, UnaryPredicate& p, bool want) {
+  uint64_t m = 0;
+  for (int i = 0; i < 64; ++i) {
+    m |= uint64_t(bool(p(first[i])) == want) << i;
+  }
+  return m;
+}
+
+// The same two-pointer scheme, but a block at a time, as in Edelkamp and Weiss's
+// BlockQuicksort: collect the "p" positions of the front block and the "not p"
+// positions of the back block as bitmasks, then pair them off without branching
+// on the predicate. Each move still takes a "not p" from the back to a "p" at the front.
+template<class RandomIt, class UnaryPredicate>
+RandomIt remove_if_blocks(RandomIt first, RandomIt last, UnaryPredicate& p) {
+  const int B = 64;
+  bool have_front = false;
+  bool have_back = false;
+  uint64_t holes = 0;  // the unfilled "p" positions in [first, first + B)
+  uint64_t keeps = 0;  // the unmoved "not p" positions in [last - B, last)
+  int filled = -1;  // the highest hole filled so far
+  int moved = B;  // the lowest keeper moved so far
+  while (last - first >= 2 * B) {
+    if (!have_front) {
+      holes = mask64(first, p, true);
+      have_front = true;
+      filled = -1;
+    }
+    if (!have_back) {
+      keeps = mask64(last - B, p, false);
+      have_back = true;
+      moved = B;
+    }
+    while (holes != 0 && keeps != 0) {
+      filled = countr_zero(holes);
+      moved = highest_bit(keeps);
+      first[filled] = std::move(last[moved - B]);
+      holes &= holes - 1;
+      keeps &= ~(uint64_t(1) << moved);
+    }
+    if (holes == 0) {
+      first += B;
+      have_front = false;
+    }
+    if (keeps == 0) {
+      last -= B;
+      have_back = false;
+    }
+  }
+  // In a part-used front block, everything up to the last hole filled is now a "not p";
+  // in a part-used back block, everything from the last keeper moved onward is garbage.
+  if (have_front) {
+    first += filled + 1;
+  }
+  if (have_back) {
+    last -= B - moved;
+  }
+  return remove_if_scalar(first, last, p);
+}
+
+template<class BidirIt, class UnaryPredicate>
+BidirIt remove_if(BidirIt first, BidirIt last, UnaryPredicate& p, std::false_type) {
+  return remove_if_scalar(first, last, p);
+}
+
+template<class RandomIt, class UnaryPredicate>
+RandomIt remove_if(RandomIt first, RandomIt last, UnaryPredicate& p, std::true_type) {
+  return remove_if_blocks(first, last, p);
+}
+
+// The block scheme pays off when moves are cheap and the predicate is unpredictable.
+template<class It>
+using use_blocks = std::integral_constant<bool,
+  std::is_base_of<std::random_access_iterator_tag, typename std::iterator_traits<It>::iterator_category>::value &&
+  std::is_trivially_copyable<typename std::iterator_traits<It>::value_type>::value
+>;
+
+template<class Val>
+struct equal_to_value {
+  const Val *v_;
+  template<class T> bool operator()(const T& t) const { return bool(t == *v_); }
+};
+
+} // namespace unstable_remove_detail
+
+template<class BidirIt, class UnaryPredicate>
+#if __cplusplus >= 201703L
+[[nodiscard]]
+#endif
+BidirIt unstable_remove_if(BidirIt first, BidirIt last, UnaryPredicate p) {
+  return unstable_remove_detail::remove_if(first, last, p, unstable_remove_detail::use_blocks<BidirIt>());
+}
+
 template<class BidirIt, class Val>
 #if __cplusplus >= 201703L
 [[nodiscard]]
 #endif
 BidirIt unstable_remove(BidirIt first, BidirIt last, const Val& v) {
+  auto p = unstable_remove_detail::equal_to_value<Val>{std::addressof(v)};
+  return unstable_remove_detail::remove_if(first, last, p, unstable_remove_detail::use_blocks<BidirIt>());
+}
+
+#if SG14_EXECUTION_POLICIES
+// Removes from each chunk of the range in parallel, then moves the "not p" elements
+// that ended up past the final boundary into the gaps before it, also in parallel.
+template<class ExecutionPolicy, class RandomIt, class UnaryPredicate,
+         class = std::enable_if_t<std::is_execution_policy_v<std::decay_t<ExecutionPolicy>>>>
+[[nodiscard]] RandomIt unstable_remove_if(ExecutionPolicy&& policy, RandomIt first, RandomIt last, UnaryPredicate p) {
+  using D = typename std::iterator_traits<RandomIt>::difference_type;
+  const D chunk = 1 << 14;
+  D n = last - first;
+  if (n <= chunk) {
+    return sg14::unstable_remove_if(first, last, p);
+  }
+  struct piece { D begin, mid, end; };
+  std::vector<piece> pieces(size_t((n + chunk - 1) / chunk));
+  for (size_t i = 0; i < pieces.size(); ++i) {
+    pieces[i].begin = D(i) * chunk;
+    pieces[i].end = std::min(n, pieces[i].begin + chunk);
+  }
+  std::for_each(policy, pieces.begin(), pieces.end(), [&](piece& pc) {
+    pc.mid = sg14::unstable_remove_if(first + pc.begin, first + pc.end, p) - first;
+  });
+
+  D total = 0;
+  for (const piece& pc : pieces) {
+    total += pc.mid - pc.begin;
+  }
+  // Pair the gaps [mid, end) below total with the keepers [begin, mid) above it.
+  struct span_move { D dst, src, len; };
+  std::vector<span_move> moves;
+  size_t h = 0;
+  size_t k = pieces.size();
+  D hole = 0;
+  D hole_end = 0;
+  D keep = 0;
+  D keep_end = 0;
   while (true) {
-    // Find the first instance of "v"...
-    while (true) {
-      if (first == last) {
-        return first;
-      }
-      if (*first == v) {
-        break;
-      }
-      ++first;
+    while (hole == hole_end && h < pieces.size() && pieces[h].begin < total) {
+      hole = pieces[h].mid;
+      hole_end = std::min(pieces[h].end, total);
+      hole = std::min(hole, hole_end);
+      ++h;
     }
-    // ...and the last instance of "not v"...
-    while (true) {
-      --last;
-      if (first == last) {
-        return first;
-      }
-      if (!(*last == v)) {
-        break;
-      }
+    while (keep == keep_end && k > 0 && pieces[k - 1].mid > total) {
+      --k;
+      keep = std::max(pieces[k].begin, total);
+      keep_end = pieces[k].mid;
     }
-    // ...and move the latter over top of the former.
-    *first = std::move(*last);
-    ++first;
+    if (hole == hole_end || keep == keep_end) {
+      break;
+    }
+    D len = std::min(hole_end - hole, keep_end - keep);
+    moves.push_back(span_move{hole, keep_end - len, len});
+    hole += len;
+    keep_end -= len;
   }
+  std::for_each(policy, moves.begin(), moves.end(), [&](const span_move& m) {
+    std::move(first + m.src, first + m.src + m.len, first + m.dst);
+  });
+  return first + total;
 }
+#endif // SG14_EXECUTION_POLICIES
 
 } // namespace sg14
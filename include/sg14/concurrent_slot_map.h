@@ -0,0 +1,275 @@
+/*
+ * Boost Software License - Version 1.0 - August 17th, 2003
+ *
+ * Permission is hereby granted, free of charge, to any person or organization
+ * obtaining a copy of the software and accompanying documentation covered by
+ * this license (the "Software") to use, reproduce, display, distribute,
+ * execute, and transmit the Software, and to prepare derivative works of the
+ * Software, and to permit third-parties to whom the Software is furnished to
+ * do so, all subject to the following:
+ *
+ * The copyright notices in the Software and this entire statement, including
+ * the above license grant, this restriction and the following disclaimer,
+ * must be included in all copies of the Software, in whole or in part, and
+ * all derivative works of the Software, unless such copies or derivative
+ * works are solely in the form of machine-executable object code generated by
+ * a source language processor.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+ * SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+ * FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#pragma once
+
+// sg14::concurrent_slot_map<T> hands out the same kind of (index, generation)
+// keys as sg14::slot_map, but may be used from many threads at once.
+//
+// The slots are split into Shards shards, each with its own mutex and free list;
+// a thread always emplaces into "its" shard, so emplace() and erase() from
+// different threads contend only when one thread erases another's value.
+// Each shard's slots live in chunks that never move once allocated, so find()
+// takes no lock at all: it checks the slot's generation with an acquire load,
+// which also makes the value's construction visible to it.
+//
+// Unlike slot_map, the values aren't kept contiguous (that would mean moving
+// them under the feet of concurrent readers), so there is no iterator.
+// A pointer returned by find() is valid until the value is erased; the caller
+// must ensure that no thread erases a value while another is still using it.
+
+#include <stddef.h>
+#include <atomic>
+#include <mutex>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#ifndef SLOT_MAP_THROW_EXCEPTION
+#if defined(__cpp_exceptions) || defined(_CPPUNWIND)
+#include <stdexcept>
+#define SLOT_MAP_THROW_EXCEPTION(type, ...) throw type(__VA_ARGS__)
+#else
+#include <cassert>
+#include <stdlib.h>
+#define SLOT_MAP_THROW_EXCEPTION(type, ...) (assert(!#type), abort())
+#endif
+#endif
+
+namespace sg14 {
+
+namespace concurrent_slot_map_detail {
+
+constexpr size_t cache_line_size = 64;
+
+// Each thread gets a small number the first time it asks, and keeps it.
+inline size_t this_thread_ordinal() {
+    static std::atomic<size_t> next{0};
+    thread_local size_t mine = next.fetch_add(1, std::memory_order_relaxed);
+    return mine;
+}
+
+constexpr size_t floor_log2(size_t n) {
+    return (n <= 1) ? 0 : 1 + floor_log2(n / 2);
+}
+
+} // namespace concurrent_slot_map_detail
+
+template<class T, size_t Shards = 16>
+class concurrent_slot_map {
+    static_assert(Shards > 0 && (Shards & (Shards - 1)) == 0, "Shards must be a power of two");
+
+    static constexpr unsigned shard_bits = concurrent_slot_map_detail::floor_log2(Shards);
+    static constexpr unsigned first_chunk_bits = 6;
+    static constexpr unsigned max_chunks = 32;
+
+    struct slot {
+        std::atomic<unsigned> generation{0};  // odd while the slot holds a value
+        unsigned next_free = 0;  // guarded by the shard's mutex
+        alignas(T) unsigned char storage[sizeof(T)];
+
+        T *value() noexcept { return reinterpret_cast<T*>(storage); }
+    };
+
+    // Each shard starts on its own cache line, so that its mutex and the fields
+    // it guards (including the shard's share of size()) aren't shared with another's.
+    struct alignas(concurrent_slot_map_detail::cache_line_size) shard {
+        std::mutex mtx;
+        unsigned free_head = 0;
+        unsigned free_tail = 0;
+        unsigned free_count = 0;
+        unsigned high_water = 0;  // slots [0, high_water) have been handed out at least once
+        std::atomic<size_t> size{0};  // written under mtx, but read by size() without it
+        std::atomic<slot*> chunks[max_chunks] = {};
+    };
+
+public:
+    using key_type = std::pair<unsigned, unsigned>;
+    using mapped_type = T;
+    using key_index_type = unsigned;
+    using key_generation_type = unsigned;
+    using size_type = size_t;
+
+    concurrent_slot_map() = default;
+    concurrent_slot_map(const concurrent_slot_map&) = delete;
+    concurrent_slot_map& operator=(const concurrent_slot_map&) = delete;
+
+    ~concurrent_slot_map() {
+        for (shard& sh : shards_) {
+            for (unsigned i = 0; i < sh.high_water; ++i) {
+                slot& sl = slot_at(sh, i);
+                if (sl.generation.load(std::memory_order_relaxed) & 1) {
+                    sl.value()->~T();
+                }
+            }
+            for (auto& chunk : sh.chunks) {
+                delete[] chunk.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    // Thread-safe. Locks the calling thread's shard.
+    template<class... Args>
+    key_type emplace(Args&&... args) {
+        size_t s = concurrent_slot_map_detail::this_thread_ordinal() & (Shards - 1);
+        shard& sh = shards_[s];
+        std::lock_guard<std::mutex> lock(sh.mtx);
+        bool reuse = (sh.free_count != 0);
+        unsigned local = reuse ? sh.free_head : sh.high_water;
+        if (!reuse) {
+            if (local >= (~0u >> shard_bits)) {
+                SLOT_MAP_THROW_EXCEPTION(std::length_error, "concurrent_slot_map::emplace");
+            }
+            this->ensure_chunk(sh, local);
+        }
+        slot& sl = slot_at(sh, local);
+        ::new (static_cast<void*>(sl.value())) T(std::forward<Args>(args)...);
+        if (reuse) {
+            sh.free_head = sl.next_free;
+            sh.free_count -= 1;
+        } else {
+            sh.high_water += 1;
+        }
+        unsigned gen = sl.generation.load(std::memory_order_relaxed) + 1;
+        sl.generation.store(gen, std::memory_order_release);
+        sh.size.store(sh.size.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        return key_type{(local << shard_bits) | static_cast<unsigned>(s), gen};
+    }
+
+    key_type insert(const T& value) { return this->emplace(value); }
+    key_type insert(T&& value) { return this->emplace(std::move(value)); }
+
+    // Lock-free. Returns nullptr if the key has expired.
+    T *find(const key_type& key) noexcept {
+        slot *sl = this->slot_for(key);
+        return sl ? sl->value() : nullptr;
+    }
+    const T *find(const key_type& key) const noexcept {
+        slot *sl = const_cast<concurrent_slot_map*>(this)->slot_for(key);
+        return sl ? sl->value() : nullptr;
+    }
+    bool contains(const key_type& key) const noexcept { return this->find(key) != nullptr; }
+
+    // Thread-safe. Locks the key's shard.
+    size_type erase(const key_type& key) {
+        shard& sh = shards_[key.first & (Shards - 1)];
+        unsigned local = key.first >> shard_bits;
+        std::lock_guard<std::mutex> lock(sh.mtx);
+        if (local >= sh.high_water || !(key.second & 1)) {
+            return 0;
+        }
+        slot& sl = slot_at(sh, local);
+        if (sl.generation.load(std::memory_order_relaxed) != key.second) {
+            return 0;
+        }
+        // Expire the key before destroying the value, so that new finds fail.
+        sl.generation.store(key.second + 1, std::memory_order_release);
+        sl.value()->~T();
+        sh.size.store(sh.size.load(std::memory_order_relaxed) - 1, std::memory_order_relaxed);
+        if (key.second != ~0u) {
+            // Otherwise, retire the slot, rather than wrap around to generations we've already used.
+            if (sh.free_count == 0) {
+                sh.free_head = local;
+            } else {
+                slot_at(sh, sh.free_tail).next_free = local;
+            }
+            sh.free_tail = local;
+            sh.free_count += 1;
+        }
+        return 1;
+    }
+
+    // The number of values, summed over the shards; under concurrent emplaces and
+    // erases, it may not match the map's contents at any single moment.
+    size_type size() const noexcept {
+        size_type n = 0;
+        for (const shard& sh : shards_) {
+            n += sh.size.load(std::memory_order_relaxed);
+        }
+        return n;
+    }
+    bool empty() const noexcept { return this->size() == 0; }
+
+    // Calls f(key, value) for every value, locking one shard at a time.
+    // f must not emplace or erase.
+    template<class F>
+    void for_each(F f) {
+        for (size_t s = 0; s < Shards; ++s) {
+            shard& sh = shards_[s];
+            std::lock_guard<std::mutex> lock(sh.mtx);
+            for (unsigned i = 0; i < sh.high_water; ++i) {
+                slot& sl = slot_at(sh, i);
+                unsigned gen = sl.generation.load(std::memory_order_relaxed);
+                if (gen & 1) {
+                    f(key_type{(i << shard_bits) | static_cast<unsigned>(s), gen}, *sl.value());
+                }
+            }
+        }
+    }
+
+private:
+    // Chunk c holds the 2^(first_chunk_bits + c) slots starting at local index
+    // 2^first_chunk_bits * (2^c - 1), so a shard grows geometrically without
+    // ever moving a slot.
+    static unsigned chunk_of(unsigned local, unsigned& offset) noexcept {
+        size_t q = (size_t(local) >> first_chunk_bits) + 1;
+        unsigned c = static_cast<unsigned>(concurrent_slot_map_detail::floor_log2(q));
+        offset = static_cast<unsigned>(local - (((size_t(1) << c) - 1) << first_chunk_bits));
+        return c;
+    }
+
+    static slot& slot_at(shard& sh, unsigned local) noexcept {
+        unsigned offset;
+        unsigned c = chunk_of(local, offset);
+        return sh.chunks[c].load(std::memory_order_relaxed)[offset];
+    }
+
+    static void ensure_chunk(shard& sh, unsigned local) {
+        unsigned offset;
+        unsigned c = chunk_of(local, offset);
+        if (sh.chunks[c].load(std::memory_order_relaxed) == nullptr) {
+            sh.chunks[c].store(new slot[size_t(1) << (first_chunk_bits + c)], std::memory_order_release);
+        }
+    }
+
+    slot *slot_for(const key_type& key) noexcept {
+        if (!(key.second & 1)) {
+            return nullptr;
+        }
+        shard& sh = shards_[key.first & (Shards - 1)];
+        unsigned offset;
+        unsigned c = chunk_of(key.first >> shard_bits, offset);
+        slot *chunk = sh.chunks[c].load(std::memory_order_acquire);
+        if (chunk == nullptr || chunk[offset].generation.load(std::memory_order_acquire) != key.second) {
+            return nullptr;
+        }
+        return &chunk[offset];
+    }
+
+    shard shards_[Shards];
+};
+
+} // namespace sg14
@@ -0,0 +1,221 @@
+/*
+ * Boost Software License - Version 1.0 - August 17th, 2003
+ *
+ * Permission is hereby granted, free of charge, to any person or organization
+ * obtaining a copy of the software and accompanying documentation covered by
+ * this license (the "Software") to use, reproduce, display, distribute,
+ * execute, and transmit the Software, and to prepare derivative works of the
+ * Software, and to permit third-parties to whom the Software is furnished to
+ * do so, all subject to the following:
+ *
+ * The copyright notices in the Software and this entire statement, including
+ * the above license grant, this restriction and the following disclaimer,
+ * must be included in all copies of the Software, in whole or in part, and
+ * all derivative works of the Software, unless such copies or derivative
+ * works are solely in the form of machine-executable object code generated by
+ * a source language processor.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+ * SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+ * FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#pragma once
+
+// sg14::flat_index<FlatContainer> is a read-only lookup accelerator for a
+// sg14::flat_set or sg14::flat_map. It keeps a shadow copy of the container's
+// keys in Eytzinger (BFS) order, padded out to a perfect binary tree, so that a search touches memory in a
+// prefetch-friendly, mostly-sequential pattern instead of bouncing across
+// the whole sorted array. The index refers to the container; it doesn't own it.
+//
+// The index doesn't observe mutations of the container. Call invalidate()
+// after mutating it, and the shadow copy will be rebuilt on the next lookup;
+// or call rebuild() to rebuild it eagerly. Lookups on a stale index are
+// const but not thread-safe; if you share an index between threads,
+// rebuild() it before publishing it.
+
+#include <stddef.h>
+#include <functional>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace sg14 {
+
+namespace flat_index_detail {
+    template<int I> struct priority_tag : priority_tag<I-1> {};
+    template<> struct priority_tag<0> {};
+
+    // A flat_map exposes its keys directly; a flat_set's elements are its keys.
+    template<class FC>
+    auto key_range_begin(const FC& fc, priority_tag<1>) -> decltype(fc.keys().begin()) {
+        return fc.keys().begin();
+    }
+    template<class FC>
+    auto key_range_begin(const FC& fc, priority_tag<0>) -> decltype(fc.begin()) {
+        return fc.begin();
+    }
+
+    inline void prefetch(const void *p) {
+#if defined(__GNUC__) || defined(__clang__)
+        __builtin_prefetch(p);
+#else
+        (void)p;
+#endif
+    }
+} // namespace flat_index_detail
+
+template<class FlatContainer>
+class flat_index {
+public:
+    using container_type = FlatContainer;
+    using key_type = typename FlatContainer::key_type;
+    using key_compare = typename FlatContainer::key_compare;
+    using size_type = typename FlatContainer::size_type;
+    using const_iterator = typename FlatContainer::const_iterator;
+
+    explicit flat_index(const FlatContainer& fc) : fc_(&fc), compare_(fc.key_comp()) {
+        this->rebuild();
+    }
+
+    const FlatContainer& container() const noexcept { return *fc_; }
+    bool stale() const noexcept { return stale_; }
+
+    // O(1). The next lookup will rebuild the shadow copy.
+    void invalidate() noexcept { stale_ = true; }
+
+    // O(n) time and space.
+    void rebuild() const {
+        n_ = fc_->size();
+        height_ = 0;
+        while ((size_type(1) << height_) <= n_) {
+            height_ += 1;
+        }
+        // The tree is perfect, with 2^h - 1 in-order slots. Slot i holds the i'th key;
+        // slots past the end repeat the last key, which preserves the partitioning
+        // of every predicate we search by and gives every search the same trip count.
+        size_type slots = (size_type(1) << height_) - 1;
+        auto kbegin = flat_index_detail::key_range_begin(*fc_, flat_index_detail::priority_tag<1>());
+        tree_.clear();
+        tree_.reserve(slots);
+        for (size_type depth = 0; depth < height_; ++depth) {
+            size_type first = size_type(1) << depth;
+            for (size_type k = first; k < 2 * first; ++k) {
+                size_type i = ((2 * (k - first) + 1) << (height_ - 1 - depth)) - 1;
+                tree_.push_back(*(kbegin + (i < n_ ? i : n_ - 1)));
+            }
+        }
+        stale_ = false;
+    }
+
+    const_iterator lower_bound(const key_type& k) const {
+        return begin_plus(this->search([&](const key_type& elt) { return bool(compare_(elt, k)); }));
+    }
+
+    template<class K,
+             class Compare_ = key_compare, class = typename Compare_::is_transparent>
+    const_iterator lower_bound(const K& x) const {
+        return begin_plus(this->search([&](const key_type& elt) { return bool(compare_(elt, x)); }));
+    }
+
+    const_iterator upper_bound(const key_type& k) const {
+        return begin_plus(this->search([&](const key_type& elt) { return !bool(compare_(k, elt)); }));
+    }
+
+    template<class K,
+             class Compare_ = key_compare, class = typename Compare_::is_transparent>
+    const_iterator upper_bound(const K& x) const {
+        return begin_plus(this->search([&](const key_type& elt) { return !bool(compare_(x, elt)); }));
+    }
+
+    std::pair<const_iterator, const_iterator> equal_range(const key_type& k) const {
+        return { this->lower_bound(k), this->upper_bound(k) };
+    }
+
+    template<class K,
+             class Compare_ = key_compare, class = typename Compare_::is_transparent>
+    std::pair<const_iterator, const_iterator> equal_range(const K& x) const {
+        return { this->lower_bound(x), this->upper_bound(x) };
+    }
+
+    const_iterator find(const key_type& k) const {
+        size_type i = this->search([&](const key_type& elt) { return bool(compare_(elt, k)); });
+        return this->found(i, k) ? begin_plus(i) : fc_->end();
+    }
+
+    template<class K,
+             class Compare_ = key_compare, class = typename Compare_::is_transparent>
+    const_iterator find(const K& x) const {
+        size_type i = this->search([&](const key_type& elt) { return bool(compare_(elt, x)); });
+        return this->found(i, x) ? begin_plus(i) : fc_->end();
+    }
+
+    bool contains(const key_type& k) const {
+        return this->found(this->search([&](const key_type& elt) { return bool(compare_(elt, k)); }), k);
+    }
+
+    template<class K,
+             class Compare_ = key_compare, class = typename Compare_::is_transparent>
+    bool contains(const K& x) const {
+        return this->found(this->search([&](const key_type& elt) { return bool(compare_(elt, x)); }), x);
+    }
+
+    size_type count(const key_type& k) const {
+        return this->contains(k) ? 1 : 0;
+    }
+
+    template<class K,
+             class Compare_ = key_compare, class = typename Compare_::is_transparent>
+    size_type count(const K& x) const {
+        return this->contains(x) ? 1 : 0;
+    }
+
+private:
+    // Returns the index of the first key for which pred is false, as if by
+    // std::partition_point over the sorted keys. Each step down the tree is a
+    // conditional move, not a branch; and the descendants several levels down
+    // are adjacent in memory, so we prefetch them a cache line at a time.
+    // After h steps, the low h bits of k spell out the in-order slot we landed on.
+    template<class Pred>
+    size_type search(Pred pred) const {
+        if (stale_) {
+            this->rebuild();
+        }
+        constexpr size_type line = (sizeof(key_type) >= 64) ? 1 : (64 / sizeof(key_type));
+        constexpr size_type lgstride = (line >= 16) ? 4 : (line >= 8) ? 3 : (line >= 4) ? 2 : (line >= 2) ? 1 : 0;
+        const key_type *tree = tree_.data();
+        size_type k = 1;
+        for (size_type depth = 0; depth < height_; ++depth) {
+            if (depth + lgstride < height_) {
+                flat_index_detail::prefetch(tree + ((k << lgstride) - 1));
+            }
+            k = 2 * k + (bool(pred(tree[k - 1])) ? 1 : 0);
+        }
+        size_type i = k - (size_type(1) << height_);
+        return (i < n_) ? i : n_;
+    }
+
+    template<class K>
+    bool found(size_type i, const K& x) const {
+        return (i != n_) && !bool(compare_(x, *(flat_index_detail::key_range_begin(*fc_, flat_index_detail::priority_tag<1>()) + i)));
+    }
+
+    const_iterator begin_plus(size_type i) const {
+        using Diff = typename std::iterator_traits<const_iterator>::difference_type;
+        return fc_->begin() + static_cast<Diff>(i);
+    }
+
+    const FlatContainer *fc_;
+    key_compare compare_;
+    mutable std::vector<key_type> tree_;
+    mutable size_type n_ = 0;
+    mutable size_type height_ = 0;
+    mutable bool stale_ = true;
+};
+
+} // namespace sg14
@@ -30,10 +30,14 @@
 // with some modifications as specified in P2767.
 
 #include <stddef.h>
+#include <stdint.h>
+#include <string.h>
 #include <algorithm>
 #include <functional>
 #include <initializer_list>
 #include <iterator>
+#include <memory>
+#include <type_traits>
 #include <utility>
 #include <vector>
 
@@ -43,6 +47,14 @@
 #include <ranges>
 #endif // __cplusplus >= 202002L
 
+#ifndef SG14_EXECUTION_POLICIES
+ #define SG14_EXECUTION_POLICIES 0  // opt in to the std::execution overloads; this may require linking TBB
+#endif
+
+#if SG14_EXECUTION_POLICIES
+#include <execution>
+#endif
+
 #ifndef SG14_FLAT_MAP_THROW
 #include <stdexcept>
 #define SG14_FLAT_MAP_THROW(x) throw (x)
@@ -188,6 +200,367 @@ namespace flatmap_detail {
         return dfirst;
     }
 
+    // Equivalent to std::partition_point on a random-access range, but the loop body
+    // is a conditional move rather than a conditional branch, so it doesn't suffer
+    // from misprediction on large tables. The trip count depends only on the size.
+    template<class It, class Pred>
+    It branchless_partition_point(It first, It last, Pred pred) {
+        auto n = last - first;
+        if (n == 0) {
+            return first;
+        }
+        while (n > 1) {
+            auto half = n / 2;
+            first = bool(pred(first[half])) ? first + half : first;
+            n -= half;
+        }
+        return bool(pred(*first)) ? first + 1 : first;
+    }
+
+    // Arithmetic keys in contiguous storage, ordered by std::less or std::greater,
+    // are cheap enough to compare that it's faster to scan the last vector register's
+    // worth of a search linearly, with a loop the compiler can vectorize, than to
+    // keep bisecting. Anything else uses the plain branchless bisection.
+    template<class C, class = void>
+    struct has_contiguous_data : std::false_type {};
+    template<class C>
+    struct has_contiguous_data<C, void_t<decltype(std::declval<const C&>().data())>> : std::is_same<
+        decltype(std::declval<const C&>().data()), const typename C::value_type*
+    > {};
+
+    template<class Key, class Compare, class Container>
+    using is_vectorizable_search = std::integral_constant<bool,
+        std::is_arithmetic<Key>::value && !std::is_same<Key, bool>::value &&
+        (std::is_same<Compare, std::less<Key>>::value || std::is_same<Compare, std::less<>>::value ||
+         std::is_same<Compare, std::greater<Key>>::value || std::is_same<Compare, std::greater<>>::value) &&
+        has_contiguous_data<Container>::value
+    >;
+
+    template<class Container, class Pred>
+    auto key_partition_point(Container& c, Pred pred, std::false_type) -> decltype(c.begin()) {
+        return branchless_partition_point(c.begin(), c.end(), pred);
+    }
+
+    template<class Container, class Pred>
+    auto key_partition_point(Container& c, Pred pred, std::true_type) -> decltype(c.begin()) {
+        using T = typename Container::value_type;
+        constexpr size_t lanes = (sizeof(T) < 32) ? (32 / sizeof(T)) : 1;
+        const T *data = c.data();
+        const T *first = data;
+        size_t n = c.size();
+        size_t count = 0;
+        if (n < lanes) {
+            for (size_t i = 0; i < n; ++i) {
+                count += bool(pred(first[i])) ? 1 : 0;
+            }
+        } else {
+            while (n > lanes) {
+                size_t half = n / 2;
+                first = bool(pred(first[half])) ? first + half : first;
+                n -= half;
+            }
+            // The answer is in [first, first+n]. Slide a whole window over it,
+            // staying in bounds, so that the scan has a constant trip count.
+            if (first + lanes > data + c.size()) {
+                first = data + c.size() - lanes;
+            }
+            for (size_t i = 0; i < lanes; ++i) {
+                count += bool(pred(first[i])) ? 1 : 0;
+            }
+        }
+        return c.begin() + ((first - data) + count);
+    }
+
+    template<class Compare, class Container, class Pred>
+    auto key_partition_point(Container& c, Pred pred) -> decltype(c.begin()) {
+        using Key = typename std::remove_const<typename Container::value_type>::type;
+        return key_partition_point(c, pred, is_vectorizable_search<Key, Compare, Container>());
+    }
+
+    // For those same keys, equivalence is equality; on small containers a
+    // straight equality scan beats any search.
+    template<class Container, class Key>
+    bool small_contains(const Container& c, const Key& k) {
+        const auto *data = c.data();
+        size_t n = c.size();
+        bool found = false;
+        for (size_t i = 0; i < n; ++i) {
+            found |= (data[i] == k);
+        }
+        return found;
+    }
+
+    // Integer keys in contiguous storage, ordered by std::less or std::greater, can be
+    // sorted by an LSD radix sort in linear time; past a couple of thousand elements that beats
+    // any comparison sort.
+    template<class Key, class Compare, class Container>
+    using is_radix_sortable = std::integral_constant<bool,
+        std::is_integral<Key>::value && !std::is_same<Key, bool>::value &&
+        is_vectorizable_search<Key, Compare, Container>::value
+    >;
+
+    constexpr size_t radix_sort_threshold = 2048;
+
+    template<class Compare> struct is_descending : std::false_type {};
+    template<class T> struct is_descending<std::greater<T>> : std::true_type {};
+
+    // Maps k to an unsigned integer whose natural order is the key order.
+    template<class T>
+    std::make_unsigned_t<T> radix_bits(T k, bool descending) {
+        using U = std::make_unsigned_t<T>;
+        U u = static_cast<U>(k);
+        if (std::is_signed<T>::value) {
+            u = static_cast<U>(u ^ (U(1) << (sizeof(U) * 8 - 1)));
+        }
+        return descending ? static_cast<U>(~u) : u;
+    }
+
+    template<class T>
+    T radix_unbits(std::make_unsigned_t<T> u, bool descending) {
+        using U = std::make_unsigned_t<T>;
+        u = descending ? static_cast<U>(~u) : u;
+        if (std::is_signed<T>::value) {
+            u = static_cast<U>(u ^ (U(1) << (sizeof(U) * 8 - 1)));
+        }
+        return static_cast<T>(u);
+    }
+
+    // A stable LSD radix sort of [first, first+n) by bits(elt), a byte per pass,
+    // using scratch[0, n) as the ping-pong buffer. All the histograms come from
+    // one read of the input, and a pass on which every element has the same digit
+    // is skipped, so a narrow range of keys costs fewer passes.
+    template<class T, class Bits>
+    void radix_sort(T *first, T *scratch, size_t n, Bits bits) {
+        using U = decltype(bits(*first));
+        constexpr size_t digits = sizeof(U);
+        if (n < 2) {
+            return;
+        }
+        std::vector<size_t> counts(digits * 256);
+        for (size_t i = 0; i < n; ++i) {
+            U u = bits(first[i]);
+            for (size_t d = 0; d < digits; ++d) {
+                counts[d * 256 + ((u >> (d * 8)) & 0xFF)] += 1;
+            }
+        }
+        T *src = first;
+        T *dst = scratch;
+        for (size_t d = 0; d < digits; ++d) {
+            size_t *c = counts.data() + d * 256;
+            if (c[(bits(src[0]) >> (d * 8)) & 0xFF] == n) {
+                continue;
+            }
+            size_t sum = 0;
+            for (size_t b = 0; b < 256; ++b) {
+                size_t here = c[b];
+                c[b] = sum;
+                sum += here;
+            }
+            for (size_t i = 0; i < n; ++i) {
+                dst[c[(bits(src[i]) >> (d * 8)) & 0xFF]++] = src[i];
+            }
+            std::swap(src, dst);
+        }
+        if (src != first) {
+            std::copy(src, src + n, first);
+        }
+    }
+
+    // Stably sorts keys[0, n) in place, and returns the permutation that did it
+    // so that the mapped values can be gathered to match.
+    template<class Index, class T>
+    std::vector<Index> radix_sort_keys(T *keys, size_t n, bool descending) {
+        using U = std::make_unsigned_t<T>;
+        struct tagged { U bits; Index index; };
+        std::vector<tagged> a(n);
+        std::vector<tagged> scratch(n);
+        for (size_t i = 0; i < n; ++i) {
+            a[i] = tagged{ flatmap_detail::radix_bits(keys[i], descending), Index(i) };
+        }
+        flatmap_detail::radix_sort(a.data(), scratch.data(), n, [](const tagged& e) { return e.bits; });
+        std::vector<Index> order(n);
+        for (size_t i = 0; i < n; ++i) {
+            keys[i] = flatmap_detail::radix_unbits<T>(a[i].bits, descending);
+            order[i] = a[i].index;
+        }
+        return order;
+    }
+
+    // Moves element order[t] to position t, for each t in [0, n), by way of a
+    // scratch buffer. Unlike following the cycles of the permutation in place,
+    // the loads are independent of one another, which matters once the range
+    // no longer fits in cache.
+    template<class Index, class It>
+    void gather(const Index *order, size_t n, It first) {
+        using T = typename std::iterator_traits<It>::value_type;
+        std::vector<T> scratch;
+        scratch.reserve(n);
+        for (size_t t = 0; t < n; ++t) {
+            scratch.emplace_back(std::move(first[order[t]]));
+        }
+        std::move(scratch.begin(), scratch.end(), first);
+    }
+
+    // A hint only; it may be a no-op.
+    template<class It>
+    auto prefetch_element(It it, priority_tag<1>) -> decltype(void(std::addressof(*it))) {
+#if defined(__GNUC__) || defined(__clang__)
+        __builtin_prefetch(std::addressof(*it));
+#else
+        (void)it;
+#endif
+    }
+    template<class It>
+    void prefetch_element(It, priority_tag<0>) {}
+
+    // Calls f(key, i) for each key in [first, last), in order, where i is the
+    // index of that key's lower bound among the n sorted keys starting at kbegin.
+    // Sorted input that is dense relative to the keys is answered by galloping
+    // forward from the previous result. Otherwise, the searches proceed in lockstep
+    // groups, so that the group's cache misses overlap instead of being paid one
+    // after another.
+    template<class KeyIt, class InputIt, class Compare, class F>
+    void for_each_lower_bound(KeyIt kbegin, size_t n, InputIt first, InputIt last, const Compare& compare, F f, std::input_iterator_tag) {
+        for (; first != last; ++first) {
+            auto&& k = *first;
+            auto kit = branchless_partition_point(kbegin, kbegin + n, [&](const auto& elt) {
+                return bool(compare(elt, k));
+            });
+            f(k, size_t(kit - kbegin));
+        }
+    }
+
+    template<class KeyIt, class FwdIt, class Compare, class F>
+    void for_each_lower_bound(KeyIt kbegin, size_t n, FwdIt first, FwdIt last, const Compare& compare, F f, std::forward_iterator_tag) {
+        size_t m = size_t(std::distance(first, last));
+        if (n / 64 <= m && std::is_sorted(first, last, compare)) {
+            size_t prev = 0;
+            for (; first != last; ++first) {
+                auto&& k = *first;
+                auto pred = [&](const auto& elt) { return bool(compare(elt, k)); };
+                size_t lo = prev;
+                if (lo != n && pred(kbegin[lo])) {
+                    size_t step = 1;
+                    while (lo + step < n && pred(kbegin[lo + step])) {
+                        lo += step;
+                        step *= 2;
+                    }
+                    size_t hi = (lo + step < n) ? (lo + step) : n;
+                    lo = size_t(branchless_partition_point(kbegin + (lo + 1), kbegin + hi, pred) - kbegin);
+                }
+                f(k, lo);
+                prev = lo;
+            }
+            return;
+        }
+        constexpr size_t group = 16;
+        FwdIt its[group];
+        size_t base[group];
+        while (first != last) {
+            size_t g = 0;
+            for (; g < group && first != last; ++g, ++first) {
+                its[g] = first;
+                base[g] = 0;
+            }
+            size_t len = n;
+            while (len > 1) {
+                size_t half = len / 2;
+                for (size_t j = 0; j < g; ++j) {
+                    base[j] = bool(compare(kbegin[base[j] + half], *its[j])) ? base[j] + half : base[j];
+                }
+                len -= half;
+                for (size_t j = 0; j < g; ++j) {
+                    prefetch_element(kbegin + (base[j] + len / 2), priority_tag<1>());
+                }
+            }
+            for (size_t j = 0; j < g; ++j) {
+                size_t i = (n != 0 && bool(compare(kbegin[base[j]], *its[j]))) ? base[j] + 1 : base[j];
+                f(*its[j], i);
+            }
+        }
+    }
+
+#if SG14_EXECUTION_POLICIES
+    // Splits [0, n) into chunks big enough to amortize the scheduling,
+    // and calls f(lo, hi) on each chunk under the given policy.
+    template<class ExecutionPolicy, class F>
+    void for_each_chunk(ExecutionPolicy&& policy, size_t n, F f) {
+        constexpr size_t chunk = 4096;
+        std::vector<size_t> starts;
+        for (size_t lo = 0; lo < n; lo += chunk) {
+            starts.push_back(lo);
+        }
+        std::for_each(static_cast<ExecutionPolicy&&>(policy), starts.begin(), starts.end(), [&](size_t lo) {
+            f(lo, (n - lo < chunk) ? n : lo + chunk);
+        });
+    }
+#endif // SG14_EXECUTION_POLICIES
+
+    template<class C>
+    auto spare_capacity(const C& c, priority_tag<1>) -> decltype(size_t(c.capacity())) {
+        return size_t(c.capacity() - c.size());
+    }
+    template<class C>
+    size_t spare_capacity(const C&, priority_tag<0>) {
+        return size_t(-1);  // e.g. std::deque, which can grow without relocating anything
+    }
+
+    template<class C>
+    auto reserve_if_possible(C& c, size_t n, priority_tag<1>) -> decltype(void(c.reserve(n))) {
+        c.reserve(n);
+    }
+    template<class C>
+    void reserve_if_possible(C&, size_t, priority_tag<0>) {}
+
+    template<class C>
+    void swap_by_moving(C& a, C& b) {
+        C temp = static_cast<C&&>(a);
+        a = static_cast<C&&>(b);
+        b = static_cast<C&&>(temp);
+    }
+
+    // The zipped equivalent of flat_set's merge_disjoint: given sorted keys ak and
+    // bk with no keys in common, merges (bk, bv) into (ak, av).
+    template<class KeyContainer, class MappedContainer, class Compare>
+    void merge_disjoint(KeyContainer& ak, MappedContainer& av, KeyContainer& bk, MappedContainer& bv, const Compare& compare) {
+        size_t n = ak.size();
+        size_t m = bk.size();
+        size_t i = n;
+        size_t j = m;
+        for (size_t t = 0; t < m; ++t) {
+            if (i != 0 && (j == 0 || bool(compare(bk[j-1], ak[i-1])))) {
+                --i;
+            } else {
+                --j;
+            }
+        }
+        reserve_if_possible(ak, n + m, priority_tag<1>());
+        reserve_if_possible(av, n + m, priority_tag<1>());
+        for (size_t ia = i, ib = j; ia != n || ib != m; ) {
+            if (ib == m || (ia != n && bool(compare(ak[ia], bk[ib])))) {
+                ak.emplace_back(std::move(ak[ia]));
+                av.emplace_back(std::move(av[ia]));
+                ++ia;
+            } else {
+                ak.emplace_back(std::move(bk[ib]));
+                av.emplace_back(std::move(bv[ib]));
+                ++ib;
+            }
+        }
+        for (size_t d = n; j != 0; ) {
+            --d;
+            if (i != 0 && bool(compare(bk[j-1], ak[i-1]))) {
+                --i;
+                ak[d] = std::move(ak[i]);
+                av[d] = std::move(av[i]);
+            } else {
+                --j;
+                ak[d] = std::move(bk[j]);
+                av[d] = std::move(bv[j]);
+            }
+        }
+    }
+
     template<class FS>
     struct InvariantRestoringGuard {
         FS *self_;
@@ -517,6 +890,17 @@ public:
     flat_map(sorted_unique_t s, std::initializer_list<value_type> il, const Alloc& a)
         : flat_map(s, il.begin(), il.end(), Compare(), a) {}
 
+#if SG14_EXECUTION_POLICIES
+    // Sorts and dedupes the keys, and the values along with them, under the given policy.
+    template<class ExecutionPolicy,
+             class = std::enable_if_t<std::is_execution_policy_v<std::decay_t<ExecutionPolicy>>>>
+    flat_map(ExecutionPolicy&& policy, KeyContainer keys, MappedContainer values, const Compare& comp = Compare())
+        : compare_(comp)
+    {
+        this->replace(static_cast<ExecutionPolicy&&>(policy), static_cast<KeyContainer&&>(keys), static_cast<MappedContainer&&>(values));
+    }
+#endif // SG14_EXECUTION_POLICIES
+
 // ========================================================== OTHER MEMBERS
 
     flat_map& operator=(std::initializer_list<value_type> il) {
@@ -625,30 +1009,29 @@ public:
     template<class InputIterator,
              class = typename std::enable_if<flatmap_detail::qualifies_as_input_iterator<InputIterator>::value>::type>
     void insert(InputIterator first, InputIterator last) {
-        // TODO: if we're inserting lots of elements, stick them at the end and then sort
-        while (first != last) {
-            this->insert(*first);
-            ++first;
+        flatmap_detail::InvariantRestoringGuard<flat_map> guard(this);
+        size_type oldsize = keys_.size();
+        for (; first != last; ++first) {
+            std::pair<Key, Mapped> t(*first);
+            keys_.emplace_back(static_cast<Key&&>(t.first));
+            values_.emplace_back(static_cast<Mapped&&>(t.second));
         }
+        this->merge_appended_impl(oldsize, false);
+        guard.complete();
     }
 
     template<class InputIterator,
              class = typename std::enable_if<flatmap_detail::qualifies_as_input_iterator<InputIterator>::value>::type>
     void insert(sorted_unique_t, InputIterator first, InputIterator last) {
-        // TODO: if InputIterator is bidirectional, this loop should (go backward??)
-        // TODO: if we're inserting lots of elements, stick them at the end and then sort
-        auto it = begin();
-        while (first != last) {
+        flatmap_detail::InvariantRestoringGuard<flat_map> guard(this);
+        size_type oldsize = keys_.size();
+        for (; first != last; ++first) {
             std::pair<Key, Mapped> t(*first);
-            it = std::partition_point(it, this->end(), [&](const auto& elt) {
-                return bool(compare_(elt.first, t.first));
-            });
-            if (it == this->end() || bool(compare_(t.first, it->first))) {
-                it = this->emplace_hint(it, std::move(t));
-            }
-            ++it;
-            ++first;
+            keys_.emplace_back(static_cast<Key&&>(t.first));
+            values_.emplace_back(static_cast<Mapped&&>(t.second));
         }
+        this->merge_appended_impl(oldsize, true);
+        guard.complete();
     }
 
     void insert(std::initializer_list<value_type> il) {
@@ -669,17 +1052,7 @@ public:
             keys_.emplace_back(std::move(e.first));
             values_.emplace_back(std::move(e.second));
         }
-        if (keys_.size() != oldsize) {
-            auto begin = flatmap_detail::make_iterator(keys_.begin(), values_.begin());
-            auto mid = begin + oldsize;
-            auto end = flatmap_detail::make_iterator(keys_.end(), values_.end());
-            std::ranges::sort(mid, end, value_comp());
-            std::ranges::inplace_merge(begin, mid, end, value_comp());
-            auto kit = flatmap_detail::unique_helper(keys_.begin(), keys_.end(), values_.begin(), compare_);
-            auto vit = values_.begin() + (kit - keys_.begin());
-            keys_.erase(kit, keys_.end());
-            values_.erase(vit, values_.end());
-        }
+        this->merge_appended_impl(oldsize, false);
         guard.complete();
     }
 
@@ -692,16 +1065,7 @@ public:
             keys_.emplace_back(std::move(e.first));
             values_.emplace_back(std::move(e.second));
         }
-        if (keys_.size() != oldsize) {
-            auto begin = flatmap_detail::make_iterator(keys_.begin(), values_.begin());
-            auto mid = begin + oldsize;
-            auto end = flatmap_detail::make_iterator(keys_.end(), values_.end());
-            std::ranges::inplace_merge(begin, mid, end, compare_);
-            auto kit = flatmap_detail::unique_helper(keys_.begin(), keys_.end(), values_.begin(), compare_);
-            auto vit = values_.begin() + (kit - keys_.begin());
-            keys_.erase(kit, keys_.end());
-            values_.erase(vit, values_.end());
-        }
+        this->merge_appended_impl(oldsize, true);
         guard.complete();
     }
 #endif
@@ -731,6 +1095,18 @@ public:
         guard.complete();
     }
 
+#if SG14_EXECUTION_POLICIES
+    template<class ExecutionPolicy,
+             class = std::enable_if_t<std::is_execution_policy_v<std::decay_t<ExecutionPolicy>>>>
+    void replace(ExecutionPolicy&& policy, KeyContainer keys, MappedContainer values) {
+        flatmap_detail::InvariantRestoringGuard<flat_map> guard(this);
+        keys_ = static_cast<KeyContainer&&>(keys);
+        values_ = static_cast<MappedContainer&&>(values);
+        this->sort_and_unique_impl(static_cast<ExecutionPolicy&&>(policy));
+        guard.complete();
+    }
+#endif // SG14_EXECUTION_POLICIES
+
     template<class... Args>
     std::pair<iterator, bool> try_emplace(const Key& k, Args&&... args) {
         auto kit = std::lower_bound(keys_.begin(), keys_.end(), k, std::ref(compare_));
@@ -817,6 +1193,72 @@ public:
         return result.first;
     }
 
+    // Inserts each element of source whose key isn't already present, and leaves source empty.
+    // Linear time. If only source's containers have enough spare capacity for the result,
+    // the result is built in source's storage instead of reallocating ours.
+    void merge(flat_map&& source) {
+        flatmap_detail::InvariantRestoringGuard<flat_map> guard(this);
+        flatmap_detail::InvariantRestoringGuard<flat_map> sguard(&source);
+        auto& bk = source.keys_;
+        auto& bv = source.values_;
+        size_type i = 0;
+        size_type w = 0;
+        for (size_type r = 0; r != bk.size(); ++r) {
+            while (i != keys_.size() && bool(compare_(keys_[i], bk[r]))) {
+                ++i;
+            }
+            if (i != keys_.size() && !bool(compare_(bk[r], keys_[i]))) {
+                continue;  // already present
+            }
+            if (w != r) {
+                bk[w] = std::move(bk[r]);
+                bv[w] = std::move(bv[r]);
+            }
+            ++w;
+        }
+        bk.erase(bk.begin() + w, bk.end());
+        bv.erase(bv.begin() + w, bv.end());
+        auto p1 = flatmap_detail::priority_tag<1>();
+        if ((flatmap_detail::spare_capacity(keys_, p1) < bk.size() || flatmap_detail::spare_capacity(values_, p1) < bk.size()) &&
+            flatmap_detail::spare_capacity(bk, p1) >= keys_.size() && flatmap_detail::spare_capacity(bv, p1) >= keys_.size()) {
+            flatmap_detail::swap_by_moving(keys_, bk);
+            flatmap_detail::swap_by_moving(values_, bv);
+        }
+        flatmap_detail::merge_disjoint(keys_, values_, bk, bv, compare_);
+        source.clear();
+        sguard.complete();
+        guard.complete();
+    }
+
+    // Erases each element whose key is equivalent to some key in [first, last), which must
+    // be sorted with respect to key_comp(). Linear time; a single pass over each sequence.
+    template<class InputIterator>
+    void subtract(sorted_unique_t, InputIterator first, InputIterator last) {
+        flatmap_detail::InvariantRestoringGuard<flat_map> guard(this);
+        size_type w = 0;
+        for (size_type r = 0; r != keys_.size(); ++r) {
+            while (first != last && bool(compare_(*first, keys_[r]))) {
+                ++first;
+            }
+            if (first != last && !bool(compare_(keys_[r], *first))) {
+                continue;  // erase this element
+            }
+            if (w != r) {
+                keys_[w] = std::move(keys_[r]);
+                values_[w] = std::move(values_[r]);
+            }
+            ++w;
+        }
+        keys_.erase(keys_.begin() + w, keys_.end());
+        values_.erase(values_.begin() + w, values_.end());
+        guard.complete();
+    }
+
+    // Erases each element whose key is present in other, regardless of its mapped value.
+    void subtract(const flat_map& other) {
+        this->subtract(sorted_unique, other.keys_.begin(), other.keys_.end());
+    }
+
     iterator erase(iterator position) {
         auto kit = position.private_impl_getkey();
         auto vit = position.private_impl_getmapped();
@@ -942,7 +1384,7 @@ public:
     }
 
     bool contains(const Key& k) const {
-        return this->find(k) != this->end();
+        return this->contains_impl(k, flatmap_detail::is_vectorizable_search<Key, Compare, KeyContainer>());
     }
 
     template<class K,
@@ -952,7 +1394,7 @@ public:
     }
 
     iterator lower_bound(const Key& k) {
-        auto kit = std::partition_point(keys_.begin(), keys_.end(), [&](const auto& elt) {
+        auto kit = flatmap_detail::key_partition_point<Compare>(keys_, [&](const auto& elt) {
             return bool(compare_(elt, k));
         });
         auto vit = values_.begin() + (kit - keys_.begin());
@@ -960,7 +1402,7 @@ public:
     }
 
     const_iterator lower_bound(const Key& k) const {
-        auto kit = std::partition_point(keys_.begin(), keys_.end(), [&](const auto& elt) {
+        auto kit = flatmap_detail::key_partition_point<Compare>(keys_, [&](const auto& elt) {
             return bool(compare_(elt, k));
         });
         auto vit = values_.begin() + (kit - keys_.begin());
@@ -970,7 +1412,7 @@ public:
     template<class K,
              class Compare_ = Compare, class = typename Compare_::is_transparent>
     iterator lower_bound(const K& x) {
-        auto kit = std::partition_point(keys_.begin(), keys_.end(), [&](const auto& elt) {
+        auto kit = flatmap_detail::key_partition_point<Compare>(keys_, [&](const auto& elt) {
             return bool(compare_(elt, x));
         });
         auto vit = values_.begin() + (kit - keys_.begin());
@@ -980,7 +1422,7 @@ public:
     template<class K,
              class Compare_ = Compare, class = typename Compare_::is_transparent>
     const_iterator lower_bound(const K& x) const {
-        auto kit = std::partition_point(keys_.begin(), keys_.end(), [&](const auto& elt) {
+        auto kit = flatmap_detail::key_partition_point<Compare>(keys_, [&](const auto& elt) {
             return bool(compare_(elt, x));
         });
         auto vit = values_.begin() + (kit - keys_.begin());
@@ -988,7 +1430,7 @@ public:
     }
 
     iterator upper_bound(const Key& k) {
-        auto kit = std::partition_point(keys_.begin(), keys_.end(), [&](const auto& elt) {
+        auto kit = flatmap_detail::key_partition_point<Compare>(keys_, [&](const auto& elt) {
             return !bool(compare_(k, elt));
         });
         auto vit = values_.begin() + (kit - keys_.begin());
@@ -996,7 +1438,7 @@ public:
     }
 
     const_iterator upper_bound(const Key& k) const {
-        auto kit = std::partition_point(keys_.begin(), keys_.end(), [&](const auto& elt) {
+        auto kit = flatmap_detail::key_partition_point<Compare>(keys_, [&](const auto& elt) {
             return !bool(compare_(k, elt));
         });
         auto vit = values_.begin() + (kit - keys_.begin());
@@ -1006,7 +1448,7 @@ public:
     template<class K,
              class Compare_ = Compare, class = typename Compare_::is_transparent>
     iterator upper_bound(const K& x) {
-        auto kit = std::partition_point(keys_.begin(), keys_.end(), [&](const auto& elt) {
+        auto kit = flatmap_detail::key_partition_point<Compare>(keys_, [&](const auto& elt) {
             return !bool(compare_(x, elt));
         });
         auto vit = values_.begin() + (kit - keys_.begin());
@@ -1016,7 +1458,7 @@ public:
     template<class K,
              class Compare_ = Compare, class = typename Compare_::is_transparent>
     const_iterator upper_bound(const K& x) const {
-        auto kit = std::partition_point(keys_.begin(), keys_.end(), [&](const auto& elt) {
+        auto kit = flatmap_detail::key_partition_point<Compare>(keys_, [&](const auto& elt) {
             return !bool(compare_(x, elt));
         });
         auto vit = values_.begin() + (kit - keys_.begin());
@@ -1024,10 +1466,10 @@ public:
     }
 
     std::pair<iterator, iterator> equal_range(const Key& k) {
-        auto kit1 = std::partition_point(keys_.begin(), keys_.end(), [&](const auto& elt) {
+        auto kit1 = flatmap_detail::key_partition_point<Compare>(keys_, [&](const auto& elt) {
             return bool(compare_(elt, k));
         });
-        auto kit2 = std::partition_point(kit1, keys_.end(), [&](const auto& elt) {
+        auto kit2 = flatmap_detail::branchless_partition_point(kit1, keys_.end(), [&](const auto& elt) {
             return !bool(compare_(k, elt));
         });
         auto vit1 = values_.begin() + (kit1 - keys_.begin());
@@ -1039,10 +1481,10 @@ public:
     }
 
     std::pair<const_iterator, const_iterator> equal_range(const Key& k) const {
-        auto kit1 = std::partition_point(keys_.begin(), keys_.end(), [&](const auto& elt) {
+        auto kit1 = flatmap_detail::key_partition_point<Compare>(keys_, [&](const auto& elt) {
             return bool(compare_(elt, k));
         });
-        auto kit2 = std::partition_point(kit1, keys_.end(), [&](const auto& elt) {
+        auto kit2 = flatmap_detail::branchless_partition_point(kit1, keys_.end(), [&](const auto& elt) {
             return !bool(compare_(k, elt));
         });
         auto vit1 = values_.begin() + (kit1 - keys_.begin());
@@ -1056,10 +1498,10 @@ public:
     template<class K,
              class Compare_ = Compare, class = typename Compare_::is_transparent>
     std::pair<iterator, iterator> equal_range(const K& x) {
-        auto kit1 = std::partition_point(keys_.begin(), keys_.end(), [&](const auto& elt) {
+        auto kit1 = flatmap_detail::key_partition_point<Compare>(keys_, [&](const auto& elt) {
             return bool(compare_(elt, x));
         });
-        auto kit2 = std::partition_point(kit1, keys_.end(), [&](const auto& elt) {
+        auto kit2 = flatmap_detail::branchless_partition_point(kit1, keys_.end(), [&](const auto& elt) {
             return !bool(compare_(x, elt));
         });
         auto vit1 = values_.begin() + (kit1 - keys_.begin());
@@ -1073,10 +1515,10 @@ public:
     template<class K,
              class Compare_ = Compare, class = typename Compare_::is_transparent>
     std::pair<const_iterator, const_iterator> equal_range(const K& x) const {
-        auto kit1 = std::partition_point(keys_.begin(), keys_.end(), [&](const auto& elt) {
+        auto kit1 = flatmap_detail::key_partition_point<Compare>(keys_, [&](const auto& elt) {
             return bool(compare_(elt, x));
         });
-        auto kit2 = std::partition_point(kit1, keys_.end(), [&](const auto& elt) {
+        auto kit2 = flatmap_detail::branchless_partition_point(kit1, keys_.end(), [&](const auto& elt) {
             return !bool(compare_(x, elt));
         });
         auto vit1 = values_.begin() + (kit1 - keys_.begin());
@@ -1087,6 +1529,75 @@ public:
         };
     }
 
+    // Equivalent to a loop of *out++ = lower_bound(k), but faster for large batches.
+    // When [first, last) is a forward range sorted by key_comp(), each search
+    // gallops forward from the previous result; otherwise, searches are interleaved.
+    template<class InputIterator, class OutputIterator>
+    OutputIterator lower_bound_many(InputIterator first, InputIterator last, OutputIterator out) {
+        using Category = typename std::iterator_traits<InputIterator>::iterator_category;
+        flatmap_detail::for_each_lower_bound(keys_.cbegin(), keys_.size(), first, last, compare_, [&](const auto&, size_t i) {
+            *out = this->begin() + static_cast<difference_type>(i);
+            ++out;
+        }, Category());
+        return out;
+    }
+
+    template<class InputIterator, class OutputIterator>
+    OutputIterator lower_bound_many(InputIterator first, InputIterator last, OutputIterator out) const {
+        using Category = typename std::iterator_traits<InputIterator>::iterator_category;
+        flatmap_detail::for_each_lower_bound(keys_.cbegin(), keys_.size(), first, last, compare_, [&](const auto&, size_t i) {
+            *out = this->begin() + static_cast<difference_type>(i);
+            ++out;
+        }, Category());
+        return out;
+    }
+
+    // Equivalent to a loop of *out++ = find(k), but faster for large batches.
+    template<class InputIterator, class OutputIterator>
+    OutputIterator find_many(InputIterator first, InputIterator last, OutputIterator out) {
+        using Category = typename std::iterator_traits<InputIterator>::iterator_category;
+        flatmap_detail::for_each_lower_bound(keys_.cbegin(), keys_.size(), first, last, compare_, [&](const auto& k, size_t i) {
+            bool found = (i != keys_.size()) && !bool(compare_(k, keys_[i]));
+            *out = found ? this->begin() + static_cast<difference_type>(i) : this->end();
+            ++out;
+        }, Category());
+        return out;
+    }
+
+    template<class InputIterator, class OutputIterator>
+    OutputIterator find_many(InputIterator first, InputIterator last, OutputIterator out) const {
+        using Category = typename std::iterator_traits<InputIterator>::iterator_category;
+        flatmap_detail::for_each_lower_bound(keys_.cbegin(), keys_.size(), first, last, compare_, [&](const auto& k, size_t i) {
+            bool found = (i != keys_.size()) && !bool(compare_(k, keys_[i]));
+            *out = found ? this->begin() + static_cast<difference_type>(i) : this->end();
+            ++out;
+        }, Category());
+        return out;
+    }
+
+#if SG14_EXECUTION_POLICIES
+    // Splits a large batch across threads. Both iterators must be random-access.
+    template<class ExecutionPolicy, class RandomIt, class RandomOutputIt,
+             class = std::enable_if_t<std::is_execution_policy_v<std::decay_t<ExecutionPolicy>>>>
+    RandomOutputIt lower_bound_many(ExecutionPolicy&& policy, RandomIt first, RandomIt last, RandomOutputIt out) const {
+        size_t n = last - first;
+        flatmap_detail::for_each_chunk(static_cast<ExecutionPolicy&&>(policy), n, [&](size_t lo, size_t hi) {
+            this->lower_bound_many(first + lo, first + hi, out + lo);
+        });
+        return out + n;
+    }
+
+    template<class ExecutionPolicy, class RandomIt, class RandomOutputIt,
+             class = std::enable_if_t<std::is_execution_policy_v<std::decay_t<ExecutionPolicy>>>>
+    RandomOutputIt find_many(ExecutionPolicy&& policy, RandomIt first, RandomIt last, RandomOutputIt out) const {
+        size_t n = last - first;
+        flatmap_detail::for_each_chunk(static_cast<ExecutionPolicy&&>(policy), n, [&](size_t lo, size_t hi) {
+            this->find_many(first + lo, first + hi, out + lo);
+        });
+        return out + n;
+    }
+#endif // SG14_EXECUTION_POLICIES
+
     friend bool operator==(const flat_map& a, const flat_map& b) {
         return std::equal(a.begin(), a.end(), b.begin(), b.end());
     }
@@ -1106,14 +1617,131 @@ public:
 #endif
 
 private:
+    bool contains_impl(const Key& k, std::false_type) const {
+        return this->find(k) != this->end();
+    }
+
+    bool contains_impl(const Key& k, std::true_type) const {
+        if (keys_.size() <= 64) {
+            return flatmap_detail::small_contains(keys_, k);
+        }
+        return this->find(k) != this->end();
+    }
+
     void sort_and_unique_impl() {
-        flatmap_detail::sort_together(compare_, keys_, values_);
+        this->sort_impl(flatmap_detail::is_radix_sortable<Key, Compare, KeyContainer>());
         auto kit = flatmap_detail::unique_helper(keys_.begin(), keys_.end(), values_.begin(), compare_);
         auto vit = values_.begin() + (kit - keys_.begin());
         auto it = flatmap_detail::make_iterator(kit, vit);
         this->erase(it, end());
     }
 
+    void sort_impl(std::false_type) {
+        flatmap_detail::sort_together(compare_, keys_, values_);
+    }
+
+    void sort_impl(std::true_type) {
+        size_type n = keys_.size();
+        if (n < flatmap_detail::radix_sort_threshold) {
+            flatmap_detail::sort_together(compare_, keys_, values_);
+            return;
+        }
+        const bool descending = flatmap_detail::is_descending<Compare>::value;
+        if (n <= size_type(UINT32_MAX)) {
+            std::vector<uint32_t> order = flatmap_detail::radix_sort_keys<uint32_t>(keys_.data(), n, descending);
+            flatmap_detail::gather(order.data(), n, values_.begin());
+        } else {
+            std::vector<size_t> order = flatmap_detail::radix_sort_keys<size_t>(keys_.data(), n, descending);
+            flatmap_detail::gather(order.data(), n, values_.begin());
+        }
+    }
+
+#if SG14_EXECUTION_POLICIES
+    // Sorts a permutation rather than the containers themselves, so that the
+    // parallel sort and dedupe see plain indices; then gathers the survivors.
+    template<class ExecutionPolicy>
+    void sort_and_unique_impl(ExecutionPolicy&& policy) {
+        size_type n = keys_.size();
+        std::vector<size_t> order(n);
+        for (size_t i = 0; i < n; ++i) {
+            order[i] = i;
+        }
+        std::sort(policy, order.begin(), order.end(), [&](size_t a, size_t b) {
+            return bool(compare_(keys_[a], keys_[b]));
+        });
+        auto last = std::unique(policy, order.begin(), order.end(), [&](size_t a, size_t b) {
+            return !bool(compare_(keys_[a], keys_[b]));
+        });
+        size_type survivors = last - order.begin();
+        flatmap_detail::gather(order.data(), survivors, keys_.begin());
+        flatmap_detail::gather(order.data(), survivors, values_.begin());
+        this->erase(begin() + survivors, end());
+    }
+#endif // SG14_EXECUTION_POLICIES
+
+    // The elements in [0, oldsize) are sorted and unique; the elements in [oldsize, size())
+    // have just been appended. Sort the new elements (stably, so that the first of several
+    // equivalent keys wins, exactly as if they'd been inserted one at a time), drop any whose
+    // key is already present, and merge the rest into place from the back.
+    // This costs O(m log m + m log n) comparisons, O(n + m) moves, and O(m) scratch space,
+    // instead of the O(nm) moves of inserting each element individually.
+    void merge_appended_impl(size_type oldsize, bool already_sorted) {
+        size_type n = keys_.size();
+        if (n == oldsize) {
+            return;
+        }
+        auto kbegin = keys_.begin();
+        auto vbegin = values_.begin();
+        std::vector<size_type> order(n - oldsize);
+        for (size_type i = 0; i < order.size(); ++i) {
+            order[i] = oldsize + i;
+        }
+        if (!already_sorted) {
+            std::stable_sort(order.begin(), order.end(), [&](size_type a, size_type b) {
+                return bool(compare_(kbegin[a], kbegin[b]));
+            });
+        }
+        std::vector<Key> newkeys;
+        std::vector<Mapped> newvalues;
+        newkeys.reserve(order.size());
+        newvalues.reserve(order.size());
+        auto lo = kbegin;
+        auto hi = kbegin + oldsize;
+        for (size_type i : order) {
+            auto&& k = kbegin[i];
+            if (!newkeys.empty() && !bool(compare_(newkeys.back(), k))) {
+                continue;  // equivalent to an earlier new key
+            }
+            lo = std::partition_point(lo, hi, [&](const auto& elt) {
+                return bool(compare_(elt, k));
+            });
+            if (lo != hi && !bool(compare_(k, *lo))) {
+                continue;  // equivalent to an existing key
+            }
+            newkeys.emplace_back(std::move(k));
+            newvalues.emplace_back(std::move(vbegin[i]));
+        }
+        size_type m = newkeys.size();
+        keys_.erase(keys_.begin() + (oldsize + m), keys_.end());
+        values_.erase(values_.begin() + (oldsize + m), values_.end());
+        kbegin = keys_.begin();
+        vbegin = values_.begin();
+        size_type i = oldsize;
+        size_type d = oldsize + m;
+        while (m != 0) {
+            --d;
+            if (i != 0 && bool(compare_(newkeys[m-1], kbegin[i-1]))) {
+                --i;
+                kbegin[d] = std::move(kbegin[i]);
+                vbegin[d] = std::move(vbegin[i]);
+            } else {
+                --m;
+                kbegin[d] = std::move(newkeys[m]);
+                vbegin[d] = std::move(newvalues[m]);
+            }
+        }
+    }
+
     KeyContainer keys_;
     MappedContainer values_;
     Compare compare_;
@@ -1148,4 +1776,199 @@ flat_map(std::from_range_t, R&&, Compare = Compare())
 
 #endif // __cpp_deduction_guides
 
+namespace flatmap_detail {
+    // A snapshot is this header, then the keys, then the mapped values,
+    // each array starting at a multiple of snapshot_alignment bytes from the header.
+    // Every field is in the writer's byte order; byte_order lets a reader detect a mismatch.
+    struct snapshot_header {
+        char magic[8];
+        uint32_t version;
+        uint32_t byte_order;
+        uint32_t key_size;
+        uint32_t mapped_size;
+        uint64_t size;
+        uint64_t keys_offset;
+        uint64_t values_offset;
+        uint64_t total_size;
+    };
+
+    constexpr char snapshot_magic[8] = {'S', 'G', '1', '4', 'F', 'M', 'A', 'P'};
+    constexpr uint32_t snapshot_version = 1;
+    constexpr uint32_t snapshot_byte_order = 0x01020304;
+    constexpr uint64_t snapshot_alignment = 64;
+
+    inline uint64_t snapshot_round_up(uint64_t n) {
+        return (n + (snapshot_alignment - 1)) & ~(snapshot_alignment - 1);
+    }
+
+    template<class Write>
+    void snapshot_pad(Write& write, uint64_t from, uint64_t to) {
+        static const unsigned char zeros[snapshot_alignment] = {};
+        if (to != from) {
+            write(static_cast<const void*>(zeros), size_t(to - from));
+        }
+    }
+
+    // Just enough of a container for key_partition_point.
+    template<class T>
+    struct const_span {
+        using value_type = T;
+        using const_iterator = const T*;
+        const T *data_ = nullptr;
+        size_t size_ = 0;
+
+        const T *data() const { return data_; }
+        size_t size() const { return size_; }
+        const T *begin() const { return data_; }
+        const T *end() const { return data_ + size_; }
+    };
+} // namespace flatmap_detail
+
+// write_snapshot(m, write) writes m in the format read by flat_map_view,
+// as a series of calls to write(const void *p, size_t n).
+// Both containers must be contiguous, and both element types trivially copyable.
+template<class Key, class Mapped, class Compare, class KeyContainer, class MappedContainer, class Write>
+void write_snapshot(const flat_map<Key, Mapped, Compare, KeyContainer, MappedContainer>& m, Write write)
+{
+    static_assert(std::is_trivially_copyable<Key>::value && std::is_trivially_copyable<Mapped>::value,
+                  "write_snapshot requires trivially copyable keys and mapped values");
+    static_assert(flatmap_detail::has_contiguous_data<KeyContainer>::value && flatmap_detail::has_contiguous_data<MappedContainer>::value,
+                  "write_snapshot requires contiguous containers");
+    static_assert(alignof(Key) <= flatmap_detail::snapshot_alignment && alignof(Mapped) <= flatmap_detail::snapshot_alignment, "");
+    flatmap_detail::snapshot_header h = {};
+    memcpy(h.magic, flatmap_detail::snapshot_magic, sizeof h.magic);
+    h.version = flatmap_detail::snapshot_version;
+    h.byte_order = flatmap_detail::snapshot_byte_order;
+    h.key_size = sizeof(Key);
+    h.mapped_size = sizeof(Mapped);
+    h.size = m.size();
+    h.keys_offset = flatmap_detail::snapshot_round_up(sizeof h);
+    h.values_offset = flatmap_detail::snapshot_round_up(h.keys_offset + h.size * sizeof(Key));
+    h.total_size = h.values_offset + h.size * sizeof(Mapped);
+    write(static_cast<const void*>(&h), sizeof h);
+    flatmap_detail::snapshot_pad(write, sizeof h, h.keys_offset);
+    if (h.size != 0) {
+        write(static_cast<const void*>(m.keys().data()), size_t(h.size * sizeof(Key)));
+    }
+    flatmap_detail::snapshot_pad(write, h.keys_offset + h.size * sizeof(Key), h.values_offset);
+    if (h.size != 0) {
+        write(static_cast<const void*>(m.values().data()), size_t(h.size * sizeof(Mapped)));
+    }
+}
+
+// A flat_map_view is a read-only flat_map whose keys and mapped values live in a
+// snapshot written by write_snapshot, for example in a memory-mapped file;
+// nothing is copied or deserialized. The memory must outlive the view, and must
+// be aligned at least as strictly as Key, Mapped and uint64_t.
+// Compare must order keys the same way as the flat_map that was written.
+//
+template<class Key, class Mapped, class Compare = std::less<Key>>
+class flat_map_view {
+    static_assert(std::is_trivially_copyable<Key>::value && std::is_trivially_copyable<Mapped>::value,
+                  "flat_map_view requires trivially copyable keys and mapped values");
+public:
+    using key_type = Key;
+    using mapped_type = Mapped;
+    using value_type = std::pair<const Key, Mapped>;
+    using key_compare = Compare;
+    using reference = std::pair<const Key&, const Mapped&>;
+    using const_reference = reference;
+    using size_type = size_t;
+    using difference_type = ptrdiff_t;
+    using iterator = flatmap_detail::iter<const Key*, const Mapped*>;
+    using const_iterator = iterator;
+    using reverse_iterator = std::reverse_iterator<iterator>;
+    using const_reverse_iterator = reverse_iterator;
+
+    flat_map_view() = default;
+
+    // Throws std::invalid_argument unless [data, data+size) holds a snapshot
+    // written on a machine like this one, for these key and mapped types.
+    explicit flat_map_view(const void *data, size_t size, const Compare& comp = Compare())
+        : compare_(comp)
+    {
+        const size_t align = (std::max)({alignof(Key), alignof(Mapped), alignof(flatmap_detail::snapshot_header)});
+        if (size < sizeof(flatmap_detail::snapshot_header) || reinterpret_cast<uintptr_t>(data) % align != 0) {
+            SG14_FLAT_MAP_THROW(std::invalid_argument("flat_map_view: too short or misaligned"));
+        }
+        flatmap_detail::snapshot_header h;
+        memcpy(&h, data, sizeof h);
+        if (memcmp(h.magic, flatmap_detail::snapshot_magic, sizeof h.magic) != 0 || h.version != flatmap_detail::snapshot_version) {
+            SG14_FLAT_MAP_THROW(std::invalid_argument("flat_map_view: not a flat_map snapshot"));
+        } else if (h.byte_order != flatmap_detail::snapshot_byte_order) {
+            SG14_FLAT_MAP_THROW(std::invalid_argument("flat_map_view: snapshot has the wrong byte order"));
+        } else if (h.key_size != sizeof(Key) || h.mapped_size != sizeof(Mapped)) {
+            SG14_FLAT_MAP_THROW(std::invalid_argument("flat_map_view: snapshot has the wrong element types"));
+        } else if (h.total_size > size || h.keys_offset > h.total_size || h.values_offset > h.total_size || h.size > size ||
+                   h.keys_offset < sizeof h || h.keys_offset % flatmap_detail::snapshot_alignment != 0 ||
+                   h.values_offset % flatmap_detail::snapshot_alignment != 0 ||
+                   h.values_offset < h.keys_offset + h.size * sizeof(Key) ||
+                   h.total_size != h.values_offset + h.size * sizeof(Mapped)) {
+            SG14_FLAT_MAP_THROW(std::invalid_argument("flat_map_view: snapshot is truncated or corrupt"));
+        }
+        const char *base = static_cast<const char*>(data);
+        keys_.data_ = reinterpret_cast<const Key*>(base + h.keys_offset);
+        keys_.size_ = size_t(h.size);
+        values_ = reinterpret_cast<const Mapped*>(base + h.values_offset);
+    }
+
+    const_iterator begin() const { return flatmap_detail::make_iterator(keys_.begin(), values_); }
+    const_iterator end() const { return flatmap_detail::make_iterator(keys_.end(), values_ + keys_.size()); }
+    const_iterator cbegin() const { return begin(); }
+    const_iterator cend() const { return end(); }
+    const_reverse_iterator rbegin() const { return const_reverse_iterator(end()); }
+    const_reverse_iterator rend() const { return const_reverse_iterator(begin()); }
+
+    bool empty() const noexcept { return keys_.size() == 0; }
+    size_type size() const noexcept { return keys_.size(); }
+
+    const Mapped& at(const Key& k) const {
+        auto it = this->find(k);
+        if (it == end()) {
+            SG14_FLAT_MAP_THROW(std::out_of_range("flat_map_view::at"));
+        }
+        return it->second;
+    }
+
+    key_compare key_comp() const { return compare_; }
+    const Key *keys() const noexcept { return keys_.data(); }
+    const Mapped *values() const noexcept { return values_; }
+
+    const_iterator find(const Key& k) const {
+        auto it = this->lower_bound(k);
+        if (it == end() || compare_(k, it->first)) {
+            return end();
+        }
+        return it;
+    }
+
+    size_type count(const Key& k) const { return this->contains(k) ? 1 : 0; }
+    bool contains(const Key& k) const { return this->find(k) != end(); }
+
+    const_iterator lower_bound(const Key& k) const {
+        const Key *kit = flatmap_detail::key_partition_point<Compare>(keys_, [&](const auto& elt) {
+            return bool(compare_(elt, k));
+        });
+        return flatmap_detail::make_iterator(kit, values_ + (kit - keys_.begin()));
+    }
+
+    const_iterator upper_bound(const Key& k) const {
+        const Key *kit = flatmap_detail::key_partition_point<Compare>(keys_, [&](const auto& elt) {
+            return !bool(compare_(k, elt));
+        });
+        return flatmap_detail::make_iterator(kit, values_ + (kit - keys_.begin()));
+    }
+
+    std::pair<const_iterator, const_iterator> equal_range(const Key& k) const {
+        auto lo = this->lower_bound(k);
+        auto hi = (lo == end() || compare_(k, lo->first)) ? lo : std::next(lo);
+        return {lo, hi};
+    }
+
+private:
+    flatmap_detail::const_span<Key> keys_;
+    const Mapped *values_ = nullptr;
+    Compare compare_;
+};
+
 } // namespace sg14
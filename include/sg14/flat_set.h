@@ -34,6 +34,7 @@
 #include <functional>
 #include <initializer_list>
 #include <iterator>
+#include <memory>
 #include <vector>
 
 #if __cplusplus >= 202002L
@@ -42,6 +43,14 @@
 #include <ranges>
 #endif // __cplusplus >= 202002L
 
+#ifndef SG14_EXECUTION_POLICIES
+ #define SG14_EXECUTION_POLICIES 0  // opt in to the std::execution overloads; this may require linking TBB
+#endif
+
+#if SG14_EXECUTION_POLICIES
+#include <execution>
+#endif
+
 namespace sg14 {
 
 namespace flatset_detail {
@@ -102,6 +111,176 @@ namespace flatset_detail {
         return dfirst;
     }
 
+    // Equivalent to std::partition_point on a random-access range, but the loop body
+    // is a conditional move rather than a conditional branch, so it doesn't suffer
+    // from misprediction on large tables. The trip count depends only on the size.
+    template<class It, class Pred>
+    It branchless_partition_point(It first, It last, Pred pred) {
+        auto n = last - first;
+        if (n == 0) {
+            return first;
+        }
+        while (n > 1) {
+            auto half = n / 2;
+            first = bool(pred(first[half])) ? first + half : first;
+            n -= half;
+        }
+        return bool(pred(*first)) ? first + 1 : first;
+    }
+
+    // A hint only; it may be a no-op.
+    template<class It>
+    auto prefetch_element(It it, priority_tag<1>) -> decltype(void(std::addressof(*it))) {
+#if defined(__GNUC__) || defined(__clang__)
+        __builtin_prefetch(std::addressof(*it));
+#else
+        (void)it;
+#endif
+    }
+    template<class It>
+    void prefetch_element(It, priority_tag<0>) {}
+
+    // Calls f(key, i) for each key in [first, last), in order, where i is the
+    // index of that key's lower bound among the n sorted keys starting at kbegin.
+    // Sorted input that is dense relative to the keys is answered by galloping
+    // forward from the previous result. Otherwise, the searches proceed in lockstep
+    // groups, so that the group's cache misses overlap instead of being paid one
+    // after another.
+    template<class KeyIt, class InputIt, class Compare, class F>
+    void for_each_lower_bound(KeyIt kbegin, size_t n, InputIt first, InputIt last, const Compare& compare, F f, std::input_iterator_tag) {
+        for (; first != last; ++first) {
+            auto&& k = *first;
+            auto kit = branchless_partition_point(kbegin, kbegin + n, [&](const auto& elt) {
+                return bool(compare(elt, k));
+            });
+            f(k, size_t(kit - kbegin));
+        }
+    }
+
+    template<class KeyIt, class FwdIt, class Compare, class F>
+    void for_each_lower_bound(KeyIt kbegin, size_t n, FwdIt first, FwdIt last, const Compare& compare, F f, std::forward_iterator_tag) {
+        size_t m = size_t(std::distance(first, last));
+        if (n / 64 <= m && std::is_sorted(first, last, compare)) {
+            size_t prev = 0;
+            for (; first != last; ++first) {
+                auto&& k = *first;
+                auto pred = [&](const auto& elt) { return bool(compare(elt, k)); };
+                size_t lo = prev;
+                if (lo != n && pred(kbegin[lo])) {
+                    size_t step = 1;
+                    while (lo + step < n && pred(kbegin[lo + step])) {
+                        lo += step;
+                        step *= 2;
+                    }
+                    size_t hi = (lo + step < n) ? (lo + step) : n;
+                    lo = size_t(branchless_partition_point(kbegin + (lo + 1), kbegin + hi, pred) - kbegin);
+                }
+                f(k, lo);
+                prev = lo;
+            }
+            return;
+        }
+        constexpr size_t group = 16;
+        FwdIt its[group];
+        size_t base[group];
+        while (first != last) {
+            size_t g = 0;
+            for (; g < group && first != last; ++g, ++first) {
+                its[g] = first;
+                base[g] = 0;
+            }
+            size_t len = n;
+            while (len > 1) {
+                size_t half = len / 2;
+                for (size_t j = 0; j < g; ++j) {
+                    base[j] = bool(compare(kbegin[base[j] + half], *its[j])) ? base[j] + half : base[j];
+                }
+                len -= half;
+                for (size_t j = 0; j < g; ++j) {
+                    prefetch_element(kbegin + (base[j] + len / 2), priority_tag<1>());
+                }
+            }
+            for (size_t j = 0; j < g; ++j) {
+                size_t i = (n != 0 && bool(compare(kbegin[base[j]], *its[j]))) ? base[j] + 1 : base[j];
+                f(*its[j], i);
+            }
+        }
+    }
+
+#if SG14_EXECUTION_POLICIES
+    // Splits [0, n) into chunks big enough to amortize the scheduling,
+    // and calls f(lo, hi) on each chunk under the given policy.
+    template<class ExecutionPolicy, class F>
+    void for_each_chunk(ExecutionPolicy&& policy, size_t n, F f) {
+        constexpr size_t chunk = 4096;
+        std::vector<size_t> starts;
+        for (size_t lo = 0; lo < n; lo += chunk) {
+            starts.push_back(lo);
+        }
+        std::for_each(static_cast<ExecutionPolicy&&>(policy), starts.begin(), starts.end(), [&](size_t lo) {
+            f(lo, (n - lo < chunk) ? n : lo + chunk);
+        });
+    }
+#endif // SG14_EXECUTION_POLICIES
+
+    template<class C>
+    auto spare_capacity(const C& c, priority_tag<1>) -> decltype(size_t(c.capacity())) {
+        return size_t(c.capacity() - c.size());
+    }
+    template<class C>
+    size_t spare_capacity(const C&, priority_tag<0>) {
+        return size_t(-1);  // e.g. std::deque, which can grow without relocating anything
+    }
+
+    template<class C>
+    auto reserve_if_possible(C& c, size_t n, priority_tag<1>) -> decltype(void(c.reserve(n))) {
+        c.reserve(n);
+    }
+    template<class C>
+    void reserve_if_possible(C&, size_t, priority_tag<0>) {}
+
+    template<class C>
+    void swap_by_moving(C& a, C& b) {
+        C temp = static_cast<C&&>(a);
+        a = static_cast<C&&>(b);
+        b = static_cast<C&&>(temp);
+    }
+
+    // Given sorted sequences a and b with no elements in common, merges b into a,
+    // leaving b's elements moved-from. The largest b.size() elements of the result
+    // are appended to a, and then the rest are merged backward into a's existing
+    // slots, so nothing is shifted more than once and no scratch space is needed.
+    template<class Container, class Compare>
+    void merge_disjoint(Container& a, Container& b, const Compare& compare) {
+        size_t n = a.size();
+        size_t m = b.size();
+        size_t i = n;
+        size_t j = m;
+        for (size_t t = 0; t < m; ++t) {
+            if (i != 0 && (j == 0 || bool(compare(b[j-1], a[i-1])))) {
+                --i;
+            } else {
+                --j;
+            }
+        }
+        reserve_if_possible(a, n + m, priority_tag<1>());
+        for (size_t ia = i, ib = j; ia != n || ib != m; ) {
+            if (ib == m || (ia != n && bool(compare(a[ia], b[ib])))) {
+                a.emplace_back(std::move(a[ia++]));
+            } else {
+                a.emplace_back(std::move(b[ib++]));
+            }
+        }
+        for (size_t d = n; j != 0; ) {
+            --d;
+            if (i != 0 && bool(compare(b[j-1], a[i-1]))) {
+                a[d] = std::move(a[--i]);
+            } else {
+                a[d] = std::move(b[--j]);
+            }
+        }
+    }
+
     template<class FS>
     struct InvariantRestoringGuard {
         FS *self_;
@@ -132,6 +311,145 @@ namespace flatset_detail {
     template<class It>
     using qualifies_as_input_iterator = std::integral_constant<bool, !std::is_integral<It>::value>;
 
+    // Arithmetic keys in contiguous storage, ordered by std::less or std::greater,
+    // are cheap enough to compare that it's faster to scan the last vector register's
+    // worth of a search linearly, with a loop the compiler can vectorize, than to
+    // keep bisecting. Anything else uses the plain branchless bisection.
+    template<class C, class = void>
+    struct has_contiguous_data : std::false_type {};
+    template<class C>
+    struct has_contiguous_data<C, void_t<decltype(std::declval<const C&>().data())>> : std::is_same<
+        decltype(std::declval<const C&>().data()), const typename C::value_type*
+    > {};
+
+    template<class Key, class Compare, class Container>
+    using is_vectorizable_search = std::integral_constant<bool,
+        std::is_arithmetic<Key>::value && !std::is_same<Key, bool>::value &&
+        (std::is_same<Compare, std::less<Key>>::value || std::is_same<Compare, std::less<>>::value ||
+         std::is_same<Compare, std::greater<Key>>::value || std::is_same<Compare, std::greater<>>::value) &&
+        has_contiguous_data<Container>::value
+    >;
+
+    template<class Container, class Pred>
+    auto key_partition_point(Container& c, Pred pred, std::false_type) -> decltype(c.begin()) {
+        return branchless_partition_point(c.begin(), c.end(), pred);
+    }
+
+    template<class Container, class Pred>
+    auto key_partition_point(Container& c, Pred pred, std::true_type) -> decltype(c.begin()) {
+        using T = typename Container::value_type;
+        constexpr size_t lanes = (sizeof(T) < 32) ? (32 / sizeof(T)) : 1;
+        const T *data = c.data();
+        const T *first = data;
+        size_t n = c.size();
+        size_t count = 0;
+        if (n < lanes) {
+            for (size_t i = 0; i < n; ++i) {
+                count += bool(pred(first[i])) ? 1 : 0;
+            }
+        } else {
+            while (n > lanes) {
+                size_t half = n / 2;
+                first = bool(pred(first[half])) ? first + half : first;
+                n -= half;
+            }
+            // The answer is in [first, first+n]. Slide a whole window over it,
+            // staying in bounds, so that the scan has a constant trip count.
+            if (first + lanes > data + c.size()) {
+                first = data + c.size() - lanes;
+            }
+            for (size_t i = 0; i < lanes; ++i) {
+                count += bool(pred(first[i])) ? 1 : 0;
+            }
+        }
+        return c.begin() + ((first - data) + count);
+    }
+
+    template<class Compare, class Container, class Pred>
+    auto key_partition_point(Container& c, Pred pred) -> decltype(c.begin()) {
+        using Key = typename std::remove_const<typename Container::value_type>::type;
+        return key_partition_point(c, pred, is_vectorizable_search<Key, Compare, Container>());
+    }
+
+    // For those same keys, equivalence is equality; on small containers a
+    // straight equality scan beats any search.
+    template<class Container, class Key>
+    bool small_contains(const Container& c, const Key& k) {
+        const auto *data = c.data();
+        size_t n = c.size();
+        bool found = false;
+        for (size_t i = 0; i < n; ++i) {
+            found |= (data[i] == k);
+        }
+        return found;
+    }
+
+    // Integer keys in contiguous storage, ordered by std::less or std::greater, can be
+    // sorted by an LSD radix sort in linear time; past a couple of thousand elements that beats
+    // any comparison sort.
+    template<class Key, class Compare, class Container>
+    using is_radix_sortable = std::integral_constant<bool,
+        std::is_integral<Key>::value && !std::is_same<Key, bool>::value &&
+        is_vectorizable_search<Key, Compare, Container>::value
+    >;
+
+    constexpr size_t radix_sort_threshold = 2048;
+
+    template<class Compare> struct is_descending : std::false_type {};
+    template<class T> struct is_descending<std::greater<T>> : std::true_type {};
+
+    // Maps k to an unsigned integer whose natural order is the key order.
+    template<class T>
+    std::make_unsigned_t<T> radix_bits(T k, bool descending) {
+        using U = std::make_unsigned_t<T>;
+        U u = static_cast<U>(k);
+        if (std::is_signed<T>::value) {
+            u = static_cast<U>(u ^ (U(1) << (sizeof(U) * 8 - 1)));
+        }
+        return descending ? static_cast<U>(~u) : u;
+    }
+
+    // A stable LSD radix sort of [first, first+n) by bits(elt), a byte per pass,
+    // using scratch[0, n) as the ping-pong buffer. All the histograms come from
+    // one read of the input, and a pass on which every element has the same digit
+    // is skipped, so a narrow range of keys costs fewer passes.
+    template<class T, class Bits>
+    void radix_sort(T *first, T *scratch, size_t n, Bits bits) {
+        using U = decltype(bits(*first));
+        constexpr size_t digits = sizeof(U);
+        if (n < 2) {
+            return;
+        }
+        std::vector<size_t> counts(digits * 256);
+        for (size_t i = 0; i < n; ++i) {
+            U u = bits(first[i]);
+            for (size_t d = 0; d < digits; ++d) {
+                counts[d * 256 + ((u >> (d * 8)) & 0xFF)] += 1;
+            }
+        }
+        T *src = first;
+        T *dst = scratch;
+        for (size_t d = 0; d < digits; ++d) {
+            size_t *c = counts.data() + d * 256;
+            if (c[(bits(src[0]) >> (d * 8)) & 0xFF] == n) {
+                continue;
+            }
+            size_t sum = 0;
+            for (size_t b = 0; b < 256; ++b) {
+                size_t here = c[b];
+                c[b] = sum;
+                sum += here;
+            }
+            for (size_t i = 0; i < n; ++i) {
+                dst[c[(bits(src[i]) >> (d * 8)) & 0xFF]++] = src[i];
+            }
+            std::swap(src, dst);
+        }
+        if (src != first) {
+            std::copy(src, src + n, first);
+        }
+    }
+
 } // namespace flatset_detail
 
 #ifndef SG14_HAS_SORTED_UNIQUE
@@ -181,6 +499,17 @@ public:
         this->sort_and_unique_impl();
     }
 
+#if SG14_EXECUTION_POLICIES
+    // Sorts and dedupes ctr under the given policy.
+    template<class ExecutionPolicy,
+             class = std::enable_if_t<std::is_execution_policy_v<std::decay_t<ExecutionPolicy>>>>
+    flat_set(ExecutionPolicy&& policy, KeyContainer ctr, const Compare& comp = Compare())
+        : c_(static_cast<KeyContainer&&>(ctr)), compare_(comp)
+    {
+        this->sort_and_unique_impl(static_cast<ExecutionPolicy&&>(policy));
+    }
+#endif // SG14_EXECUTION_POLICIES
+
     template<class Alloc,
              class = typename std::enable_if<std::uses_allocator<KeyContainer, Alloc>::value>::type>
     flat_set(KeyContainer&& ctr, const Alloc& a)
@@ -503,6 +832,72 @@ public:
         c_ = static_cast<KeyContainer&&>(ctr);
     }
 
+#if SG14_EXECUTION_POLICIES
+    template<class ExecutionPolicy,
+             class = std::enable_if_t<std::is_execution_policy_v<std::decay_t<ExecutionPolicy>>>>
+    void replace(ExecutionPolicy&& policy, KeyContainer ctr) {
+        c_ = static_cast<KeyContainer&&>(ctr);
+        this->sort_and_unique_impl(static_cast<ExecutionPolicy&&>(policy));
+    }
+#endif // SG14_EXECUTION_POLICIES
+
+    // Inserts each element of source that isn't already present, and leaves source empty.
+    // Linear time. If only source's container has enough spare capacity for the result,
+    // the result is built in source's storage instead of reallocating ours.
+    void merge(flat_set&& source) {
+        flatset_detail::InvariantRestoringGuard<flat_set> guard(this);
+        flatset_detail::InvariantRestoringGuard<flat_set> sguard(&source);
+        auto it = c_.begin();
+        auto w = source.c_.begin();
+        for (auto r = source.c_.begin(); r != source.c_.end(); ++r) {
+            while (it != c_.end() && bool(compare_(*it, *r))) {
+                ++it;
+            }
+            if (it != c_.end() && !bool(compare_(*r, *it))) {
+                continue;  // already present
+            }
+            if (w != r) {
+                *w = std::move(*r);
+            }
+            ++w;
+        }
+        source.c_.erase(w, source.c_.end());
+        if (flatset_detail::spare_capacity(c_, flatset_detail::priority_tag<1>()) < source.c_.size() &&
+            flatset_detail::spare_capacity(source.c_, flatset_detail::priority_tag<1>()) >= c_.size()) {
+            flatset_detail::swap_by_moving(c_, source.c_);
+        }
+        flatset_detail::merge_disjoint(c_, source.c_, compare_);
+        source.c_.clear();
+        sguard.complete();
+        guard.complete();
+    }
+
+    // Erases each element equivalent to some element of [first, last), which must be
+    // sorted with respect to key_comp(). Linear time; a single pass over each sequence.
+    template<class InputIterator>
+    void subtract(sorted_unique_t, InputIterator first, InputIterator last) {
+        flatset_detail::InvariantRestoringGuard<flat_set> guard(this);
+        auto w = c_.begin();
+        for (auto r = c_.begin(); r != c_.end(); ++r) {
+            while (first != last && bool(compare_(*first, *r))) {
+                ++first;
+            }
+            if (first != last && !bool(compare_(*r, *first))) {
+                continue;  // erase *r
+            }
+            if (w != r) {
+                *w = std::move(*r);
+            }
+            ++w;
+        }
+        c_.erase(w, c_.end());
+        guard.complete();
+    }
+
+    void subtract(const flat_set& other) {
+        this->subtract(sorted_unique, other.begin(), other.end());
+    }
+
     iterator erase(iterator position) {
         return c_.erase(position);
     }
@@ -596,7 +991,7 @@ public:
     }
 
     bool contains(const Key& x) const {
-        return this->find(x) != this->end();
+        return this->contains_impl(x, flatset_detail::is_vectorizable_search<Key, Compare, KeyContainer>());
     }
 
     template<class K,
@@ -606,13 +1001,13 @@ public:
     }
 
     iterator lower_bound(const Key& t) {
-        return std::partition_point(this->begin(), this->end(), [&](const Key& elt) {
+        return flatset_detail::key_partition_point<Compare>(c_, [&](const Key& elt) {
             return bool(compare_(elt, t));
         });
     }
 
     const_iterator lower_bound(const Key& t) const {
-        return std::partition_point(this->begin(), this->end(), [&](const Key& elt) {
+        return flatset_detail::key_partition_point<Compare>(c_, [&](const Key& elt) {
             return bool(compare_(elt, t));
         });
     }
@@ -620,7 +1015,7 @@ public:
     template<class K,
              class Compare_ = Compare, class = typename Compare_::is_transparent>
     iterator lower_bound(const K& x) {
-        return std::partition_point(this->begin(), this->end(), [&](const Key& elt) {
+        return flatset_detail::key_partition_point<Compare>(c_, [&](const Key& elt) {
             return bool(compare_(elt, x));
         });
     }
@@ -628,19 +1023,19 @@ public:
     template<class K,
              class Compare_ = Compare, class = typename Compare_::is_transparent>
     const_iterator lower_bound(const K& x) const {
-        return std::partition_point(this->begin(), this->end(), [&](const Key& elt) {
+        return flatset_detail::key_partition_point<Compare>(c_, [&](const Key& elt) {
             return bool(compare_(elt, x));
         });
     }
 
     iterator upper_bound(const Key& t) {
-        return std::partition_point(this->begin(), this->end(), [&](const Key& elt) {
+        return flatset_detail::key_partition_point<Compare>(c_, [&](const Key& elt) {
             return !bool(compare_(t, elt));
         });
     }
 
     const_iterator upper_bound(const Key& t) const {
-        return std::partition_point(this->begin(), this->end(), [&](const Key& elt) {
+        return flatset_detail::key_partition_point<Compare>(c_, [&](const Key& elt) {
             return !bool(compare_(t, elt));
         });
     }
@@ -648,7 +1043,7 @@ public:
     template<class K,
              class Compare_ = Compare, class = typename Compare_::is_transparent>
     iterator upper_bound(const K& x) {
-        return std::partition_point(this->begin(), this->end(), [&](const Key& elt) {
+        return flatset_detail::key_partition_point<Compare>(c_, [&](const Key& elt) {
             return !bool(compare_(x, elt));
         });
     }
@@ -656,26 +1051,26 @@ public:
     template<class K,
              class Compare_ = Compare, class = typename Compare_::is_transparent>
     const_iterator upper_bound(const K& x) const {
-        return std::partition_point(this->begin(), this->end(), [&](const Key& elt) {
+        return flatset_detail::key_partition_point<Compare>(c_, [&](const Key& elt) {
             return !bool(compare_(x, elt));
         });
     }
 
     std::pair<iterator, iterator> equal_range(const Key& t) {
-        auto lo = std::partition_point(this->begin(), this->end(), [&](const Key& elt) {
+        auto lo = flatset_detail::key_partition_point<Compare>(c_, [&](const Key& elt) {
             return bool(compare_(elt, t));
         });
-        auto hi = std::partition_point(lo, this->end(), [&](const Key& elt) {
+        auto hi = flatset_detail::branchless_partition_point(lo, this->end(), [&](const Key& elt) {
             return !bool(compare_(t, elt));
         });
         return { lo, hi };
     }
 
     std::pair<const_iterator, const_iterator> equal_range(const Key& t) const {
-        auto lo = std::partition_point(this->begin(), this->end(), [&](const Key& elt) {
+        auto lo = flatset_detail::key_partition_point<Compare>(c_, [&](const Key& elt) {
             return bool(compare_(elt, t));
         });
-        auto hi = std::partition_point(lo, this->end(), [&](const Key& elt) {
+        auto hi = flatset_detail::branchless_partition_point(lo, this->end(), [&](const Key& elt) {
             return !bool(compare_(t, elt));
         });
         return { lo, hi };
@@ -684,10 +1079,10 @@ public:
     template<class K,
              class Compare_ = Compare, class = typename Compare_::is_transparent>
     std::pair<iterator, iterator> equal_range(const K& x) {
-        auto lo = std::partition_point(this->begin(), this->end(), [&](const Key& elt) {
+        auto lo = flatset_detail::key_partition_point<Compare>(c_, [&](const Key& elt) {
             return bool(compare_(elt, x));
         });
-        auto hi = std::partition_point(lo, this->end(), [&](const Key& elt) {
+        auto hi = flatset_detail::branchless_partition_point(lo, this->end(), [&](const Key& elt) {
             return !bool(compare_(x, elt));
         });
         return { lo, hi };
@@ -696,15 +1091,84 @@ public:
     template<class K,
              class Compare_ = Compare, class = typename Compare_::is_transparent>
     std::pair<const_iterator, const_iterator> equal_range(const K& x) const {
-        auto lo = std::partition_point(this->begin(), this->end(), [&](const Key& elt) {
+        auto lo = flatset_detail::key_partition_point<Compare>(c_, [&](const Key& elt) {
             return bool(compare_(elt, x));
         });
-        auto hi = std::partition_point(lo, this->end(), [&](const Key& elt) {
+        auto hi = flatset_detail::branchless_partition_point(lo, this->end(), [&](const Key& elt) {
             return !bool(compare_(x, elt));
         });
         return { lo, hi };
     }
 
+    // Equivalent to a loop of *out++ = lower_bound(k), but faster for large batches.
+    // When [first, last) is a forward range sorted by key_comp(), each search
+    // gallops forward from the previous result; otherwise, searches are interleaved.
+    template<class InputIterator, class OutputIterator>
+    OutputIterator lower_bound_many(InputIterator first, InputIterator last, OutputIterator out) {
+        using Category = typename std::iterator_traits<InputIterator>::iterator_category;
+        flatset_detail::for_each_lower_bound(c_.cbegin(), c_.size(), first, last, compare_, [&](const auto&, size_t i) {
+            *out = this->begin() + static_cast<difference_type>(i);
+            ++out;
+        }, Category());
+        return out;
+    }
+
+    template<class InputIterator, class OutputIterator>
+    OutputIterator lower_bound_many(InputIterator first, InputIterator last, OutputIterator out) const {
+        using Category = typename std::iterator_traits<InputIterator>::iterator_category;
+        flatset_detail::for_each_lower_bound(c_.cbegin(), c_.size(), first, last, compare_, [&](const auto&, size_t i) {
+            *out = this->begin() + static_cast<difference_type>(i);
+            ++out;
+        }, Category());
+        return out;
+    }
+
+    // Equivalent to a loop of *out++ = find(k), but faster for large batches.
+    template<class InputIterator, class OutputIterator>
+    OutputIterator find_many(InputIterator first, InputIterator last, OutputIterator out) {
+        using Category = typename std::iterator_traits<InputIterator>::iterator_category;
+        flatset_detail::for_each_lower_bound(c_.cbegin(), c_.size(), first, last, compare_, [&](const auto& k, size_t i) {
+            bool found = (i != c_.size()) && !bool(compare_(k, c_[i]));
+            *out = found ? this->begin() + static_cast<difference_type>(i) : this->end();
+            ++out;
+        }, Category());
+        return out;
+    }
+
+    template<class InputIterator, class OutputIterator>
+    OutputIterator find_many(InputIterator first, InputIterator last, OutputIterator out) const {
+        using Category = typename std::iterator_traits<InputIterator>::iterator_category;
+        flatset_detail::for_each_lower_bound(c_.cbegin(), c_.size(), first, last, compare_, [&](const auto& k, size_t i) {
+            bool found = (i != c_.size()) && !bool(compare_(k, c_[i]));
+            *out = found ? this->begin() + static_cast<difference_type>(i) : this->end();
+            ++out;
+        }, Category());
+        return out;
+    }
+
+#if SG14_EXECUTION_POLICIES
+    // Splits a large batch across threads. Both iterators must be random-access.
+    template<class ExecutionPolicy, class RandomIt, class RandomOutputIt,
+             class = std::enable_if_t<std::is_execution_policy_v<std::decay_t<ExecutionPolicy>>>>
+    RandomOutputIt lower_bound_many(ExecutionPolicy&& policy, RandomIt first, RandomIt last, RandomOutputIt out) const {
+        size_t n = last - first;
+        flatset_detail::for_each_chunk(static_cast<ExecutionPolicy&&>(policy), n, [&](size_t lo, size_t hi) {
+            this->lower_bound_many(first + lo, first + hi, out + lo);
+        });
+        return out + n;
+    }
+
+    template<class ExecutionPolicy, class RandomIt, class RandomOutputIt,
+             class = std::enable_if_t<std::is_execution_policy_v<std::decay_t<ExecutionPolicy>>>>
+    RandomOutputIt find_many(ExecutionPolicy&& policy, RandomIt first, RandomIt last, RandomOutputIt out) const {
+        size_t n = last - first;
+        flatset_detail::for_each_chunk(static_cast<ExecutionPolicy&&>(policy), n, [&](size_t lo, size_t hi) {
+            this->find_many(first + lo, first + hi, out + lo);
+        });
+        return out + n;
+    }
+#endif // SG14_EXECUTION_POLICIES
+
     friend bool operator==(const flat_set& a, const flat_set& b) {
         return std::equal(a.begin(), a.end(), b.begin(), b.end());
     }
@@ -724,12 +1188,51 @@ public:
 #endif
 
 private:
+    bool contains_impl(const Key& k, std::false_type) const {
+        return this->find(k) != this->end();
+    }
+
+    bool contains_impl(const Key& k, std::true_type) const {
+        if (c_.size() <= 64) {
+            return flatset_detail::small_contains(c_, k);
+        }
+        return this->find(k) != this->end();
+    }
+
     void sort_and_unique_impl() {
-        std::sort(c_.begin(), c_.end(), compare_);
+        this->sort_impl(flatset_detail::is_radix_sortable<Key, Compare, KeyContainer>());
         auto it = flatset_detail::unique_helper(c_.begin(), c_.end(), compare_);
         c_.erase(it, c_.end());
     }
 
+    void sort_impl(std::false_type) {
+        std::sort(c_.begin(), c_.end(), compare_);
+    }
+
+    void sort_impl(std::true_type) {
+        size_type n = c_.size();
+        if (n < flatset_detail::radix_sort_threshold) {
+            std::sort(c_.begin(), c_.end(), compare_);
+            return;
+        }
+        const bool descending = flatset_detail::is_descending<Compare>::value;
+        std::vector<Key> scratch(n);
+        flatset_detail::radix_sort(c_.data(), scratch.data(), n, [=](Key k) { return flatset_detail::radix_bits(k, descending); });
+    }
+
+#if SG14_EXECUTION_POLICIES
+    template<class ExecutionPolicy>
+    void sort_and_unique_impl(ExecutionPolicy&& policy) {
+        std::sort(policy, c_.begin(), c_.end(), [&](const Key& a, const Key& b) {
+            return bool(compare_(a, b));
+        });
+        auto it = std::unique(policy, c_.begin(), c_.end(), [&](const Key& a, const Key& b) {
+            return !bool(compare_(a, b));
+        });
+        c_.erase(it, c_.end());
+    }
+#endif // SG14_EXECUTION_POLICIES
+
     KeyContainer c_;
     Compare compare_;
 };
@@ -37,6 +37,10 @@
  #define SG14_HIVE_RELATIONAL_OPERATORS 1
 #endif
 
+#ifndef SG14_EXECUTION_POLICIES
+ #define SG14_EXECUTION_POLICIES 0  // opt in to the std::execution overloads; this may require linking TBB
+#endif
+
 #ifndef SG14_HIVE_DEBUGGING
  #define SG14_HIVE_DEBUGGING 0
 #endif
@@ -50,8 +54,11 @@
 #include <iterator>
 #include <limits>
 #include <memory>
+#include <mutex>
+#include <new>
 #include <type_traits>
 #include <utility>
+#include <vector>
 
 #if __cplusplus >= 202002L
 #include <compare>
@@ -59,6 +66,10 @@
 #include <ranges>
 #endif // __cplusplus >= 202002L
 
+#if SG14_EXECUTION_POLICIES
+#include <execution>
+#endif
+
 #ifndef SG14_HIVE_THROW
 #include <stdexcept>
 #define SG14_HIVE_THROW(x) throw (x)
@@ -107,6 +118,37 @@ struct hive_limits {
 };
 #endif
 
+// A snapshot returned by hive::stats(). The first four fields are running counts;
+// the rest describe the hive's erased slots at the time of the call.
+struct hive_stats {
+    size_t groups_allocated = 0;
+    size_t groups_deallocated = 0;
+    size_t unused_group_reuses = 0;  // once-used groups taken back into use from the unused-groups list
+    size_t erased_slot_reuses = 0;  // elements inserted into erased slots
+    size_t erasure_list_length = 0;  // groups with erased slots, i.e. on the free list of groups
+    size_t skipblocks = 0;  // runs of erased slots; iteration makes one jump per skipblock
+    size_t skipped_slots = 0;  // the total length of those jumps
+    size_t longest_skipblock = 0;
+};
+
+// The last template parameter of hive. A hive derives privately from its stats policy,
+// which receives the running counts through add_count(). The default, none, is empty
+// and discards them; counting keeps them, and makes hive::stats() available.
+namespace hive_stats_policy {
+    struct none {
+        static constexpr bool enabled = false;
+        void add_count(size_t hive_stats::*, size_t) noexcept {}
+        hive_stats counts() const noexcept { return hive_stats(); }
+    };
+    struct counting {
+        static constexpr bool enabled = true;
+        void add_count(size_t hive_stats::*field, size_t n) noexcept { counts_.*field += n; }
+        hive_stats counts() const noexcept { return counts_; }
+    private:
+        hive_stats counts_;
+    };
+}
+
 namespace hive_priority {
     struct performance {
         using skipfield_type = unsigned short;
@@ -116,10 +158,179 @@ namespace hive_priority {
     };
 }
 
-template <class T, class allocator_type = std::allocator<T>, class priority = sg14::hive_priority::performance>
-class hive {
+// A cache of freed memory blocks, keyed by size and alignment, for hive_pool_allocator.
+// A hive allocates each group as one block whose size depends only on T and the
+// group's capacity, so a hive that churns through groups, or a stream of short-lived
+// hives, keeps asking for the same few block sizes. The pool keeps up to
+// max_blocks_per_size freed blocks of each size and hands them back out.
+class hive_group_pool {
+    struct free_block {
+        free_block *next_;
+    };
+    struct bucket {
+        size_t bytes_ = 0;
+        size_t align_ = 0;
+        size_t count_ = 0;
+        free_block *head_ = nullptr;
+    };
+    static constexpr size_t max_buckets = 32;
+
+public:
+    explicit hive_group_pool(size_t max_blocks_per_size = 64, bool synchronized = true) noexcept :
+        max_blocks_(max_blocks_per_size), synchronized_(synchronized) {}
+    hive_group_pool(const hive_group_pool&) = delete;
+    hive_group_pool& operator=(const hive_group_pool&) = delete;
+    ~hive_group_pool() { release(); }
+
+    // An unsynchronized pool for the calling thread, used by a default-constructed hive_pool_allocator.
+    static hive_group_pool& this_thread() noexcept {
+        thread_local hive_group_pool pool(64, false);
+        return pool;
+    }
+
+    void *allocate(size_t bytes, size_t align) {
+        if (free_block *p = this->locked([&]() { return this->pop(bytes, align); })) {
+            return p;
+        }
+        return ::operator new(bytes, std::align_val_t(align));
+    }
+
+    void deallocate(void *p, size_t bytes, size_t align) noexcept {
+        if (!this->locked([&]() { return this->push(p, bytes, align); })) {
+            ::operator delete(p, bytes, std::align_val_t(align));
+        }
+    }
+
+    // Frees every cached block.
+    void release() noexcept {
+        this->locked([&]() {
+            for (bucket& b : buckets_) {
+                while (free_block *p = b.head_) {
+                    b.head_ = p->next_;
+                    ::operator delete(static_cast<void*>(p), b.bytes_, std::align_val_t(b.align_));
+                }
+                b.count_ = 0;
+            }
+            return true;
+        });
+    }
+
+    size_t cached_blocks() const noexcept {
+        return const_cast<hive_group_pool*>(this)->locked([&]() {
+            size_t n = 0;
+            for (const bucket& b : buckets_) {
+                n += b.count_;
+            }
+            return n;
+        });
+    }
+
+private:
+    template<class F>
+    auto locked(F f) noexcept -> decltype(f()) {
+        if (synchronized_) {
+            std::lock_guard<std::mutex> lk(mtx_);
+            return f();
+        }
+        return f();
+    }
+
+    free_block *pop(size_t bytes, size_t align) noexcept {
+        for (bucket& b : buckets_) {
+            if (b.bytes_ == bytes && b.align_ == align && b.head_ != nullptr) {
+                b.count_ -= 1;
+                return std::exchange(b.head_, b.head_->next_);
+            }
+        }
+        return nullptr;
+    }
+
+    bool push(void *p, size_t bytes, size_t align) noexcept {
+        if (bytes < sizeof(free_block)) {
+            return false;
+        }
+        bucket *spare = nullptr;
+        for (bucket& b : buckets_) {
+            if (b.bytes_ == bytes && b.align_ == align) {
+                spare = &b;
+                break;
+            } else if (spare == nullptr && b.count_ == 0) {
+                spare = &b;
+            }
+        }
+        if (spare == nullptr || spare->count_ >= max_blocks_) {
+            return false;
+        }
+        spare->bytes_ = bytes;
+        spare->align_ = align;
+        spare->count_ += 1;
+        spare->head_ = ::new (p) free_block{spare->head_};
+        return true;
+    }
+
+    std::mutex mtx_;
+    size_t max_blocks_;
+    bool synchronized_;
+    bucket buckets_[max_buckets];
+};
+
+// An allocator that draws on a hive_group_pool: either a shared one, given at construction,
+// or else the calling thread's own one. Allocators on the same shared pool compare equal,
+// as do all default-constructed ones, so their hives may splice groups back and forth.
+template<class T>
+class hive_pool_allocator {
+public:
+    using value_type = T;
+
+    hive_pool_allocator() noexcept = default;
+    explicit hive_pool_allocator(hive_group_pool& pool) noexcept : pool_(&pool) {}
+    template<class U>
+    hive_pool_allocator(const hive_pool_allocator<U>& rhs) noexcept : pool_(rhs.pool()) {}
+
+    T *allocate(size_t n) {
+        if (n > size_t(-1) / sizeof(T)) {
+            SG14_HIVE_THROW(std::bad_array_new_length());
+        }
+        return static_cast<T*>(this->get_pool().allocate(n * sizeof(T), align()));
+    }
+
+    void deallocate(T *p, size_t n) noexcept {
+        this->get_pool().deallocate(p, n * sizeof(T), align());
+    }
+
+    // The shared pool, or null for the calling thread's pool.
+    hive_group_pool *pool() const noexcept { return pool_; }
+
+    friend bool operator==(const hive_pool_allocator& a, const hive_pool_allocator& b) noexcept { return a.pool_ == b.pool_; }
+    friend bool operator!=(const hive_pool_allocator& a, const hive_pool_allocator& b) noexcept { return a.pool_ != b.pool_; }
+
+private:
+    static constexpr size_t align() noexcept {
+        return (alignof(T) > __STDCPP_DEFAULT_NEW_ALIGNMENT__) ? alignof(T) : __STDCPP_DEFAULT_NEW_ALIGNMENT__;
+    }
+    hive_group_pool& get_pool() const noexcept { return pool_ ? *pool_ : hive_group_pool::this_thread(); }
+
+    hive_group_pool *pool_ = nullptr;
+};
+
+template<class T, class A, class P, class S> class hive;
+
+} // namespace sg14
+
+namespace std {
+
+    template<class T, class A, class P, class S, class Pred>
+    typename sg14::hive<T, A, P, S>::size_type erase_if(sg14::hive<T, A, P, S>& h, Pred pred);
+
+} // namespace std
+
+namespace sg14 {
+
+template <class T, class allocator_type = std::allocator<T>, class priority = sg14::hive_priority::performance, class stats_policy = sg14::hive_stats_policy::none>
+class hive : private stats_policy {
     template<bool IsConst> class hive_iterator;
     template<bool IsConst> class hive_reverse_iterator;
+    template<bool IsConst> class hive_block;
     friend class hive_iterator<false>;
     friend class hive_iterator<true>;
 
@@ -138,6 +349,8 @@ public:
     using const_iterator = hive_iterator<true>;
     using reverse_iterator = hive_reverse_iterator<false>;
     using const_reverse_iterator = hive_reverse_iterator<true>;
+    using block = hive_block<false>;
+    using const_block = hive_block<true>;
 
 private:
     inline auto make_value_callback(size_type, const T& value) {
@@ -720,6 +933,97 @@ private:
 #endif
     }; // hive_reverse_iterator
 
+    // A view of one of the hive's groups, for traversals that would rather walk
+    // the skipfield a block at a time than pay for hive_iterator's per-element branch.
+    // Cells [0, extent()) have been constructed into at some point; cell i holds a
+    // live element iff skipfield()[i] == 0. A skipblock of n erased cells starting
+    // at cell i has skipfield()[i] == skipfield()[i + n - 1] == n.
+    template <bool IsConst>
+    class hive_block {
+        GroupPtr group_ = GroupPtr();
+
+        friend class hive;
+        friend class hive_block<true>;
+        explicit hive_block(GroupPtr g) : group_(g) {}
+
+    public:
+        using skipfield_type = typename hive::skipfield_type;
+        using value_type = typename hive::value_type;
+        using size_type = typename hive::size_type;
+        using pointer = std::conditional_t<IsConst, typename hive::const_pointer, typename hive::pointer>;
+        using reference = std::conditional_t<IsConst, typename hive::const_reference, typename hive::reference>;
+
+        explicit hive_block() = default;
+
+        template<bool IsConst_ = IsConst, class = std::enable_if_t<IsConst_>>
+        hive_block(const hive_block<false>& rhs) : group_(rhs.group_) {}
+
+        inline size_type size() const noexcept { return group_->size; }
+        inline size_type capacity() const noexcept { return group_->capacity; }
+        inline size_type extent() const noexcept { return group_->index_of_last_endpoint(); }
+        inline bool is_packed() const noexcept { return group_->is_packed(); }
+        inline double occupancy() const noexcept { return double(group_->size) / double(group_->capacity); }
+        inline const skipfield_type *skipfield() const noexcept { return cast_pointer<const skipfield_type*>(group_->addr_of_skipfield(0)); }
+        inline bool is_live(size_type i) const noexcept { return i < extent() && group_->skipfield(i) == 0; }
+
+        // Cell i, which must be live.
+        inline reference operator[](size_type i) const noexcept { return *group_->element(i).t(); }
+
+        // Whether a run of adjacent live cells is also a contiguous array of T.
+        // It isn't when T is smaller than the free-list links that erased cells hold,
+        // because then each cell is padded out to the size of the links.
+        static constexpr bool has_contiguous_runs = (sizeof(overaligned_elt) == sizeof(T));
+
+        // Calls f(lo, hi) for each maximal run [lo, hi) of live cells, in order.
+        template<class F>
+        void for_each_index_run(F f) const {
+            GroupPtr g = group_;
+            if (g->is_packed()) {
+                // No erasures: the whole group is one run, and there's no skipfield to read.
+                if (g->size != 0) {
+                    f(size_type(0), size_type(g->size));
+                }
+                return;
+            }
+            const skipfield_type *sf = this->skipfield();
+            size_type end = g->index_of_last_endpoint();
+            size_type i = sf[0];
+            while (i < end) {
+                size_type j = std::find_if(sf + i + 1, sf + end, [](skipfield_type x) { return x != 0; }) - sf;
+                f(i, j);
+                i = j + sf[j];
+            }
+        }
+
+        // Calls f(p, n) for each maximal run of n live elements starting at p, in order.
+        // If has_contiguous_runs, the elements are p[0] through p[n-1];
+        // otherwise each element is reported as a run of its own.
+        template<class F>
+        void for_each_run(F f) const {
+            using Ptr = std::conditional_t<IsConst, const T*, T*>;
+            GroupPtr g = group_;
+            this->for_each_index_run([&](size_type lo, size_type hi) {
+                if constexpr (has_contiguous_runs) {
+                    f(Ptr(std::addressof(*g->element(lo).t())), hi - lo);
+                } else {
+                    for (size_type i = lo; i != hi; ++i) {
+                        f(Ptr(std::addressof(*g->element(i).t())), size_type(1));
+                    }
+                }
+            });
+        }
+
+        // Calls f(x) for every live element x, one run of adjacent cells at a time.
+        template<class F>
+        void for_each(F&& f) const {
+            this->for_each_run([&](auto p, size_type n) {
+                for (size_type i = 0; i != n; ++i) {
+                    f(static_cast<reference>(p[i]));
+                }
+            });
+        }
+    }; // hive_block
+
 public:
     void assert_invariants() const {
 #if SG14_HIVE_DEBUGGING
@@ -790,6 +1094,8 @@ public:
                 skipfield_type skipblock_length = g->skipfield(sb);
                 assert(skipblock_length != 0);
                 assert(g->skipfield(sb + skipblock_length - 1) == skipblock_length);
+                assert(sb == 0 || g->skipfield(sb - 1) == 0);  // adjacent skipblocks must be merged
+                assert(g->skipfield(sb + skipblock_length) == 0);
                 total_skipped += skipblock_length;
                 if (sb == g->free_list_head) {
                     assert(g->element(sb).s_.prevlink_ == std::numeric_limits<skipfield_type>::max());
@@ -870,6 +1176,24 @@ public:
 #endif // SG14_HIVE_DEBUGGING
     }
 
+    // The counters are per-hive: a copy starts from zero, while a move or
+    // swap carries them along with the groups. A group spliced in from another
+    // hive was counted as allocated by that hive. O(number of skipblocks) time.
+    sg14::hive_stats stats() const {
+        static_assert(stats_policy::enabled, "hive::stats() requires a counting stats policy, such as sg14::hive_stats_policy::counting");
+        sg14::hive_stats result = this->counts();
+        for (GroupPtr g = groups_with_erasures_; g != nullptr; g = g->next_erasure_) {
+            result.erasure_list_length += 1;
+            for (skipfield_type sb = g->free_list_head; sb != std::numeric_limits<skipfield_type>::max(); sb = g->element(sb).s_.nextlink_) {
+                size_t n = g->skipfield(sb);
+                result.skipblocks += 1;
+                result.skipped_slots += n;
+                result.longest_skipblock = (std::max)(result.longest_skipblock, n);
+            }
+        }
+        return result;
+    }
+
 private:
     iterator end_;
     iterator begin_;
@@ -962,6 +1286,7 @@ public:
 #endif
 
     hive(hive&& source) noexcept :
+        stats_policy(static_cast<const stats_policy&>(source)),
         end_(std::move(source.end_)),
         begin_(std::move(source.begin_)),
         groups_with_erasures_(std::move(source.groups_with_erasures_)),
@@ -1150,21 +1475,31 @@ private:
         GroupPtr g = GroupAllocHelper::allocate_group(get_allocator(), cap);
         unused_groups_push_front(g);
         capacity_ += cap;
+        this->add_count(&sg14::hive_stats::groups_allocated, 1);
     }
 
     inline void deallocate_group(GroupPtr g) {
         GroupAllocHelper::deallocate_group(get_allocator(), g);
+        this->add_count(&sg14::hive_stats::groups_deallocated, 1);
     }
 
     void unspecialcase_end_group(GroupPtr g) {
         assert(g == end_.group_);
         size_type trailing = g->end_of_elements() - g->last_endpoint;
         size_type sb = g->capacity - trailing;
-        if (trailing != 0) {
+        if (trailing != 0 && sb != 0 && g->skipfield(sb - 1) != 0) {
+            // Extend the skipblock that ends at the last endpoint; it's already on the free list.
+            size_type preceding = g->skipfield(sb - 1);
+            g->skipfield(sb - preceding) = preceding + trailing;
+            g->skipfield(g->capacity - 1) = preceding + trailing;
+            g->last_endpoint = g->end_of_elements();
+        } else if (trailing != 0) {
             g->skipfield(sb) = trailing;
             g->skipfield(g->capacity - 1) = trailing;
             if (g->free_list_head == std::numeric_limits<skipfield_type>::max()) {
                 g->next_erasure_ = std::exchange(groups_with_erasures_, g);
+            } else {
+                g->element(g->free_list_head).s_.prevlink_ = sb;
             }
             g->element(sb).s_.nextlink_ = std::exchange(g->free_list_head, sb);
             g->element(sb).s_.prevlink_ = std::numeric_limits<skipfield_type>::max();
@@ -1203,6 +1538,13 @@ private:
                 deallocate_group(g);
                 g = next;
             }
+        } else {
+            // An empty hive may still hold reserved (or once-used) groups.
+            for (GroupPtr g = unused_groups_; g != nullptr; ) {
+                GroupPtr next = g->next_group;
+                deallocate_group(g);
+                g = next;
+            }
         }
     }
 
@@ -1236,6 +1578,7 @@ public:
             });
             g->size += 1;
             size_ += 1;
+            this->add_count(&sg14::hive_stats::erased_slot_reuses, 1);
             if (g == begin_.group_ && sb == 0) {
                 begin_ = result;
             }
@@ -1267,6 +1610,7 @@ public:
             }
             GroupPtr g = unused_groups_;
             std::allocator_traits<allocator_type>::construct(ea, g->element(0).t(), static_cast<Args&&>(args)...);
+            this->add_count(&sg14::hive_stats::unused_group_reuses, g->last_endpoint != g->addr_of_element(0));
             (void)unused_groups_pop_front();
             std::fill_n(g->addr_of_skipfield(0), g->capacity, skipfield_type());
             g->size = 1;
@@ -1684,6 +2028,7 @@ public:
         swap(min_group_capacity_, source.min_group_capacity_);
         swap(max_group_capacity_, source.max_group_capacity_);
 #endif
+        swap(static_cast<stats_policy&>(*this), static_cast<stats_policy&>(source));
         if constexpr (std::allocator_traits<allocator_type>::propagate_on_container_swap::value && !std::allocator_traits<allocator_type>::is_always_equal::value) {
             swap(allocator_, source.allocator_);
         }
@@ -1809,6 +2154,7 @@ private:
             skipfield_type nadded = p - d_first;
             g->size += nadded;
             size_ += nadded;
+            this->add_count(&sg14::hive_stats::erased_slot_reuses, nadded);
             if (nadded != 0 && d_first == begin_.group_->addr_of_element(0)) {
                 begin_ = iterator(g, 0);
             }
@@ -1873,6 +2219,7 @@ private:
         }, [&]() {
             skipfield_type nadded = p - d_first;
             if (nadded != 0) {
+                this->add_count(&sg14::hive_stats::unused_group_reuses, g->last_endpoint != g->addr_of_element(0));
                 (void)unused_groups_pop_front();
                 std::fill_n(g->addr_of_skipfield(0), g->capacity, skipfield_type());
                 g->free_list_head = std::numeric_limits<skipfield_type>::max();
@@ -2022,6 +2369,18 @@ private:
         end_ = begin_;
     }
 
+    // Frees the groups of a hive used as scratch space by this one,
+    // and adds its counters to ours.
+    void absorb_scratch_hive(hive& scratch) noexcept {
+        scratch.destroy_all_data();
+        scratch.blank();
+        sg14::hive_stats counts = scratch.counts();
+        this->add_count(&sg14::hive_stats::groups_allocated, counts.groups_allocated);
+        this->add_count(&sg14::hive_stats::groups_deallocated, counts.groups_deallocated);
+        this->add_count(&sg14::hive_stats::unused_group_reuses, counts.unused_group_reuses);
+        this->add_count(&sg14::hive_stats::erased_slot_reuses, counts.erased_slot_reuses);
+    }
+
     inline void unused_groups_push_front(GroupPtr g) {
         g->next_group = std::exchange(unused_groups_, g);
         if (unused_groups_tail_ == nullptr) {
@@ -2078,6 +2437,37 @@ public:
     inline const_reverse_iterator crbegin() const noexcept { return const_reverse_iterator(end_); }
     inline const_reverse_iterator crend() const noexcept { return const_reverse_iterator(begin_); }
 
+    // Calls f(b) for the block b of each group that holds elements, in iteration order.
+    template<class F>
+    void for_each_block(F f) {
+        if (size_ != 0) {
+            for (GroupPtr g = begin_.group_; g != nullptr; g = g->next_group) {
+                f(block(g));
+            }
+        }
+    }
+
+    template<class F>
+    void for_each_block(F f) const {
+        if (size_ != 0) {
+            for (GroupPtr g = begin_.group_; g != nullptr; g = g->next_group) {
+                f(const_block(g));
+            }
+        }
+    }
+
+    // Calls f(p, n) for each maximal run of live elements, in iteration order;
+    // see hive::block::for_each_run.
+    template<class F>
+    void for_each_run(F f) {
+        this->for_each_block([&](const block& b) { b.for_each_run(f); });
+    }
+
+    template<class F>
+    void for_each_run(F f) const {
+        this->for_each_block([&](const const_block& b) { b.for_each_run(f); });
+    }
+
     [[nodiscard]] inline bool empty() const noexcept { return size_ == 0; }
     inline size_type size() const noexcept { return size_; }
     inline size_type max_size() const noexcept { return std::allocator_traits<allocator_type>::max_size(get_allocator()); }
@@ -2221,6 +2611,7 @@ public:
             }, [&]() {
                 this->splice(other);
             });
+            absorb_scratch_hive(other);
             return true;
         }
     }
@@ -2236,6 +2627,7 @@ public:
                 hive temp(limits, get_allocator());
                 temp.range_assign_impl(std::make_move_iterator(begin()), std::make_move_iterator(end()));
                 this->swap(temp);
+                absorb_scratch_hive(temp);
                 return;
             }
         }
@@ -2299,6 +2691,7 @@ public:
                 min_group_capacity_ = source.min_group_capacity_;
                 max_group_capacity_ = source.max_group_capacity_;
 #endif
+                static_cast<stats_policy&>(*this) = static_cast<const stats_policy&>(source);
                 if constexpr (std::allocator_traits<allocator_type>::propagate_on_container_move_assignment::value) {
                     allocator_ = std::move(source.allocator_);
                 }
@@ -2357,6 +2750,7 @@ public:
                 this->splice(other);
             });
         }
+        absorb_scratch_hive(other);
     }
 
     void trim_capacity() noexcept {
@@ -2380,54 +2774,150 @@ public:
     }
 
 private:
-    struct item_index_tuple {
-        pointer original_location;
-        size_type original_index;
-
-        explicit item_index_tuple(pointer _item, size_type _index) :
-            original_location(_item),
-            original_index(_index)
-        {}
+    // sort() permutes the values among the live cells, without moving any cell.
+    // It sees the hive through sort_iterator, a random-access iterator that finds
+    // the r'th value by its group and its rank k within that group. The k'th value
+    // of a packed group is in cell k; other groups keep a table of their live cells,
+    // at sizeof(skipfield_type) per value.
+    struct sort_group {
+        GroupPtr g_;
+        size_type first_;  // the rank of g_'s first value in the hive
+        const skipfield_type *cells_;  // null if g_ is packed
     };
 
-public:
-    template <class Comp>
-    void sort(Comp less) {
-        if (size_ <= 1) {
-            return;
+    class sort_iterator {
+    public:
+        using iterator_category = std::random_access_iterator_tag;
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+        using pointer = T*;
+        using reference = T&;
+
+        explicit sort_iterator() = default;
+        explicit sort_iterator(const sort_group *tab, const sort_group *last, size_type r) :
+            tab_(tab), last_(last), cur_(tab), r_(r) { seek(); }
+
+        T& operator*() const {
+            size_type k = r_ - cur_->first_;
+            return *cur_->g_->element(cur_->cells_ ? cur_->cells_[k] : k).t();
         }
+        T *operator->() const { return std::addressof(**this); }
+        T& operator[](difference_type n) const { return *(*this + n); }
 
-        struct ItemT {
-            T *ptr_;
-            size_type idx_;
-        };
+        sort_iterator& operator++() {
+            r_ += 1;
+            if (r_ == cur_[1].first_) {
+                ++cur_;
+            }
+            return *this;
+        }
+        sort_iterator& operator--() {
+            if (r_ == cur_->first_) {
+                --cur_;
+            }
+            r_ -= 1;
+            return *this;
+        }
+        sort_iterator operator++(int) { auto copy = *this; ++*this; return copy; }
+        sort_iterator operator--(int) { auto copy = *this; --*this; return copy; }
+        sort_iterator& operator+=(difference_type n) { r_ += n; seek(); return *this; }
+        sort_iterator& operator-=(difference_type n) { r_ -= n; seek(); return *this; }
 
-        std::unique_ptr<ItemT[]> a = std::make_unique<ItemT[]>(size_);
-        auto it = begin_;
-        for (size_type i = 0; i < size_; ++i) {
-            a[i] = ItemT{std::addressof(*it), i};
-            ++it;
+        friend sort_iterator operator+(sort_iterator it, difference_type n) { it += n; return it; }
+        friend sort_iterator operator+(difference_type n, sort_iterator it) { it += n; return it; }
+        friend sort_iterator operator-(sort_iterator it, difference_type n) { it -= n; return it; }
+        friend difference_type operator-(const sort_iterator& a, const sort_iterator& b) {
+            return difference_type(a.r_) - difference_type(b.r_);
         }
-        assert(it == end_);
-        std::sort(a.get(), a.get() + size_, [&](const ItemT& a, const ItemT& b) { return less(*a.ptr_, *b.ptr_); });
+        friend bool operator==(const sort_iterator& a, const sort_iterator& b) { return a.r_ == b.r_; }
+        friend bool operator!=(const sort_iterator& a, const sort_iterator& b) { return a.r_ != b.r_; }
+        friend bool operator<(const sort_iterator& a, const sort_iterator& b) { return a.r_ < b.r_; }
+        friend bool operator>(const sort_iterator& a, const sort_iterator& b) { return a.r_ > b.r_; }
+        friend bool operator<=(const sort_iterator& a, const sort_iterator& b) { return a.r_ <= b.r_; }
+        friend bool operator>=(const sort_iterator& a, const sort_iterator& b) { return a.r_ >= b.r_; }
 
-        for (size_type i = 0; i < size_; ++i) {
-            size_type src = a[i].idx_;
-            size_type dest = i;
-            if (src != dest) {
-                T temp = std::move(*a[i].ptr_);
-                do {
-                    *a[dest].ptr_ = std::move(*a[src].ptr_);
-                    dest = src;
-                    src = a[dest].idx_;
-                    a[dest].idx_ = dest;
-                } while (src != i);
-                *a[dest].ptr_ = std::move(temp);
+    private:
+        void seek() {
+            if (cur_ == last_ || r_ < cur_->first_ || r_ >= cur_[1].first_) {
+                if (r_ >= last_->first_) {
+                    cur_ = last_;
+                } else {
+                    cur_ = std::upper_bound(tab_, last_, r_, [](size_type r, const sort_group& sg) { return r < sg.first_; }) - 1;
+                }
+            }
+        }
+
+        const sort_group *tab_ = nullptr;
+        const sort_group *last_ = nullptr;  // the sentinel, whose first_ is the hive's size
+        const sort_group *cur_ = nullptr;
+        size_type r_ = 0;
+    };
+
+    template<class Sort>
+    void sort_impl(Sort do_sort) {
+        if (size_ <= 1) {
+            return;
+        }
+        std::vector<sort_group> groups;
+        std::vector<skipfield_type> cells;
+        for (GroupPtr g = begin_.group_; g != nullptr; g = g->next_group) {
+            groups.push_back(sort_group{g, 0, nullptr});
+            if (!g->is_packed()) {
+                cells.reserve(cells.size() + g->size);
+                block(g).for_each_index_run([&](size_type lo, size_type hi) {
+                    for (size_type i = lo; i != hi; ++i) {
+                        cells.push_back(skipfield_type(i));
+                    }
+                });
             }
         }
+        size_type first = 0;
+        size_type c = 0;
+        for (sort_group& sg : groups) {
+            sg.first_ = first;
+            if (!sg.g_->is_packed()) {
+                sg.cells_ = cells.data() + c;
+                c += sg.g_->size;
+            }
+            first += sg.g_->size;
+        }
+        assert(first == size_ && c == cells.size());
+        groups.push_back(sort_group{nullptr, size_, nullptr});
+
+        const sort_group *tab = groups.data();
+        const sort_group *last = tab + groups.size() - 1;
+        do_sort(sort_iterator(tab, last, 0), sort_iterator(tab, last, size_));
         assert_invariants();
     }
 
+public:
+    // Sorts the values in place; no iterator is invalidated, but each may now point
+    // to a different value. The only scratch memory is a few words per group,
+    // plus sizeof(skipfield_type) per value in a group that has had erasures.
+    template <class Comp>
+    void sort(Comp less) {
+        if (size_ <= 1) {
+            return;
+        } else if (begin_.group_ == end_.group_ && begin_.group_->is_packed() && block::has_contiguous_runs) {
+            T *p = std::addressof(*begin_);
+            std::sort(p, p + size_, std::ref(less));
+            return;
+        }
+        this->sort_impl([&](sort_iterator first, sort_iterator last) {
+            std::sort(first, last, std::ref(less));
+        });
+    }
+
+#if SG14_EXECUTION_POLICIES
+    template<class ExecutionPolicy, class Comp,
+             class = std::enable_if_t<std::is_execution_policy_v<std::decay_t<ExecutionPolicy>>>>
+    void sort(ExecutionPolicy&& policy, Comp less) {
+        this->sort_impl([&](sort_iterator first, sort_iterator last) {
+            std::sort(std::forward<ExecutionPolicy>(policy), first, last, less);
+        });
+    }
+#endif
+
     inline void sort() { sort(std::less<T>()); }
 
     template<class Comp>
@@ -2458,39 +2948,252 @@ public:
     }
 
     inline size_type unique() { return unique(std::equal_to<T>()); }
-};
 
-} // namespace sg14
+    // Moves up to max_moves elements out of the sparsest groups into holes in the others,
+    // so that the emptied groups become unused capacity (which trim_capacity() can release).
+    // Each move calls on_move(from, to) after *to has been move-constructed from *from
+    // and *from has been erased, so that if on_move throws, the element exists only at *to;
+    // from is then just the old address, for fixing up handles. Only iterators to the moved
+    // elements are invalidated.
+    // A group is compacted only if the rest of the hive has room for all of its elements.
+    // Returns the number of elements moved.
+    template<class F>
+    size_type compact(size_type max_moves, F on_move) {
+        size_type moves = 0;
+        while (moves < max_moves && begin_.group_ != end_.group_) {
+            GroupPtr src = begin_.group_;
+            size_type total_free = 0;
+            for (GroupPtr g = begin_.group_; g != nullptr; g = g->next_group) {
+                total_free += g->capacity - g->size;
+                if (size_type(g->size) * src->capacity < size_type(src->size) * g->capacity) {
+                    src = g;
+                }
+            }
+            if (src->size == 0 || src->size == src->capacity || total_free - (src->capacity - src->size) < src->size) {
+                break;
+            }
+            if (src == end_.group_) {
+                // Its trailing capacity mustn't be used for the moves; make it a skipblock.
+                unspecialcase_end_group(src);
+                end_.idx_ = src->capacity;
+            }
+            while (src->size != 0 && moves < max_moves) {
+                if (groups_with_erasures_ == src && src->next_erasure_ != nullptr) {
+                    // emplace() takes from the head of the list; let it take from another group.
+                    GroupPtr g = src->next_erasure_;
+                    src->next_erasure_ = std::exchange(g->next_erasure_, src);
+                    groups_with_erasures_ = g;
+                }
+                assert(trailing_capacity() != 0 || groups_with_erasures_ != src);
+                iterator from = iterator(src, src->skipfield(0));
+                T *old = std::addressof(*from);
+                iterator to = this->emplace(std::move(*from));
+                this->erase(from);
+                moves += 1;
+                on_move(old, std::addressof(*to));
+            }
+        }
+        assert_invariants();
+        return moves;
+    }
 
-namespace std {
+    inline size_type compact(size_type max_moves) {
+        return compact(max_moves, [](T*, T*) {});
+    }
 
-    template<class T, class A, class P, class Pred>
-    typename sg14::hive<T, A, P>::size_type erase_if(sg14::hive<T, A, P>& h, Pred pred) {
-        typename sg14::hive<T, A, P>::size_type count = 0;
-        auto end = h.end();
-        for (auto it = h.begin(); it != end; ++it) {
-            if (pred(*it)) {
-                auto orig = ++count;
-                auto last = it;
-                while (++last != end && pred(*last)) {
-                    ++count;
+private:
+    template<class T2, class A2, class P2, class S2, class Pred>
+    friend typename sg14::hive<T2, A2, P2, S2>::size_type std::erase_if(sg14::hive<T2, A2, P2, S2>&, Pred);
+
+    // The implementation of std::erase_if. It culls one group at a time, in a single pass
+    // that destroys the doomed elements and rebuilds the group's skipblocks and free list
+    // as it goes. Groups left empty are moved to unused_groups_, and the list of groups
+    // with erasures is rebuilt once at the end.
+    template<class Pred>
+    size_type impl_erase_if(Pred pred) {
+        // If pred throws, this puts the group it was culling back in order.
+        struct finisher {
+            hive *h_;
+            GroupPtr g_ = nullptr;  // the group being culled
+            size_type erased_ = 0;  // the number of elements culled from g_ so far
+            ~finisher() {
+                if (g_ != nullptr) {
+                    h_->erase_if_rebuild_group(g_);
+                    h_->erase_if_finish_group(g_, erased_);
                 }
-                if (count != orig) {
-                    it = h.erase(it, last);
-                } else {
-                    it = h.erase(it);
+                h_->erase_if_relink();
+            }
+        };
+
+        allocator_type ea = get_allocator();
+        size_type count = 0;
+        finisher fin = {this};
+        GroupPtr next = begin_.group_;
+        while (GroupPtr g = next) {
+            next = g->next_group;
+            fin.g_ = g;
+            fin.erased_ = 0;
+            skipfield_type *sf = cast_pointer<skipfield_type*>(g->addr_of_skipfield(0));
+            overaligned_elt *elts = cast_pointer<overaligned_elt*>(g->addr_of_element(0));
+            size_type end = g->index_of_last_endpoint();
+            skipfield_type head = std::numeric_limits<skipfield_type>::max();
+            size_type run = end;  // the start of the current run of dead cells, if any
+            auto close_run = [&](size_type j) {
+                skipfield_type n = static_cast<skipfield_type>(j - run);
+                sf[run] = n;
+                sf[j - 1] = n;
+                if (head != std::numeric_limits<skipfield_type>::max()) {
+                    elts[head].s_.prevlink_ = static_cast<skipfield_type>(run);
                 }
-                end = h.end();
-                if (it == end) {
-                    break;
+                elts[run].s_.nextlink_ = head;
+                elts[run].s_.prevlink_ = std::numeric_limits<skipfield_type>::max();
+                head = static_cast<skipfield_type>(run);
+                run = end;
+            };
+            for (size_type i = 0; i < end; ) {
+                if (sf[i] != 0) {
+                    // An old skipblock.
+                    run = (run == end) ? i : run;
+                    i += sf[i];
+                } else if (pred(elts[i].t_)) {
+                    if constexpr (!std::is_trivially_destructible<T>::value) {
+                        std::allocator_traits<allocator_type>::destroy(ea, std::addressof(elts[i].t_));
+                    }
+                    sf[i] = 1;
+                    fin.erased_ += 1;
+                    run = (run == end) ? i : run;
+                    i += 1;
+                } else {
+                    if (run != end) {
+                        close_run(i);
+                    }
+                    i += 1;
                 }
             }
+            if (run != end) {
+                close_run(end);
+            }
+            g->free_list_head = head;
+            fin.g_ = nullptr;
+            count += fin.erased_;
+            this->erase_if_finish_group(g, fin.erased_);
         }
         return count;
     }
 
-    template<class T, class A, class P>
-    inline typename sg14::hive<T, A, P>::size_type erase(sg14::hive<T, A, P>& h, const T& value) {
+    // Each cell in [0, index_of_last_endpoint()) of g is live, with a skipfield of 0, or else
+    // the start node of a skipblock (perhaps a single culled cell), whose skipfield is its
+    // length; the interior nodes may hold anything, even 0. Rebuild g's skipblocks and
+    // free list, merging adjacent skipblocks, by walking from start node to start node.
+    void erase_if_rebuild_group(GroupPtr g) {
+        const skipfield_type *sf = block(g).skipfield();
+        size_type end = g->index_of_last_endpoint();
+        g->free_list_head = std::numeric_limits<skipfield_type>::max();
+        for (size_type i = 0; i < end; ) {
+            if (sf[i] == 0) {
+                i += 1;
+                continue;
+            }
+            size_type j = i;
+            while (j < end && sf[j] != 0) {
+                j += sf[j];
+            }
+            skipfield_type n = static_cast<skipfield_type>(j - i);
+            g->skipfield(i) = n;
+            g->skipfield(j - 1) = n;
+            if (!g->is_packed()) {
+                g->element(g->free_list_head).s_.prevlink_ = static_cast<skipfield_type>(i);
+            }
+            g->element(i).s_.nextlink_ = g->free_list_head;
+            g->element(i).s_.prevlink_ = std::numeric_limits<skipfield_type>::max();
+            g->free_list_head = static_cast<skipfield_type>(i);
+            i = j;
+        }
+    }
+
+    // Accounts for the elements just culled from g; if g is now empty,
+    // unlinks it and moves it to unused_groups_.
+    void erase_if_finish_group(GroupPtr g, size_type erased) {
+        g->size -= static_cast<skipfield_type>(erased);
+        size_ -= erased;
+        if (g->size == 0) {
+            if (g->prev_group != nullptr) {
+                g->prev_group->next_group = g->next_group;
+            } else {
+                begin_.group_ = g->next_group;
+            }
+            if (g->next_group != nullptr) {
+                g->next_group->prev_group = g->prev_group;
+            } else {
+                end_.group_ = g->prev_group;
+            }
+            unused_groups_push_front(g);
+        }
+    }
+
+    void erase_if_relink() {
+        groups_with_erasures_ = nullptr;
+        if (begin_.group_ == nullptr) {
+            begin_ = iterator();
+            end_ = iterator();
+            return;
+        }
+        for (GroupPtr g = begin_.group_; g != nullptr; g = g->next_group) {
+            if (!g->is_packed()) {
+                g->next_erasure_ = std::exchange(groups_with_erasures_, g);
+            }
+        }
+        begin_ = iterator(begin_.group_, begin_.group_->skipfield(0));
+        end_ = iterator(end_.group_, end_.group_->index_of_last_endpoint());
+        assert_invariants();
+    }
+};
+
+// Calls f(x) for every element of the hive, walking each group's skipfield
+// directly rather than through hive_iterator.
+template<class T, class A, class P, class S, class F>
+F for_each(hive<T, A, P, S>& h, F f) {
+    h.for_each_block([&](const auto& b) { b.for_each(f); });
+    return f;
+}
+
+template<class T, class A, class P, class S, class F>
+F for_each(const hive<T, A, P, S>& h, F f) {
+    h.for_each_block([&](const auto& b) { b.for_each(f); });
+    return f;
+}
+
+#if SG14_EXECUTION_POLICIES
+// Hands whole groups to the policy's workers; f may be called concurrently
+// on elements of different groups.
+template<class ExecutionPolicy, class T, class A, class P, class S, class F,
+         class = std::enable_if_t<std::is_execution_policy_v<std::decay_t<ExecutionPolicy>>>>
+void for_each(ExecutionPolicy&& policy, hive<T, A, P, S>& h, F f) {
+    std::vector<typename hive<T, A, P, S>::block> blocks;
+    h.for_each_block([&](const auto& b) { blocks.push_back(b); });
+    std::for_each(std::forward<ExecutionPolicy>(policy), blocks.begin(), blocks.end(), [&](const auto& b) { b.for_each(f); });
+}
+
+template<class ExecutionPolicy, class T, class A, class P, class S, class F,
+         class = std::enable_if_t<std::is_execution_policy_v<std::decay_t<ExecutionPolicy>>>>
+void for_each(ExecutionPolicy&& policy, const hive<T, A, P, S>& h, F f) {
+    std::vector<typename hive<T, A, P, S>::const_block> blocks;
+    h.for_each_block([&](const auto& b) { blocks.push_back(b); });
+    std::for_each(std::forward<ExecutionPolicy>(policy), blocks.begin(), blocks.end(), [&](const auto& b) { b.for_each(f); });
+}
+#endif // SG14_EXECUTION_POLICIES
+
+} // namespace sg14
+
+namespace std {
+
+    template<class T, class A, class P, class S, class Pred>
+    typename sg14::hive<T, A, P, S>::size_type erase_if(sg14::hive<T, A, P, S>& h, Pred pred) {
+        return h.impl_erase_if(std::move(pred));
+    }
+
+    template<class T, class A, class P, class S>
+    inline typename sg14::hive<T, A, P, S>::size_type erase(sg14::hive<T, A, P, S>& h, const T& value) {
         return std::erase_if(h, [&](const T &x) { return x == value; });
     }
 } // namespace std
@@ -27,7 +27,9 @@
 #pragma once
 
 #include <stddef.h>
+#include <string.h>
 #include <functional>
+#include <memory>
 #include <type_traits>
 #include <utility>
 
@@ -35,6 +37,10 @@
 #define SG14_INPLACE_FUNCTION_THROW(x) throw (x)
 #endif
 
+#ifndef SG14_INPLACE_FUNCTION_INLINE_INVOKER
+ #define SG14_INPLACE_FUNCTION_INLINE_INVOKER 0  // keep a copy of invoke_ptr in each object, saving a load per call
+#endif
+
 namespace sg14 {
 
 namespace inplace_function_detail {
@@ -82,6 +88,77 @@ template<class T> struct wrapper
     using type = T;
 };
 
+// A callable too large for the inplace storage, moved out to memory from a
+// caller-supplied allocator (typically an arena or pool). The box itself
+// holds only the allocator and a pointer, and is what the inplace storage holds.
+template<class C, class Alloc>
+class spill_box
+{
+    using traits = typename std::allocator_traits<Alloc>::template rebind_traits<C>;
+    using alloc_t = typename traits::allocator_type;
+    using pointer = typename traits::pointer;
+
+public:
+    template<class T>
+    explicit spill_box(const Alloc& alloc, T&& closure) :
+        alloc_(alloc),
+        ptr_(make(std::forward<T>(closure)))
+    {}
+
+    spill_box(const spill_box& other) :
+        alloc_(traits::select_on_container_copy_construction(other.alloc_)),
+        ptr_(make(*other.ptr_))
+    {}
+
+    spill_box(spill_box&& other) noexcept :
+        alloc_(std::move(other.alloc_)),
+        ptr_(other.ptr_)
+    {
+        other.ptr_ = nullptr;
+    }
+
+    spill_box& operator= (const spill_box&) = delete;
+    spill_box& operator= (spill_box&&) = delete;
+
+    ~spill_box()
+    {
+        if (ptr_ != nullptr) {
+            traits::destroy(alloc_, std::addressof(*ptr_));
+            traits::deallocate(alloc_, ptr_, 1);
+        }
+    }
+
+    template<class... As>
+    decltype(auto) operator() (As&&... args)
+    {
+        return (*ptr_)(std::forward<As>(args)...);
+    }
+
+private:
+    template<class T>
+    pointer make(T&& closure)
+    {
+        pointer p = traits::allocate(alloc_, 1);
+        try {
+            traits::construct(alloc_, std::addressof(*p), std::forward<T>(closure));
+        } catch (...) {
+            traits::deallocate(alloc_, p, 1);
+            throw;
+        }
+        return p;
+    }
+
+    alloc_t alloc_;
+    pointer ptr_;
+};
+
+template<class C> struct is_spill_box : std::false_type {};
+template<class C, class Alloc> struct is_spill_box<spill_box<C, Alloc>> : std::true_type {};
+
+// spill_box always declares a copy constructor, but it can only use it if C has one.
+template<class C> struct is_copyable_callable : std::is_copy_constructible<C> {};
+template<class C, class Alloc> struct is_copyable_callable<spill_box<C, Alloc>> : std::is_copy_constructible<C> {};
+
 template<class R, class... Args> struct vtable
 {
     using storage_ptr_t = void*;
@@ -94,6 +171,8 @@ template<class R, class... Args> struct vtable
     const process_ptr_t copy_ptr;
     const process_ptr_t relocate_ptr;
     const destructor_ptr_t destructor_ptr;
+    const bool is_trivial;  // copy and relocate are memcpy, and destructor is a no-op
+    const bool is_spilled;  // the callable lives outside the inplace storage
 
     constexpr explicit vtable() noexcept :
         invoke_ptr( [](storage_ptr_t, Args&&...) -> R
@@ -101,18 +180,14 @@ template<class R, class... Args> struct vtable
         ),
         copy_ptr( [](storage_ptr_t, storage_ptr_t) {} ),
         relocate_ptr( [](storage_ptr_t, storage_ptr_t) {} ),
-        destructor_ptr( [](storage_ptr_t) {} )
+        destructor_ptr( [](storage_ptr_t) {} ),
+        is_trivial( true ),
+        is_spilled( false )
     {}
 
     template<class C> constexpr explicit vtable(wrapper<C>) noexcept :
-        invoke_ptr( [](storage_ptr_t storage_ptr, Args&&... args) -> R
-            { return (*static_cast<C*>(storage_ptr))(
-                static_cast<Args&&>(args)...
-            ); }
-        ),
-        copy_ptr( [](storage_ptr_t dst_ptr, storage_ptr_t src_ptr)
-            { ::new (dst_ptr) C{ (*static_cast<C*>(src_ptr)) }; }
-        ),
+        invoke_ptr( &invoke_callable<C> ),
+        copy_ptr( copy_ptr_for<C>(is_copyable_callable<C>{}) ),
         relocate_ptr( [](storage_ptr_t dst_ptr, storage_ptr_t src_ptr)
             {
                 ::new (dst_ptr) C{ std::move(*static_cast<C*>(src_ptr)) };
@@ -121,9 +196,28 @@ template<class R, class... Args> struct vtable
         ),
         destructor_ptr( [](storage_ptr_t src_ptr)
             { static_cast<C*>(src_ptr)->~C(); }
-        )
+        ),
+        is_trivial( std::is_trivially_copyable<C>::value ),
+        is_spilled( is_spill_box<C>::value )
     {}
 
+    // Also used by inplace_function_ref, whose C may be neither copyable nor movable.
+    template<class C> static R invoke_callable(storage_ptr_t storage_ptr, Args&&... args)
+    {
+        return (*static_cast<C*>(storage_ptr))(
+            static_cast<Args&&>(args)...
+        );
+    }
+
+    template<class C> static void copy_callable(storage_ptr_t dst_ptr, storage_ptr_t src_ptr)
+    {
+        ::new (dst_ptr) C{ (*static_cast<C*>(src_ptr)) };
+    }
+
+    // A move-only callable gets no copy_ptr; only inplace_move_only_function can hold one.
+    template<class C> static constexpr process_ptr_t copy_ptr_for(std::true_type) { return &copy_callable<C>; }
+    template<class C> static constexpr process_ptr_t copy_ptr_for(std::false_type) { return nullptr; }
+
     vtable(const vtable&) = delete;
     vtable(vtable&&) = delete;
 
@@ -184,6 +278,244 @@ template<class R, class F, class... Args> using is_invocable_r = is_invocable_r_
     F,
     Args...
 >;
+
+// The storage and vtable handling shared by inplace_function and inplace_move_only_function.
+// The two differ only in their copy operations, and so in whether the callables they
+// hold must be copyable (Copyable) or only nothrow-movable.
+template<class Signature, size_t Capacity, size_t Alignment, bool Copyable>
+class inplace_function_base; // unspecified
+
+template<
+    class R,
+    class... Args,
+    size_t Capacity,
+    size_t Alignment,
+    bool Copyable
+>
+class inplace_function_base<R(Args...), Capacity, Alignment, Copyable>
+{
+protected:
+    using storage_t = aligned_storage_t<Capacity, Alignment>;
+    using vtable_t = vtable<R, Args...>;
+    using vtable_ptr_t = const vtable_t*;
+
+    template <class, size_t, size_t, bool> friend class inplace_function_base;
+
+public:
+    using capacity = std::integral_constant<size_t, Capacity>;
+    using alignment = std::integral_constant<size_t, Alignment>;
+
+    R operator() (Args... args) const
+    {
+#if SG14_INPLACE_FUNCTION_INLINE_INVOKER
+        return invoke_ptr_(
+            std::addressof(storage_),
+            std::forward<Args>(args)...
+        );
+#else
+        return vtable_ptr_->invoke_ptr(
+            std::addressof(storage_),
+            std::forward<Args>(args)...
+        );
+#endif
+    }
+
+    constexpr bool operator== (std::nullptr_t) const noexcept
+    {
+        return !operator bool();
+    }
+
+    constexpr bool operator!= (std::nullptr_t) const noexcept
+    {
+        return operator bool();
+    }
+
+    constexpr explicit operator bool() const noexcept
+    {
+        return vtable_ptr_ != std::addressof(empty_vtable<R, Args...>);
+    }
+
+    // True if this holds a callable that didn't fit in the inplace storage.
+    bool spilled() const noexcept
+    {
+        return vtable_ptr_->is_spilled;
+    }
+
+protected:
+    constexpr inplace_function_base() noexcept :
+        vtable_ptr_(std::addressof(empty_vtable<R, Args...>)),
+#if SG14_INPLACE_FUNCTION_INLINE_INVOKER
+        invoke_ptr_(empty_vtable<R, Args...>.invoke_ptr),
+#endif
+        dummy_()
+    {}
+
+    inplace_function_base(const inplace_function_base&) = delete;
+    inplace_function_base& operator= (const inplace_function_base&) = delete;
+
+    ~inplace_function_base()
+    {
+        destroy();
+    }
+
+    template<class C, class T>
+    void construct(T&& closure)
+    {
+        static_assert(sizeof(C) <= Capacity,
+            "inplace_function cannot be constructed from object with this (large) size"
+        );
+
+        static_assert(Alignment % alignof(C) == 0,
+            "inplace_function cannot be constructed from object with this (large) alignment"
+        );
+
+        // A move-only function's move constructor is noexcept, and relocates C.
+        static_assert(Copyable || std::is_nothrow_move_constructible<C>::value,
+            "inplace_move_only_function cannot be constructed from type whose move constructor may throw"
+        );
+
+        static const vtable_t vt(wrapper<C>{});
+        ::new (std::addressof(storage_)) C(std::forward<T>(closure));
+        set_vtable(std::addressof(vt));
+    }
+
+    // Like construct(), except that a callable too large (or too aligned) for the
+    // inplace storage is put in memory from alloc, rather than rejected. The inplace
+    // storage then holds a copy of alloc and a pointer, and moving it moves only those.
+    template<class C, class Alloc, class T>
+    void construct_spillable(const Alloc& alloc, T&& closure)
+    {
+        construct_spillable<C>(alloc, std::forward<T>(closure), std::integral_constant<bool,
+            sizeof(C) <= Capacity && Alignment % alignof(C) == 0
+        >{});
+    }
+
+    // Both of these require that this hold no callable. move_from leaves other empty.
+    template<size_t Cap, size_t Align, bool Copy>
+    void copy_from(const inplace_function_base<R(Args...), Cap, Align, Copy>& other)
+    {
+        static_assert(is_valid_inplace_dst<
+            Capacity, Alignment, Cap, Align
+        >::value, "conversion not allowed");
+
+        process(other.vtable_ptr_, other.vtable_ptr_->copy_ptr, std::addressof(other.storage_), sizeof(other.storage_));
+        set_vtable(other.vtable_ptr_);
+    }
+
+    template<size_t Cap, size_t Align, bool Copy>
+    void move_from(inplace_function_base<R(Args...), Cap, Align, Copy>& other) noexcept
+    {
+        static_assert(is_valid_inplace_dst<
+            Capacity, Alignment, Cap, Align
+        >::value, "conversion not allowed");
+
+        process(other.vtable_ptr_, other.vtable_ptr_->relocate_ptr, std::addressof(other.storage_), sizeof(other.storage_));
+        set_vtable(other.vtable_ptr_);
+        other.set_vtable(std::addressof(empty_vtable<R, Args...>));
+    }
+
+    void reset() noexcept
+    {
+        destroy();
+        set_vtable(std::addressof(empty_vtable<R, Args...>));
+    }
+
+    void swap_with(inplace_function_base& other) noexcept
+    {
+        if (this == std::addressof(other)) return;
+
+        if (vtable_ptr_->is_trivial && other.vtable_ptr_->is_trivial) {
+            storage_t tmp;
+            memcpy(std::addressof(tmp), std::addressof(storage_), sizeof(storage_t));
+            memcpy(std::addressof(storage_), std::addressof(other.storage_), sizeof(storage_t));
+            memcpy(std::addressof(other.storage_), std::addressof(tmp), sizeof(storage_t));
+        } else {
+            storage_t tmp;
+            vtable_ptr_->relocate_ptr(
+                std::addressof(tmp),
+                std::addressof(storage_)
+            );
+
+            other.vtable_ptr_->relocate_ptr(
+                std::addressof(storage_),
+                std::addressof(other.storage_)
+            );
+
+            vtable_ptr_->relocate_ptr(
+                std::addressof(other.storage_),
+                std::addressof(tmp)
+            );
+        }
+
+        vtable_ptr_t vt = vtable_ptr_;
+        set_vtable(other.vtable_ptr_);
+        other.set_vtable(vt);
+    }
+
+private:
+    vtable_ptr_t vtable_ptr_;
+#if SG14_INPLACE_FUNCTION_INLINE_INVOKER
+    typename vtable_t::invoke_ptr_t invoke_ptr_;
+#endif
+    // Initializing dummy_ rather than storage_ keeps the default constructor constexpr
+    // without zeroing Capacity bytes each time; the callable is constructed into storage_.
+    union {
+        char dummy_;
+        mutable storage_t storage_;
+    };
+
+    void set_vtable(vtable_ptr_t vtable_ptr) noexcept
+    {
+        vtable_ptr_ = vtable_ptr;
+#if SG14_INPLACE_FUNCTION_INLINE_INVOKER
+        invoke_ptr_ = vtable_ptr->invoke_ptr;
+#endif
+    }
+
+    // Copies or relocates the callable at storage_ptr (whose storage is size bytes)
+    // into storage_, using vt, which describes it. The caller then installs vt, so
+    // that if a copy throws, this still holds no callable, and the base destructor
+    // run by the derived constructor's unwinding has nothing to destroy.
+    void process(
+        vtable_ptr_t vt,
+        typename vtable_t::process_ptr_t process_ptr,
+        const void *storage_ptr,
+        size_t size
+    ) {
+        if (vt->is_trivial) {
+            memcpy(std::addressof(storage_), storage_ptr, size);
+        } else {
+            process_ptr(std::addressof(storage_), const_cast<void*>(storage_ptr));
+        }
+    }
+
+    template<class C, class Alloc, class T>
+    void construct_spillable(const Alloc&, T&& closure, std::true_type)
+    {
+        construct<C>(std::forward<T>(closure));
+    }
+
+    template<class C, class Alloc, class T>
+    void construct_spillable(const Alloc& alloc, T&& closure, std::false_type)
+    {
+        using box_t = spill_box<C, Alloc>;
+
+        static_assert(sizeof(box_t) <= Capacity && Alignment % alignof(box_t) == 0,
+            "inplace_function cannot hold a pointer and this allocator"
+        );
+
+        static const vtable_t vt(wrapper<box_t>{});
+        ::new (std::addressof(storage_)) box_t(alloc, std::forward<T>(closure));
+        set_vtable(std::addressof(vt));
+    }
+
+    void destroy() noexcept
+    {
+        if (!vtable_ptr_->is_trivial) {
+            vtable_ptr_->destructor_ptr(std::addressof(storage_));
+        }
+    }
+};
 } // namespace inplace_function_detail
 
 template<
@@ -193,10 +525,28 @@ template<
 >
 class inplace_function; // unspecified
 
+template<
+    class Signature,
+    size_t Capacity = inplace_function_detail::InplaceFunctionDefaultCapacity,
+    size_t Alignment = alignof(inplace_function_detail::aligned_storage_t<Capacity>)
+>
+class inplace_move_only_function; // unspecified
+
+template<class Signature>
+class inplace_function_ref; // unspecified
+
 namespace inplace_function_detail {
     template<class> struct is_inplace_function : std::false_type {};
     template<class Sig, size_t Cap, size_t Align>
     struct is_inplace_function<inplace_function<Sig, Cap, Align>> : std::true_type {};
+
+    template<class> struct is_inplace_move_only_function : std::false_type {};
+    template<class Sig, size_t Cap, size_t Align>
+    struct is_inplace_move_only_function<inplace_move_only_function<Sig, Cap, Align>> : std::true_type {};
+
+    template<class> struct is_inplace_function_ref : std::false_type {};
+    template<class Sig>
+    struct is_inplace_function_ref<inplace_function_ref<Sig>> : std::true_type {};
 } // namespace inplace_function_detail
 
 template<
@@ -205,22 +555,11 @@ template<
     size_t Capacity,
     size_t Alignment
 >
-class inplace_function<R(Args...), Capacity, Alignment>
+class inplace_function<R(Args...), Capacity, Alignment> :
+    public inplace_function_detail::inplace_function_base<R(Args...), Capacity, Alignment, true>
 {
-    using storage_t = inplace_function_detail::aligned_storage_t<Capacity, Alignment>;
-    using vtable_t = inplace_function_detail::vtable<R, Args...>;
-    using vtable_ptr_t = const vtable_t*;
-
-    template <class, size_t, size_t> friend class inplace_function;
-
 public:
-    using capacity = std::integral_constant<size_t, Capacity>;
-    using alignment = std::integral_constant<size_t, Alignment>;
-
-    constexpr inplace_function() noexcept :
-        vtable_ptr_(std::addressof(inplace_function_detail::empty_vtable<R, Args...>)),
-        storage_()
-    {}
+    constexpr inplace_function() noexcept = default;
 
     template<
         class T,
@@ -236,149 +575,244 @@ public:
             "inplace_function cannot be constructed from non-copyable type"
         );
 
-        static_assert(sizeof(C) <= Capacity,
-            "inplace_function cannot be constructed from object with this (large) size"
-        );
+        this->template construct<C>(std::forward<T>(closure));
+    }
 
-        static_assert(Alignment % alignof(C) == 0,
-            "inplace_function cannot be constructed from object with this (large) alignment"
+    // Like the constructor above, except that a callable too large (or too aligned)
+    // for the inplace storage is put in memory from alloc, rather than rejected.
+    template<
+        class Alloc,
+        class T,
+        class C = std::decay_t<T>,
+        class = std::enable_if_t<
+            !inplace_function_detail::is_inplace_function<C>::value
+            && inplace_function_detail::is_invocable_r<R, C&, Args...>::value
+        >
+    >
+    inplace_function(std::allocator_arg_t, const Alloc& alloc, T&& closure)
+    {
+        static_assert(std::is_copy_constructible<C>::value,
+            "inplace_function cannot be constructed from non-copyable type"
         );
 
-        static const vtable_t vt(inplace_function_detail::wrapper<C>{});
-        vtable_ptr_ = std::addressof(vt);
-
-        ::new (std::addressof(storage_)) C(std::forward<T>(closure));
+        this->template construct_spillable<C>(alloc, std::forward<T>(closure));
     }
 
     template<size_t Cap, size_t Align>
     inplace_function(const inplace_function<R(Args...), Cap, Align>& other)
-        : inplace_function(other.vtable_ptr_, other.vtable_ptr_->copy_ptr, std::addressof(other.storage_))
     {
-        static_assert(inplace_function_detail::is_valid_inplace_dst<
-            Capacity, Alignment, Cap, Align
-        >::value, "conversion not allowed");
+        this->copy_from(other);
     }
 
     template<size_t Cap, size_t Align>
     inplace_function(inplace_function<R(Args...), Cap, Align>&& other) noexcept
-        : inplace_function(other.vtable_ptr_, other.vtable_ptr_->relocate_ptr, std::addressof(other.storage_))
     {
-        static_assert(inplace_function_detail::is_valid_inplace_dst<
-            Capacity, Alignment, Cap, Align
-        >::value, "conversion not allowed");
-
-        other.vtable_ptr_ = std::addressof(inplace_function_detail::empty_vtable<R, Args...>);
+        this->move_from(other);
     }
 
-    inplace_function(std::nullptr_t) noexcept :
-        vtable_ptr_(std::addressof(inplace_function_detail::empty_vtable<R, Args...>))
-    {}
+    inplace_function(std::nullptr_t) noexcept {}
 
-    inplace_function(const inplace_function& other) :
-        vtable_ptr_(other.vtable_ptr_)
+    inplace_function(const inplace_function& other)
     {
-        vtable_ptr_->copy_ptr(
-            std::addressof(storage_),
-            std::addressof(other.storage_)
-        );
+        this->copy_from(other);
     }
 
-    inplace_function(inplace_function&& other) noexcept :
-        vtable_ptr_(std::exchange(other.vtable_ptr_, std::addressof(inplace_function_detail::empty_vtable<R, Args...>)))
+    inplace_function(inplace_function&& other) noexcept
     {
-        vtable_ptr_->relocate_ptr(
-            std::addressof(storage_),
-            std::addressof(other.storage_)
-        );
+        this->move_from(other);
     }
 
     inplace_function& operator= (std::nullptr_t) noexcept
     {
-        vtable_ptr_->destructor_ptr(std::addressof(storage_));
-        vtable_ptr_ = std::addressof(inplace_function_detail::empty_vtable<R, Args...>);
+        this->reset();
         return *this;
     }
 
     inplace_function& operator= (inplace_function other) noexcept
     {
-        vtable_ptr_->destructor_ptr(std::addressof(storage_));
-
-        vtable_ptr_ = std::exchange(other.vtable_ptr_, std::addressof(inplace_function_detail::empty_vtable<R, Args...>));
-        vtable_ptr_->relocate_ptr(
-            std::addressof(storage_),
-            std::addressof(other.storage_)
-        );
+        this->reset();
+        this->move_from(other);
         return *this;
     }
 
-    ~inplace_function()
+    void swap(inplace_function& other) noexcept
     {
-        vtable_ptr_->destructor_ptr(std::addressof(storage_));
+        this->swap_with(other);
     }
 
-    R operator() (Args... args) const
+    friend void swap(inplace_function& lhs, inplace_function& rhs) noexcept
     {
-        return vtable_ptr_->invoke_ptr(
-            std::addressof(storage_),
-            std::forward<Args>(args)...
-        );
+        lhs.swap(rhs);
     }
+};
 
-    constexpr bool operator== (std::nullptr_t) const noexcept
+// Like inplace_function, but it may hold move-only callables, and so is itself move-only.
+template<
+    class R,
+    class... Args,
+    size_t Capacity,
+    size_t Alignment
+>
+class inplace_move_only_function<R(Args...), Capacity, Alignment> :
+    public inplace_function_detail::inplace_function_base<R(Args...), Capacity, Alignment, false>
+{
+public:
+    constexpr inplace_move_only_function() noexcept = default;
+
+    template<
+        class T,
+        class C = std::decay_t<T>,
+        class = std::enable_if_t<
+            !inplace_function_detail::is_inplace_function<C>::value
+            && !inplace_function_detail::is_inplace_move_only_function<C>::value
+            && inplace_function_detail::is_invocable_r<R, C&, Args...>::value
+        >
+    >
+    inplace_move_only_function(T&& closure)
     {
-        return !operator bool();
+        this->template construct<C>(std::forward<T>(closure));
     }
 
-    constexpr bool operator!= (std::nullptr_t) const noexcept
+    // Like the constructor above, except that a callable too large (or too aligned)
+    // for the inplace storage is put in memory from alloc, rather than rejected.
+    // Only a pointer moves then, so the callable's move constructor may throw.
+    template<
+        class Alloc,
+        class T,
+        class C = std::decay_t<T>,
+        class = std::enable_if_t<
+            !inplace_function_detail::is_inplace_function<C>::value
+            && !inplace_function_detail::is_inplace_move_only_function<C>::value
+            && inplace_function_detail::is_invocable_r<R, C&, Args...>::value
+        >
+    >
+    inplace_move_only_function(std::allocator_arg_t, const Alloc& alloc, T&& closure)
     {
-        return operator bool();
+        this->template construct_spillable<C>(alloc, std::forward<T>(closure));
     }
 
-    constexpr explicit operator bool() const noexcept
+    template<size_t Cap, size_t Align>
+    inplace_move_only_function(inplace_move_only_function<R(Args...), Cap, Align>&& other) noexcept
     {
-        return vtable_ptr_ != std::addressof(inplace_function_detail::empty_vtable<R, Args...>);
+        this->move_from(other);
     }
 
-    void swap(inplace_function& other) noexcept
+    template<size_t Cap, size_t Align>
+    inplace_move_only_function(const inplace_function<R(Args...), Cap, Align>& other)
     {
-        if (this == std::addressof(other)) return;
+        this->copy_from(other);
+    }
 
-        storage_t tmp;
-        vtable_ptr_->relocate_ptr(
-            std::addressof(tmp),
-            std::addressof(storage_)
-        );
+    template<size_t Cap, size_t Align>
+    inplace_move_only_function(inplace_function<R(Args...), Cap, Align>&& other) noexcept
+    {
+        this->move_from(other);
+    }
 
-        other.vtable_ptr_->relocate_ptr(
-            std::addressof(storage_),
-            std::addressof(other.storage_)
-        );
+    inplace_move_only_function(std::nullptr_t) noexcept {}
 
-        vtable_ptr_->relocate_ptr(
-            std::addressof(other.storage_),
-            std::addressof(tmp)
-        );
+    inplace_move_only_function(const inplace_move_only_function&) = delete;
+
+    inplace_move_only_function(inplace_move_only_function&& other) noexcept
+    {
+        this->move_from(other);
+    }
 
-        std::swap(vtable_ptr_, other.vtable_ptr_);
+    inplace_move_only_function& operator= (std::nullptr_t) noexcept
+    {
+        this->reset();
+        return *this;
     }
 
-    friend void swap(inplace_function& lhs, inplace_function& rhs) noexcept
+    inplace_move_only_function& operator= (inplace_move_only_function&& other) noexcept
+    {
+        if (this != std::addressof(other)) {
+            this->reset();
+            this->move_from(other);
+        }
+        return *this;
+    }
+
+    void swap(inplace_move_only_function& other) noexcept
+    {
+        this->swap_with(other);
+    }
+
+    friend void swap(inplace_move_only_function& lhs, inplace_move_only_function& rhs) noexcept
     {
         lhs.swap(rhs);
     }
+};
+
+// A non-owning reference to a callable, for passing callbacks that are called
+// only before the callee returns. It is two pointers: the callable's address
+// (or a function pointer), and an invoker. It never copies the callable, so
+// the callable must outlive every call through the reference.
+template<class R, class... Args>
+class inplace_function_ref<R(Args...)>
+{
+    using vtable_t = inplace_function_detail::vtable<R, Args...>;
+
+    // A function pointer can't be converted to void*, so it gets a member of its own.
+    union object_t {
+        void *obj_;
+        void (*fptr_)();
+    };
+    using invoke_ptr_t = R(*)(object_t, Args&&...);
+
+public:
+    template<
+        class F,
+        class C = std::remove_reference_t<F>,
+        class = std::enable_if_t<
+            !inplace_function_detail::is_inplace_function_ref<std::remove_cv_t<C>>::value
+            && !std::is_function<std::remove_pointer_t<std::remove_cv_t<C>>>::value
+            && inplace_function_detail::is_invocable_r<R, C&, Args...>::value
+        >
+    >
+    inplace_function_ref(F&& f) noexcept :
+        invoke_ptr_(&invoke_object<C>)
+    {
+        object_.obj_ = const_cast<void*>(static_cast<const volatile void*>(std::addressof(f)));
+    }
+
+    template<
+        class F,
+        class = std::enable_if_t<
+            std::is_function<F>::value
+            && inplace_function_detail::is_invocable_r<R, F&, Args...>::value
+        >
+    >
+    inplace_function_ref(F *fptr) noexcept :
+        invoke_ptr_(&invoke_function<F>)
+    {
+        object_.fptr_ = reinterpret_cast<void(*)()>(fptr);
+    }
+
+    inplace_function_ref(const inplace_function_ref&) noexcept = default;
+    inplace_function_ref& operator= (const inplace_function_ref&) noexcept = default;
+
+    R operator() (Args... args) const
+    {
+        return invoke_ptr_(
+            object_,
+            std::forward<Args>(args)...
+        );
+    }
 
 private:
-    vtable_ptr_t vtable_ptr_;
-    mutable storage_t storage_;
+    template<class C> static R invoke_object(object_t o, Args&&... args)
+    {
+        return vtable_t::template invoke_callable<C>(o.obj_, static_cast<Args&&>(args)...);
+    }
 
-    inplace_function(
-        vtable_ptr_t vtable_ptr,
-        typename vtable_t::process_ptr_t process_ptr,
-        typename vtable_t::storage_ptr_t storage_ptr
-    ) : vtable_ptr_(vtable_ptr)
+    template<class F> static R invoke_function(object_t o, Args&&... args)
     {
-        process_ptr(std::addressof(storage_), storage_ptr);
+        return reinterpret_cast<F*>(o.fptr_)(static_cast<Args&&>(args)...);
     }
+
+    object_t object_;
+    invoke_ptr_t invoke_ptr_;
 };
 
 } // namespace sg14
@@ -0,0 +1,352 @@
+/*
+ * Boost Software License - Version 1.0 - August 17th, 2003
+ *
+ * Permission is hereby granted, free of charge, to any person or organization
+ * obtaining a copy of the software and accompanying documentation covered by
+ * this license (the "Software") to use, reproduce, display, distribute,
+ * execute, and transmit the Software, and to prepare derivative works of the
+ * Software, and to permit third-parties to whom the Software is furnished to
+ * do so, all subject to the following:
+ *
+ * The copyright notices in the Software and this entire statement, including
+ * the above license grant, this restriction and the following disclaimer,
+ * must be included in all copies of the Software, in whole or in part, and
+ * all derivative works of the Software, unless such copies or derivative
+ * works are solely in the form of machine-executable object code generated by
+ * a source language processor.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+ * SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+ * FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+
+#pragma once
+
+// sg14::inplace_ring<T, N> is an owning circular buffer with the semantics of
+// sg14::ring_span: push_back onto a full ring overwrites the oldest element,
+// and pop_front returns the popped element by move. Unlike ring_span, the
+// slots don't need to hold constructed T's: elements are constructed in place
+// on push and destroyed on pop, like inplace_vector's.
+
+#include <stddef.h>
+#include <cassert>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+// The same as in inplace_vector.h, which this header doesn't include, to stay standalone.
+#ifndef SG14_INPLACE_VECTOR_TRIVIALLY_RELOCATABLE_IF
+#if defined(__cpp_impl_trivially_relocatable) && defined(__cpp_lib_trivially_relocatable)
+#define SG14_INPLACE_VECTOR_TRIVIALLY_RELOCATABLE_IF(x) [[trivially_relocatable(x)]]
+#else
+#define SG14_INPLACE_VECTOR_TRIVIALLY_RELOCATABLE_IF(x)
+#endif // __cpp_impl_trivially_relocatable
+#endif // SG14_INPLACE_VECTOR_TRIVIALLY_RELOCATABLE_IF
+
+namespace sg14 {
+
+// Deletes inplace_ring's copy and move operations when T lacks them, like ipvbase_assignable.
+template<class T, bool = (std::is_copy_constructible_v<T> && std::is_copy_assignable_v<T>),
+                  bool = (std::is_move_constructible_v<T> && std::is_move_assignable_v<T>)>
+struct iprbase_assignable {
+    // Base for copyable types
+};
+template<class T, bool Copyable>
+struct iprbase_assignable<T, Copyable, false> {
+    // Base for immobile types like std::mutex
+    explicit iprbase_assignable() = default;
+    iprbase_assignable(iprbase_assignable&&) = delete;
+    iprbase_assignable(const iprbase_assignable&) = delete;
+    void operator=(iprbase_assignable&&) = delete;
+    void operator=(const iprbase_assignable&) = delete;
+    ~iprbase_assignable() = default;
+};
+template<class T>
+struct iprbase_assignable<T, false, true> {
+    explicit iprbase_assignable() = default;
+    iprbase_assignable(const iprbase_assignable&) = delete;
+    iprbase_assignable(iprbase_assignable&&) = default;
+    void operator=(const iprbase_assignable&) = delete;
+    iprbase_assignable& operator=(iprbase_assignable&&) = default;
+    ~iprbase_assignable() = default;
+};
+
+// The elements occupy data_[(front_ + i) % N] for i in [0, size_).
+// Copies and moves of a non-trivial ring lay the elements out from data_[0].
+template<class T, size_t N>
+struct SG14_INPLACE_VECTOR_TRIVIALLY_RELOCATABLE_IF(std::is_trivially_relocatable_v<T>) iprbase
+{
+    size_t front_ = 0;
+    size_t size_ = 0;
+    union {
+        char dummy_;
+        T data_[N];
+    };
+
+    constexpr explicit iprbase() noexcept {}
+    iprbase(const iprbase& rhs)
+        noexcept(std::is_nothrow_copy_constructible_v<T>)
+    {
+        this->transfer_from_(rhs.data_, rhs.front_, rhs.size_, [](const T *first, const T *last, T *dest) {
+            return std::uninitialized_copy(first, last, dest);
+        });
+    }
+    iprbase(iprbase&& rhs)
+        noexcept(std::is_nothrow_move_constructible_v<T>
+#if defined(__cpp_lib_trivially_relocatable)
+                                    || std::is_trivially_relocatable_v<T>
+#endif // __cpp_lib_trivially_relocatable
+                           )
+    {
+#if defined(__cpp_lib_trivially_relocatable)
+        if constexpr (std::is_trivially_relocatable_v<T>) {
+            this->transfer_from_(rhs.data_, rhs.front_, rhs.size_, [](T *first, T *last, T *dest) {
+                return std::uninitialized_relocate(first, last, dest);
+            });
+            rhs.size_ = 0;
+            return;
+        }
+#endif // __cpp_lib_trivially_relocatable
+        this->transfer_from_(rhs.data_, rhs.front_, rhs.size_, [](T *first, T *last, T *dest) {
+            return std::uninitialized_move(first, last, dest);
+        });
+    }
+    void operator=(const iprbase& rhs)
+        noexcept(std::is_nothrow_copy_constructible_v<T>)
+    {
+        if (this != std::addressof(rhs)) {
+            this->destroy_all_();
+            this->transfer_from_(rhs.data_, rhs.front_, rhs.size_, [](const T *first, const T *last, T *dest) {
+                return std::uninitialized_copy(first, last, dest);
+            });
+        }
+    }
+    void operator=(iprbase&& rhs)
+        noexcept(std::is_nothrow_move_constructible_v<T>)
+    {
+        if (this != std::addressof(rhs)) {
+            this->destroy_all_();
+            this->transfer_from_(rhs.data_, rhs.front_, rhs.size_, [](T *first, T *last, T *dest) {
+                return std::uninitialized_move(first, last, dest);
+            });
+        }
+    }
+
+#if __cpp_concepts >= 202002L
+    ~iprbase() requires std::is_trivially_destructible_v<T> = default;
+#endif // __cpp_concepts >= 202002L
+
+    ~iprbase() {
+        this->destroy_all_();
+    }
+
+protected:
+    void destroy_all_() noexcept {
+        for (size_t i = 0; i < size_; ++i) {
+            data_[(front_ + i) % N].~T();
+        }
+        front_ = 0;
+        size_ = 0;
+    }
+
+    // Lays out the source ring's (at most two) runs contiguously from data_[0].
+    // If the second run throws, the first is destroyed and this stays empty.
+    template<class U, class F>
+    void transfer_from_(U *src, size_t src_front, size_t src_size, F uninitialized_xfer) {
+        size_t run = (src_size < N - src_front) ? src_size : N - src_front;
+        front_ = 0;
+        size_ = 0;
+        uninitialized_xfer(src + src_front, src + src_front + run, data_);
+        try {
+            uninitialized_xfer(src, src + (src_size - run), data_ + run);
+        } catch (...) {
+            std::destroy(data_, data_ + run);
+            throw;
+        }
+        size_ = src_size;
+    }
+};
+
+template<class T, size_t N>
+struct iprbase_trivial {
+    size_t front_ = 0;
+    size_t size_ = 0;
+    union {
+        char dummy_;
+        T data_[N];
+    };
+    constexpr explicit iprbase_trivial() {}
+
+protected:
+    constexpr void destroy_all_() noexcept {
+        front_ = 0;
+        size_ = 0;
+    }
+};
+
+template<class T, size_t N>
+using iprbase_t = std::conditional_t<
+    std::is_trivially_copyable_v<T>,
+    iprbase_trivial<T, N>,
+    iprbase<T, N>
+>;
+
+template<class T, size_t N>
+class inplace_ring : iprbase_assignable<T>, iprbase_t<T, N> {
+    static_assert(N != 0, "an inplace_ring can't have zero capacity");
+
+    using iprbase_t<T, N>::front_;
+    using iprbase_t<T, N>::size_;
+    using iprbase_t<T, N>::data_;
+
+    template<bool Const>
+    class iterator_impl {
+        using Ring = std::conditional_t<Const, const inplace_ring, inplace_ring>;
+    public:
+        using value_type = T;
+        using difference_type = ptrdiff_t;
+        using pointer = std::conditional_t<Const, const T, T>*;
+        using reference = std::conditional_t<Const, const T, T>&;
+        using iterator_category = std::random_access_iterator_tag;
+
+        constexpr iterator_impl() = default;
+        constexpr operator iterator_impl<true>() const noexcept { return iterator_impl<true>(r_, i_); }
+
+        constexpr reference operator*() const noexcept { return (*r_)[i_]; }
+        constexpr pointer operator->() const noexcept { return std::addressof((*r_)[i_]); }
+        constexpr reference operator[](difference_type n) const noexcept { return (*r_)[i_ + n]; }
+
+        constexpr iterator_impl& operator++() noexcept { ++i_; return *this; }
+        constexpr iterator_impl operator++(int) noexcept { auto r = *this; ++i_; return r; }
+        constexpr iterator_impl& operator--() noexcept { --i_; return *this; }
+        constexpr iterator_impl operator--(int) noexcept { auto r = *this; --i_; return r; }
+        constexpr iterator_impl& operator+=(difference_type n) noexcept { i_ += n; return *this; }
+        constexpr iterator_impl& operator-=(difference_type n) noexcept { i_ -= n; return *this; }
+
+        friend constexpr iterator_impl operator+(iterator_impl it, difference_type n) noexcept { return it += n; }
+        friend constexpr iterator_impl operator+(difference_type n, iterator_impl it) noexcept { return it += n; }
+        friend constexpr iterator_impl operator-(iterator_impl it, difference_type n) noexcept { return it -= n; }
+        friend constexpr difference_type operator-(const iterator_impl& a, const iterator_impl& b) noexcept {
+            return difference_type(a.i_) - difference_type(b.i_);
+        }
+        friend constexpr bool operator==(const iterator_impl& a, const iterator_impl& b) noexcept { return a.i_ == b.i_; }
+        friend constexpr bool operator!=(const iterator_impl& a, const iterator_impl& b) noexcept { return a.i_ != b.i_; }
+        friend constexpr bool operator<(const iterator_impl& a, const iterator_impl& b) noexcept { return a.i_ < b.i_; }
+        friend constexpr bool operator<=(const iterator_impl& a, const iterator_impl& b) noexcept { return a.i_ <= b.i_; }
+        friend constexpr bool operator>(const iterator_impl& a, const iterator_impl& b) noexcept { return a.i_ > b.i_; }
+        friend constexpr bool operator>=(const iterator_impl& a, const iterator_impl& b) noexcept { return a.i_ >= b.i_; }
+
+    private:
+        friend class inplace_ring;
+        template<bool> friend class iterator_impl;
+        constexpr explicit iterator_impl(Ring *r, size_t i) noexcept : r_(r), i_(i) {}
+        Ring *r_ = nullptr;
+        size_t i_ = 0;  // the distance from the front of the ring
+    };
+
+public:
+    using value_type = T;
+    using pointer = T*;
+    using const_pointer = const T*;
+    using reference = T&;
+    using const_reference = const T&;
+    using size_type = size_t;
+    using difference_type = ptrdiff_t;
+    using iterator = iterator_impl<false>;
+    using const_iterator = iterator_impl<true>;
+    using reverse_iterator = std::reverse_iterator<iterator>;
+    using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+    inplace_ring() = default;
+    inplace_ring(inplace_ring&&) = default;
+    inplace_ring(const inplace_ring&) = default;
+    inplace_ring& operator=(inplace_ring&&) = default;
+    inplace_ring& operator=(const inplace_ring&) = default;
+
+    [[nodiscard]] constexpr bool empty() const noexcept { return size_ == 0; }
+    constexpr bool full() const noexcept { return size_ == N; }
+    constexpr size_type size() const noexcept { return size_; }
+    static constexpr size_type capacity() noexcept { return N; }
+    static constexpr size_type max_size() noexcept { return N; }
+
+    // Element i counts from the front; no bounds checking.
+    constexpr reference operator[](size_type i) noexcept { return data_[(front_ + i) % N]; }
+    constexpr const_reference operator[](size_type i) const noexcept { return data_[(front_ + i) % N]; }
+    constexpr reference front() noexcept { assert(size_ != 0); return data_[front_]; }
+    constexpr const_reference front() const noexcept { assert(size_ != 0); return data_[front_]; }
+    constexpr reference back() noexcept { assert(size_ != 0); return (*this)[size_ - 1]; }
+    constexpr const_reference back() const noexcept { assert(size_ != 0); return (*this)[size_ - 1]; }
+
+    constexpr iterator begin() noexcept { return iterator(this, 0); }
+    constexpr iterator end() noexcept { return iterator(this, size_); }
+    constexpr const_iterator begin() const noexcept { return const_iterator(this, 0); }
+    constexpr const_iterator end() const noexcept { return const_iterator(this, size_); }
+    constexpr const_iterator cbegin() const noexcept { return begin(); }
+    constexpr const_iterator cend() const noexcept { return end(); }
+    constexpr reverse_iterator rbegin() noexcept { return reverse_iterator(end()); }
+    constexpr reverse_iterator rend() noexcept { return reverse_iterator(begin()); }
+    constexpr const_reverse_iterator rbegin() const noexcept { return const_reverse_iterator(end()); }
+    constexpr const_reverse_iterator rend() const noexcept { return const_reverse_iterator(begin()); }
+    constexpr const_reverse_iterator crbegin() const noexcept { return rbegin(); }
+    constexpr const_reverse_iterator crend() const noexcept { return rend(); }
+
+    void push_back(const value_type& value) { emplace_back(value); }
+    void push_back(value_type&& value) { emplace_back(std::move(value)); }
+
+    // If the ring is full, the new element replaces the oldest one.
+    template<class... Args>
+    reference emplace_back(Args&&... args) {
+        if (size_ != N) {
+            T *p = std::addressof(data_[(front_ + size_) % N]);
+            ::new (static_cast<void*>(p)) T(std::forward<Args>(args)...);
+            size_ += 1;
+            return *p;
+        }
+        T *p = std::addressof(data_[front_]);
+        if constexpr (std::is_move_constructible_v<T>) {
+            // The arguments may refer to the oldest element, so build the new one first.
+            T temp(std::forward<Args>(args)...);
+            this->drop_oldest_();
+            ::new (static_cast<void*>(p)) T(std::move(temp));
+        } else {
+            this->drop_oldest_();
+            ::new (static_cast<void*>(p)) T(std::forward<Args>(args)...);
+        }
+        size_ += 1;
+        return *p;
+    }
+
+    value_type pop_front() {
+        assert(size_ != 0);
+        value_type result = std::move(data_[front_]);
+        this->drop_oldest_();
+        return result;
+    }
+
+    void clear() noexcept { this->destroy_all_(); }
+
+    void swap(inplace_ring& rhs) noexcept(std::is_nothrow_move_constructible_v<T>) {
+        inplace_ring temp = std::move(rhs);
+        rhs = std::move(*this);
+        *this = std::move(temp);
+    }
+    friend void swap(inplace_ring& a, inplace_ring& b) noexcept(std::is_nothrow_move_constructible_v<T>) {
+        a.swap(b);
+    }
+
+private:
+    void drop_oldest_() noexcept {
+        data_[front_].~T();
+        front_ = (front_ + 1) % N;
+        size_ -= 1;
+    }
+};
+
+} // namespace sg14
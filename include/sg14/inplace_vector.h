@@ -33,6 +33,7 @@
 #include <memory>
 #include <new>
 #include <type_traits>
+#include <utility>
 
 #if __cplusplus >= 202002L
 #include <compare>
@@ -79,6 +80,23 @@ struct ipvbase_assignable<T, false, true> {
     ~ipvbase_assignable() = default;
 };
 
+// A T whose bytes can be moved with memmove, ending the old object's lifetime.
+template<class T>
+inline constexpr bool ipv_trivially_relocatable_v =
+#if defined(__cpp_lib_trivially_relocatable)
+    std::is_trivially_relocatable_v<T>;
+#else
+    std::is_trivially_move_constructible_v<T> && std::is_trivially_destructible_v<T>;
+#endif // __cpp_lib_trivially_relocatable
+
+// Relocates the trivially relocatable [first, last) to dest, which may overlap it.
+template<class T>
+void ipv_relocate(T *first, T *last, T *dest) {
+    if (first != last) {
+        std::memmove((void*)dest, (const void*)first, size_t(last - first) * sizeof(T));
+    }
+}
+
 template<class T, size_t N, class = void>
 struct SG14_INPLACE_VECTOR_TRIVIALLY_RELOCATABLE_IF(std::is_trivially_relocatable_v<T>) ipvbase
 {
@@ -456,12 +474,58 @@ public:
     template<std::ranges::input_range R>
         requires std::convertible_to<std::ranges::range_reference_t<R>, value_type>
     constexpr void append_range(R&& rg) {
-        for (auto&& e : rg) {
-            emplace_back(static_cast<decltype(e)>(e));
+        if constexpr (std::ranges::sized_range<R>) {
+            if (N - size_ < std::ranges::size(rg)) {
+                SG14_INPLACE_VECTOR_THROW(std::bad_alloc());
+            }
+            unchecked_append_range(static_cast<R&&>(rg));
+        } else {
+            for (auto&& e : rg) {
+                emplace_back(static_cast<decltype(e)>(e));
+            }
         }
     }
 #endif // __cpp_lib_ranges >= 201911L && __cpp_lib_ranges_to_container >= 202202L
 
+#if __cpp_lib_ranges >= 201911L
+    // Appends the elements of rg with one copy, and no capacity check.
+    // A contiguous range of trivially copyable T is copied with memcpy.
+    template<std::ranges::input_range R>
+        requires std::ranges::sized_range<R> && std::convertible_to<std::ranges::range_reference_t<R>, value_type>
+    constexpr void unchecked_append_range(R&& rg) {
+        // Precondition: (size_ + ranges::size(rg) <= N)
+        size_t n = std::ranges::size(rg);
+        if (std::is_constant_evaluated()) {
+            // Neither memcpy nor uninitialized_copy_n is usable in a constant expression.
+            auto it = std::ranges::begin(rg);
+            for (size_t i = 0; i < n; ++i, ++it) {
+                std::construct_at(data() + size_ + i, *it);
+            }
+        } else if constexpr (std::ranges::contiguous_range<R> && std::is_trivially_copyable_v<T> &&
+                             std::is_same_v<std::remove_cvref_t<std::ranges::range_reference_t<R>>, T>) {
+            if (n != 0) {
+                std::memcpy((void*)(data() + size_), (const void*)std::ranges::data(rg), n * sizeof(T));
+            }
+        } else {
+            std::ranges::uninitialized_copy_n(std::ranges::begin(rg), n, data() + size_, std::unreachable_sentinel);
+        }
+        set_size_(size_ + n);
+    }
+#endif // __cpp_lib_ranges >= 201911L
+
+    // Calls op(data(), n), which may write to the storage in [data() + size(), data() + n)
+    // and returns the new size, which must not exceed n. This lets a producer like recv()
+    // write straight into the storage, without value-initializing it first.
+    template<class Op>
+    constexpr void resize_and_overwrite(size_type n, Op op) {
+        static_assert(std::is_trivially_copyable_v<T> && std::is_trivially_default_constructible_v<T>,
+                      "resize_and_overwrite requires a trivial value_type");
+        if (n > N) {
+            SG14_INPLACE_VECTOR_THROW(std::bad_alloc());
+        }
+        set_size_(static_cast<size_type>(std::move(op)(data(), n)));
+    }
+
     void pop_back() {
         std::destroy_at(data() + size_ - 1);
         set_size_(size_ - 1);
@@ -483,20 +547,19 @@ public:
         }
         auto it = iterator(pos);
         auto oldend = end();
-#if defined(__cpp_lib_trivially_relocatable)
         // Open a window and fill in-place; if filling fails, close the window again.
-        if constexpr (std::is_trivially_relocatable_v<value_type>) {
-            std::uninitialized_relocate_backward(it, oldend, oldend + n);
+        // Relocating a trivially relocatable T is a memmove, which allows the overlap.
+        if constexpr (ipv_trivially_relocatable_v<value_type>) {
+            ipv_relocate(it, oldend, it + n);
             try {
                 std::uninitialized_fill_n(it, n, value);
                 set_size_(size_ + n);
             } catch (...) {
-                std::uninitialized_relocate(it + n, oldend + n, it);
+                ipv_relocate(it + n, oldend + n, it);
                 throw;
             }
             return it;
         }
-#endif
         // Fill at the end of the vector, then rotate into place.
         std::uninitialized_fill_n(oldend, n, value);
         set_size_(size_ + n);
@@ -513,20 +576,18 @@ public:
             if (N - size_ < n) {
                 SG14_INPLACE_VECTOR_THROW(std::bad_alloc());
             }
-#if defined(__cpp_lib_trivially_relocatable)
             // Open a window and fill in-place; if filling fails, close the window again.
-            if constexpr (std::is_trivially_relocatable_v<value_type>) {
-                std::uninitialized_relocate_backward(it, oldend, oldend + n);
+            if constexpr (ipv_trivially_relocatable_v<value_type>) {
+                ipv_relocate(it, oldend, it + n);
                 try {
                     std::uninitialized_copy_n(first, n, it);
                     set_size_(size_ + n);
                 } catch (...) {
-                    std::uninitialized_relocate(it + n, oldend + n, it);
+                    ipv_relocate(it + n, oldend + n, it);
                     throw;
                 }
                 return it;
             }
-#endif
             // Fill at the end of the vector, then rotate into place.
             std::uninitialized_copy_n(first, n, oldend);
             set_size_(size_ + n);
@@ -552,20 +613,18 @@ public:
             if (N - size_ < n) {
                 SG14_INPLACE_VECTOR_THROW(std::bad_alloc());
             }
-#if defined(__cpp_lib_trivially_relocatable)
             // Open a window and fill in-place; if filling fails, close the window again.
-            if constexpr (std::is_trivially_relocatable_v<value_type>) {
-                std::uninitialized_relocate_backward(it, oldend, oldend + n);
+            if constexpr (ipv_trivially_relocatable_v<value_type>) {
+                ipv_relocate(it, oldend, it + n);
                 try {
                     std::ranges::uninitialized_copy_n(std::ranges::begin(rg), n, it, std::unreachable_sentinel);
                     set_size_(size_ + n);
                 } catch (...) {
-                    std::uninitialized_relocate(it + n, oldend + n, it);
+                    ipv_relocate(it + n, oldend + n, it);
                     throw;
                 }
                 return it;
             }
-#endif
             // Fill at the end of the vector, then rotate into place.
             std::ranges::uninitialized_copy_n(std::ranges::begin(rg), n, oldend, std::unreachable_sentinel);
             set_size_(size_ + n);
@@ -589,14 +648,12 @@ public:
     iterator erase(const_iterator pos) {
         auto it = iterator(pos);
         auto oldend = end();
-#if defined(__cpp_lib_trivially_relocatable)
-        if constexpr (std::is_trivially_relocatable_v<value_type>) {
+        if constexpr (ipv_trivially_relocatable_v<value_type>) {
             std::destroy_at(it);
-            std::uninitialized_relocate(it + 1, oldend, it);
+            ipv_relocate(it + 1, oldend, it);
             set_size_(size_ - 1);
             return it;
         }
-#endif
         std::move(it + 1, oldend, it);
         std::destroy_at(oldend - 1);
         set_size_(size_ - 1);
@@ -609,14 +666,12 @@ public:
         auto n = ilast - ifirst;
         if (n != 0) {
             auto oldend = end();
-#if defined(__cpp_lib_trivially_relocatable)
-            if constexpr (std::is_trivially_relocatable_v<value_type>) {
+            if constexpr (ipv_trivially_relocatable_v<value_type>) {
                 std::destroy(ifirst, ilast);
-                std::uninitialized_relocate(ilast, oldend, ifirst);
+                ipv_relocate(ilast, oldend, ifirst);
                 set_size_(size_ - n);
                 return ifirst;
             }
-#endif // __cpp_lib_trivially_relocatable
             std::destroy(std::move(ilast, oldend, ifirst), oldend);
             set_size_(size_ - n);
         }
@@ -715,4 +770,549 @@ erase_if(inplace_vector<T, N>& c, Predicate pred)
     return r;
 }
 
+// small_vector<T, N, Alloc> keeps up to N elements inline, in the same storage
+// as inplace_vector<T, N>, and moves them to a buffer from Alloc once it outgrows
+// that. Alloc supplies only that buffer; elements are constructed in place, as in
+// inplace_vector. The inline storage never points into itself, so a small_vector
+// is trivially relocatable whenever T and Alloc are.
+
+template<class T, size_t N, class Alloc>
+struct SG14_INPLACE_VECTOR_TRIVIALLY_RELOCATABLE_IF(std::is_trivially_relocatable_v<T> && std::is_trivially_relocatable_v<Alloc>) svbase
+{
+    using alloc_traits = std::allocator_traits<Alloc>;
+
+    // The heap buffer, with the allocator as an (often empty) base.
+    struct heap_t : Alloc {
+        T *ptr_ = nullptr;  // null while the elements are inline
+        size_t size_ = 0;
+        size_t cap_ = 0;
+
+        explicit heap_t(const Alloc& a) noexcept : Alloc(a) {}
+        Alloc& alloc() noexcept { return *this; }
+        const Alloc& alloc() const noexcept { return *this; }
+    };
+
+    ipvbase_t<T, N> small_;
+    heap_t heap_;
+
+    bool spilled_() const noexcept { return heap_.ptr_ != nullptr; }
+    T *base_data_() noexcept { return spilled_() ? heap_.ptr_ : small_.base_data_(); }
+    const T *base_data_() const noexcept { return spilled_() ? heap_.ptr_ : small_.base_data_(); }
+    size_t base_size_() const noexcept { return spilled_() ? heap_.size_ : small_.size_; }
+    size_t base_capacity_() const noexcept { return spilled_() ? heap_.cap_ : N; }
+    void set_size_(size_t n) noexcept {
+        if (spilled_()) {
+            heap_.size_ = n;
+        } else {
+            small_.set_size_(n);
+        }
+    }
+
+    explicit svbase(const Alloc& a) noexcept : small_(), heap_(a) {}
+    svbase(const svbase& rhs) : svbase(rhs, alloc_traits::select_on_container_copy_construction(rhs.heap_.alloc())) {}
+    svbase(const svbase& rhs, const Alloc& a) : small_(rhs.small_), heap_(a) {
+        if (rhs.spilled_()) {
+            init_(rhs.heap_.ptr_, rhs.heap_.size_);
+        }
+    }
+    svbase(svbase&& rhs) noexcept(std::is_nothrow_move_constructible_v<T>)
+        : small_(std::move(rhs.small_)), heap_(rhs.heap_.alloc())
+    {
+        steal_(rhs);
+    }
+    svbase(svbase&& rhs, const Alloc& a) : small_(std::move(rhs.small_)), heap_(a) {
+        if (!rhs.spilled_()) {
+            // the inline elements have already been moved
+        } else if (heap_.alloc() == rhs.heap_.alloc()) {
+            steal_(rhs);
+        } else {
+            init_(std::make_move_iterator(rhs.heap_.ptr_), rhs.heap_.size_);
+        }
+    }
+
+    void operator=(const svbase& rhs) {
+        if (this == std::addressof(rhs)) {
+            return;
+        }
+        if constexpr (alloc_traits::propagate_on_container_copy_assignment::value) {
+            if (heap_.alloc() != rhs.heap_.alloc()) {
+                release_();
+            }
+            heap_.alloc() = rhs.heap_.alloc();
+        }
+        assign_(rhs.base_data_(), rhs.base_size_());
+    }
+    void operator=(svbase&& rhs)
+        noexcept(std::is_nothrow_move_constructible_v<T> &&
+                 (alloc_traits::propagate_on_container_move_assignment::value || alloc_traits::is_always_equal::value))
+    {
+        if (this == std::addressof(rhs)) {
+            return;
+        }
+        constexpr bool pocma = alloc_traits::propagate_on_container_move_assignment::value;
+        if (rhs.spilled_() && (pocma || heap_.alloc() == rhs.heap_.alloc())) {
+            release_();
+            if constexpr (pocma) {
+                heap_.alloc() = std::move(rhs.heap_.alloc());
+            }
+            steal_(rhs);
+        } else {
+            if constexpr (pocma) {
+                if (heap_.alloc() != rhs.heap_.alloc()) {
+                    release_();
+                }
+                heap_.alloc() = std::move(rhs.heap_.alloc());
+            }
+            assign_(std::make_move_iterator(rhs.base_data_()), rhs.base_size_());
+        }
+    }
+
+    ~svbase() {
+        if (spilled_()) {
+            std::destroy_n(heap_.ptr_, heap_.size_);
+            alloc_traits::deallocate(heap_.alloc(), heap_.ptr_, heap_.cap_);
+        }
+    }
+
+    // Moves n elements from src to uninitialized dst, leaving src uninitialized.
+    // When T's move may throw but it can be copied, copies instead, so that
+    // an exception leaves src untouched.
+    static void relocate_(T *src, size_t n, T *dst) {
+        if constexpr (std::is_trivially_copyable_v<T>) {
+            if (n != 0) {
+                std::memcpy((void*)dst, (const void*)src, n * sizeof(T));
+            }
+#if defined(__cpp_lib_trivially_relocatable)
+        } else if constexpr (std::is_trivially_relocatable_v<T>) {
+            std::uninitialized_relocate(src, src + n, dst);
+#endif // __cpp_lib_trivially_relocatable
+        } else if constexpr (std::is_nothrow_move_constructible_v<T> || !std::is_copy_constructible_v<T>) {
+            std::uninitialized_move_n(src, n, dst);
+            std::destroy_n(src, n);
+        } else {
+            std::uninitialized_copy_n(src, n, dst);
+            std::destroy_n(src, n);
+        }
+    }
+
+    size_t grown_capacity_(size_t n) const noexcept {
+        size_t twice = 2 * base_capacity_();
+        return (n < twice) ? twice : n;
+    }
+
+    // Makes p, a heap buffer of cap elements whose first n are constructed,
+    // the new home of the elements. The old elements must already be gone.
+    void adopt_(T *p, size_t n, size_t cap) noexcept {
+        if (spilled_()) {
+            alloc_traits::deallocate(heap_.alloc(), heap_.ptr_, heap_.cap_);
+        } else {
+            small_.set_size_(0);
+        }
+        heap_.ptr_ = p;
+        heap_.size_ = n;
+        heap_.cap_ = cap;
+    }
+
+    void reallocate_(size_t cap) {
+        size_t n = base_size_();
+        T *p = alloc_traits::allocate(heap_.alloc(), cap);
+        try {
+            relocate_(base_data_(), n, p);
+        } catch (...) {
+            alloc_traits::deallocate(heap_.alloc(), p, cap);
+            throw;
+        }
+        adopt_(p, n, cap);
+    }
+
+    // Constructs the new element before relocating the old ones, in case args refer to them.
+    template<class... Args>
+    T& emplace_back_grow_(Args&&... args) {
+        size_t n = base_size_();
+        size_t cap = grown_capacity_(n + 1);
+        T *p = alloc_traits::allocate(heap_.alloc(), cap);
+        try {
+            ::new ((void*)(p + n)) T(static_cast<Args&&>(args)...);
+        } catch (...) {
+            alloc_traits::deallocate(heap_.alloc(), p, cap);
+            throw;
+        }
+        try {
+            relocate_(base_data_(), n, p);
+        } catch (...) {
+            std::destroy_at(p + n);
+            alloc_traits::deallocate(heap_.alloc(), p, cap);
+            throw;
+        }
+        adopt_(p, n + 1, cap);
+        return p[n];
+    }
+
+    // Destroys the elements and gives back the heap buffer, if any.
+    void release_() noexcept {
+        std::destroy_n(base_data_(), base_size_());
+        if (spilled_()) {
+            alloc_traits::deallocate(heap_.alloc(), heap_.ptr_, heap_.cap_);
+            heap_.ptr_ = nullptr;
+            heap_.size_ = 0;
+            heap_.cap_ = 0;
+        } else {
+            small_.set_size_(0);
+        }
+    }
+
+    // Fills an empty svbase with copies of [first, first + n).
+    template<class It>
+    void init_(It first, size_t n) {
+        if (n <= N) {
+            std::uninitialized_copy_n(first, n, small_.base_data_());
+            small_.set_size_(n);
+        } else {
+            T *p = alloc_traits::allocate(heap_.alloc(), n);
+            try {
+                std::uninitialized_copy_n(first, n, p);
+            } catch (...) {
+                alloc_traits::deallocate(heap_.alloc(), p, n);
+                throw;
+            }
+            adopt_(p, n, n);
+        }
+    }
+
+    template<class It>
+    void assign_(It first, size_t n) {
+        std::destroy_n(base_data_(), base_size_());
+        set_size_(0);
+        if (n > base_capacity_()) {
+            reallocate_(n);
+        }
+        std::uninitialized_copy_n(first, n, base_data_());
+        set_size_(n);
+    }
+
+    void steal_(svbase& rhs) noexcept {
+        if (rhs.spilled_()) {
+            heap_.ptr_ = std::exchange(rhs.heap_.ptr_, nullptr);
+            heap_.size_ = std::exchange(rhs.heap_.size_, 0);
+            heap_.cap_ = std::exchange(rhs.heap_.cap_, 0);
+        }
+    }
+};
+
+template<class T, size_t N, class Alloc = std::allocator<T>>
+class small_vector : ipvbase_assignable<T>, svbase<T, N, Alloc> {
+    static_assert(std::is_same_v<typename Alloc::value_type, T>, "small_vector<T, N, Alloc> requires Alloc::value_type to be T");
+    using svbase<T, N, Alloc>::base_data_;
+    using svbase<T, N, Alloc>::base_size_;
+    using svbase<T, N, Alloc>::base_capacity_;
+    using svbase<T, N, Alloc>::set_size_;
+    using alloc_traits = std::allocator_traits<Alloc>;
+public:
+    using value_type = T;
+    using allocator_type = Alloc;
+    using pointer = T*;
+    using const_pointer = const T*;
+    using reference = T&;
+    using const_reference = const T&;
+    using size_type = size_t;
+    using difference_type = ptrdiff_t;
+    using iterator = T*;
+    using const_iterator = const T*;
+    using reverse_iterator = std::reverse_iterator<iterator>;
+    using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+    small_vector() noexcept(noexcept(Alloc())) : small_vector(Alloc()) {}
+    explicit small_vector(const Alloc& a) noexcept : svbase<T, N, Alloc>(a) {}
+    small_vector(small_vector&&) = default;
+    small_vector(const small_vector&) = default;
+    small_vector(small_vector&& rhs, const Alloc& a) : svbase<T, N, Alloc>(std::move(rhs), a) {}
+    small_vector(const small_vector& rhs, const Alloc& a) : svbase<T, N, Alloc>(rhs, a) {}
+    small_vector& operator=(small_vector&&) = default;
+    small_vector& operator=(const small_vector&) = default;
+    small_vector& operator=(std::initializer_list<value_type> il) { assign(il.begin(), il.end()); return *this; }
+
+    small_vector(std::initializer_list<value_type> il, const Alloc& a = Alloc()) : small_vector(il.begin(), il.end(), a) { }
+    explicit small_vector(size_t n, const Alloc& a = Alloc()) : svbase<T, N, Alloc>(a) { resize(n); }
+    explicit small_vector(size_t n, const value_type& value, const Alloc& a = Alloc()) : svbase<T, N, Alloc>(a) { assign(n, value); }
+
+    template<class It, std::enable_if_t<std::is_base_of_v<std::input_iterator_tag, typename std::iterator_traits<It>::iterator_category>, int> = 0>
+    explicit small_vector(It first, It last, const Alloc& a = Alloc()) : svbase<T, N, Alloc>(a) { assign(first, last); }
+
+    void assign(std::initializer_list<value_type> il) { assign(il.begin(), il.end()); }
+
+    void assign(size_t n, const value_type& value) {
+        clear();
+        reserve(n);
+        std::uninitialized_fill_n(data(), n, value);
+        set_size_(n);
+    }
+
+    template<class It, std::enable_if_t<std::is_base_of_v<std::input_iterator_tag, typename std::iterator_traits<It>::iterator_category>, int> = 0>
+    void assign(It first, It last) {
+        if constexpr (std::is_base_of_v<std::forward_iterator_tag, typename std::iterator_traits<It>::iterator_category>) {
+            this->assign_(first, std::distance(first, last));
+        } else {
+            clear();
+            for (; first != last; ++first) {
+                emplace_back(*first);
+            }
+        }
+    }
+
+    allocator_type get_allocator() const noexcept { return this->heap_.alloc(); }
+
+    // iterators
+
+    iterator begin() noexcept { return data(); }
+    iterator end() noexcept { return data() + size(); }
+    const_iterator begin() const noexcept { return data(); }
+    const_iterator end() const noexcept { return data() + size(); }
+    reverse_iterator rbegin() noexcept { return reverse_iterator(end()); }
+    reverse_iterator rend() noexcept { return reverse_iterator(begin()); }
+    const_reverse_iterator rbegin() const noexcept { return const_reverse_iterator(end()); }
+    const_reverse_iterator rend() const noexcept { return const_reverse_iterator(begin()); }
+    const_iterator cbegin() const noexcept { return data(); }
+    const_iterator cend() const noexcept { return data() + size(); }
+    const_reverse_iterator crbegin() const noexcept { return const_reverse_iterator(end()); }
+    const_reverse_iterator crend() const noexcept { return const_reverse_iterator(begin()); }
+
+    void resize(size_type n) {
+        size_type m = size();
+        if (n < m) {
+            std::destroy(data() + n, data() + m);
+            set_size_(n);
+        } else if (n > m) {
+            reserve(n);
+            std::uninitialized_value_construct(data() + m, data() + n);
+            set_size_(n);
+        }
+    }
+
+    void resize(size_type n, const value_type& value) {
+        size_type m = size();
+        if (n < m) {
+            std::destroy(data() + n, data() + m);
+            set_size_(n);
+        } else if (n > m) {
+            insert(end(), n - m, value);
+        }
+    }
+
+    void reserve(size_type n) {
+        if (n > capacity()) {
+            this->reallocate_(n);
+        }
+    }
+
+    // Moves the elements back inline if they fit there.
+    void shrink_to_fit() {
+        if (!this->spilled_() || size() == capacity()) {
+            // nothing to give back
+        } else if (size() <= N) {
+            auto& heap = this->heap_;
+            if constexpr (N != 0) {
+                svbase<T, N, Alloc>::relocate_(heap.ptr_, heap.size_, this->small_.base_data_());
+                this->small_.set_size_(heap.size_);
+            }
+            alloc_traits::deallocate(heap.alloc(), heap.ptr_, heap.cap_);
+            heap.ptr_ = nullptr;
+            heap.size_ = 0;
+            heap.cap_ = 0;
+        } else {
+            this->reallocate_(size());
+        }
+    }
+
+    // element access
+
+    reference operator[](size_type i) { return data()[i]; }
+    reference front() { return data()[0]; }
+    reference back() { return data()[size() - 1]; }
+
+    const_reference operator[](size_type i) const { return data()[i]; }
+    const_reference front() const { return data()[0]; }
+    const_reference back() const { return data()[size() - 1]; }
+
+    reference at(size_type i) {
+        if (i >= size()) {
+            SG14_INPLACE_VECTOR_THROW(std::out_of_range("small_vector::at"));
+        }
+        return data()[i];
+    }
+    const_reference at(size_type i) const {
+        if (i >= size()) {
+            SG14_INPLACE_VECTOR_THROW(std::out_of_range("small_vector::at"));
+        }
+        return data()[i];
+    }
+
+    // data and capacity
+
+    T* data() noexcept { return base_data_(); }
+    const T* data() const noexcept { return base_data_(); }
+    size_type size() const noexcept { return base_size_(); }
+    size_type max_size() const noexcept { return alloc_traits::max_size(this->heap_.alloc()); }
+    size_type capacity() const noexcept { return base_capacity_(); }
+    [[nodiscard]] bool empty() const noexcept { return size() == 0; };
+
+    // modifiers
+
+    template<class... Args>
+    value_type& emplace_back(Args&&... args) {
+        size_type n = size();
+        if (n == capacity()) {
+            return this->emplace_back_grow_(static_cast<Args&&>(args)...);
+        }
+        value_type *p = ::new (data() + n) value_type(static_cast<Args&&>(args)...);
+        set_size_(n + 1);
+        return *p;
+    }
+    value_type& push_back(const value_type& value) { return emplace_back(value); }
+    value_type& push_back(value_type&& value) { return emplace_back(static_cast<value_type&&>(value)); }
+
+#if __cpp_lib_ranges >= 201911L && __cpp_lib_ranges_to_container >= 202202L
+    template<std::ranges::input_range R>
+        requires std::convertible_to<std::ranges::range_reference_t<R>, value_type>
+    void append_range(R&& rg) {
+        for (auto&& e : rg) {
+            emplace_back(static_cast<decltype(e)>(e));
+        }
+    }
+#endif // __cpp_lib_ranges >= 201911L && __cpp_lib_ranges_to_container >= 202202L
+
+    void pop_back() {
+        std::destroy_at(data() + size() - 1);
+        set_size_(size() - 1);
+    }
+
+    template<class... Args>
+    iterator emplace(const_iterator pos, Args&&... args) {
+        size_type i = pos - cbegin();
+        emplace_back(static_cast<Args&&>(args)...);
+        std::rotate(begin() + i, end() - 1, end());
+        return begin() + i;
+    }
+    iterator insert(const_iterator pos, const value_type& value) { return emplace(pos, value); }
+    iterator insert(const_iterator pos, value_type&& value) { return emplace(pos, static_cast<value_type&&>(value)); }
+
+    iterator insert(const_iterator pos, size_type n, const value_type& value) {
+        size_type i = pos - cbegin();
+        if (capacity() - size() < n) {
+            value_type copy = value;  // in case value is one of our elements
+            this->reallocate_(this->grown_capacity_(size() + n));
+            return insert_n_(i, n, copy);
+        }
+        return insert_n_(i, n, value);
+    }
+
+    template<class It, std::enable_if_t<std::is_base_of_v<std::input_iterator_tag, typename std::iterator_traits<It>::iterator_category>, int> = 0>
+    iterator insert(const_iterator pos, It first, It last) {
+        size_type i = pos - cbegin();
+        size_type m = size();
+        if constexpr (std::is_base_of_v<std::forward_iterator_tag, typename std::iterator_traits<It>::iterator_category>) {
+            size_type n = std::distance(first, last);
+            if (capacity() - m < n) {
+                this->reallocate_(this->grown_capacity_(m + n));
+            }
+            // Fill at the end of the vector, then rotate into place.
+            std::uninitialized_copy_n(first, n, data() + m);
+            set_size_(m + n);
+        } else {
+            for (; first != last; ++first) {
+                emplace_back(*first);
+            }
+        }
+        std::rotate(begin() + i, begin() + m, end());
+        return begin() + i;
+    }
+
+    iterator insert(const_iterator pos, std::initializer_list<value_type> il) { return insert(pos, il.begin(), il.end()); }
+
+    iterator erase(const_iterator pos) {
+        auto it = iterator(pos);
+        auto oldend = end();
+        if constexpr (ipv_trivially_relocatable_v<value_type>) {
+            std::destroy_at(it);
+            ipv_relocate(it + 1, oldend, it);
+            set_size_(size() - 1);
+            return it;
+        }
+        std::move(it + 1, oldend, it);
+        std::destroy_at(oldend - 1);
+        set_size_(size() - 1);
+        return it;
+    }
+
+    iterator erase(const_iterator first, const_iterator last) {
+        auto ifirst = iterator(first);
+        auto ilast = iterator(last);
+        auto n = ilast - ifirst;
+        if (n != 0) {
+            auto oldend = end();
+            if constexpr (ipv_trivially_relocatable_v<value_type>) {
+                std::destroy(ifirst, ilast);
+                ipv_relocate(ilast, oldend, ifirst);
+                set_size_(size() - n);
+                return ifirst;
+            }
+            std::destroy(std::move(ilast, oldend, ifirst), oldend);
+            set_size_(size() - n);
+        }
+        return ifirst;
+    }
+
+    void clear() noexcept {
+        std::destroy(data(), data() + size());
+        set_size_(0);
+    }
+
+    void swap(small_vector& b)
+        noexcept(std::is_nothrow_move_constructible_v<small_vector> && std::is_nothrow_move_assignable_v<small_vector>)
+    {
+        small_vector tmp(std::move(b));
+        b = std::move(*this);
+        *this = std::move(tmp);
+    }
+
+    friend void swap(small_vector& a, small_vector& b) noexcept(noexcept(a.swap(b))) {
+        a.swap(b);
+    }
+
+    friend bool operator==(const small_vector& a, const small_vector& b) {
+        return std::equal(a.begin(), a.end(), b.begin(), b.end());
+    }
+#if __cpp_impl_three_way_comparison >= 201907L
+    friend auto operator<=>(const small_vector& a, const small_vector& b) {
+        return std::lexicographical_compare_three_way(a.begin(), a.end(), b.begin(), b.end());
+    }
+#else
+    friend bool operator<(const small_vector& a, const small_vector& b) {
+        return std::lexicographical_compare(a.begin(), a.end(), b.begin(), b.end());
+    }
+    friend bool operator>(const small_vector& a, const small_vector& b) { return (b < a); }
+    friend bool operator<=(const small_vector& a, const small_vector& b) { return !(b < a); }
+    friend bool operator>=(const small_vector& a, const small_vector& b) { return !(a < b); }
+    friend bool operator!=(const small_vector& a, const small_vector& b) { return !(a == b); }
+#endif
+
+private:
+    iterator insert_n_(size_type i, size_type n, const value_type& value) {
+        size_type m = size();
+        std::uninitialized_fill_n(data() + m, n, value);
+        set_size_(m + n);
+        std::rotate(begin() + i, begin() + m, end());
+        return begin() + i;
+    }
+};
+
+template<class T, size_t N, class Alloc, class Predicate>
+typename small_vector<T, N, Alloc>::size_type
+erase_if(small_vector<T, N, Alloc>& c, Predicate pred)
+{
+    auto it = std::remove_if(c.begin(), c.end(), pred);
+    auto r = std::distance(it, c.end());
+    c.erase(it, c.end());
+    return r;
+}
+
 } // namespace sg14
@@ -1,9 +1,13 @@
 #pragma once
 
 #include <stddef.h>
+#include <algorithm>
+#include <atomic>
 #include <cassert>
 #include <iterator>
+#include <memory>
 #include <type_traits>
+#include <utility>
 
 namespace sg14
 {
@@ -25,13 +29,56 @@ namespace sg14
     T m_copy;
   };
 
+  namespace ring_span_detail {
+    // Large enough for the cache lines of every mainstream x86 and ARM core.
+    constexpr std::size_t cache_line_size = 64;
+
+    inline std::size_t floor_pow2(std::size_t n) noexcept {
+      std::size_t p = 1;
+      while (p <= n / 2) p *= 2;
+      return p;
+    }
+
+    template<class It>
+    using qualifies_as_input_iterator = std::integral_constant<bool, !std::is_integral<It>::value>;
+  } // namespace ring_span_detail
+
+  // Capacity policies for ring_span. Each one holds (or hard-codes) the size of
+  // the underlying range, and maps a logical index into it.
+  struct dynamic_capacity {
+    explicit dynamic_capacity(std::size_t n) noexcept : m_n(n) {}
+    std::size_t value() const noexcept { return m_n; }
+    std::size_t wrap(std::size_t i) const noexcept { return i % m_n; }
+  private:
+    std::size_t m_n;
+  };
+
+  // The range's size must be a power of two, so wrapping is a mask instead of a division.
+  struct pow2_capacity {
+    explicit pow2_capacity(std::size_t n) noexcept : m_mask(n - 1) { assert(n != 0 && (n & (n - 1)) == 0); }
+    std::size_t value() const noexcept { return m_mask + 1; }
+    std::size_t wrap(std::size_t i) const noexcept { return i & m_mask; }
+  private:
+    std::size_t m_mask;
+  };
+
+  // The range's size must be N. With the capacity a compile-time constant, wrapping
+  // is a mask (or a multiply) and loops over the ring can be unrolled.
+  template<std::size_t N>
+  struct static_capacity {
+    static_assert(N != 0, "a ring_span can't have zero capacity");
+    explicit static_capacity(std::size_t n) noexcept { assert(n == N); (void)n; }
+    static constexpr std::size_t value() noexcept { return N; }
+    static constexpr std::size_t wrap(std::size_t i) noexcept { return i % N; }
+  };
+
   template <typename, bool>
   class ring_iterator;
 
-  template<typename T, class Popper = default_popper<T>>
+  template<typename T, class Popper = default_popper<T>, class Capacity = dynamic_capacity>
   class ring_span {
   public:
-    using type = ring_span<T, Popper>;
+    using type = ring_span<T, Popper, Capacity>;
     using size_type = std::size_t;
     using value_type = T;
     using pointer = T*;
@@ -41,6 +88,9 @@ namespace sg14
     using const_iterator = ring_iterator<type, true>;
     using reverse_iterator = std::reverse_iterator<iterator>;
     using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+    using capacity_type = Capacity;
+    using segment = std::pair<pointer, size_type>;
+    using const_segment = std::pair<const T*, size_type>;
 
     friend class ring_iterator<type, false>;
     friend class ring_iterator<type, true>;
@@ -86,6 +136,29 @@ namespace sg14
     void emplace_back(FromType&&... from_value) noexcept(std::is_nothrow_constructible<T, FromType...>::value && std::is_nothrow_move_assignable<T>::value);
     auto pop_front();
 
+    // Pushes each element of [first, last) as if by push_back, overwriting the
+    // oldest elements if the ring fills up, but copies whole contiguous runs at a time.
+    template<class InputIterator, class = std::enable_if_t<ring_span_detail::qualifies_as_input_iterator<InputIterator>::value>>
+    void push_back(InputIterator first, InputIterator last);
+    // Pops the first n elements, writing the Popper's result for each to out.
+    template<class OutputIterator>
+    OutputIterator pop_front_n(size_type n, OutputIterator out);
+    // Pops the first n elements, discarding the Popper's results.
+    void pop_front_n(size_type n);
+
+    // The elements from front to back, as at most two contiguous runs;
+    // the second is empty unless the elements wrap around the end of the range.
+    std::pair<segment, segment> readable_segments() noexcept;
+    std::pair<const_segment, const_segment> readable_segments() const noexcept;
+    // The slots not holding elements, in the order push_back would fill them.
+    std::pair<segment, segment> writable_segments() noexcept;
+    // After writing n elements into the writable segments, makes them the
+    // new back of the ring. n must not exceed capacity() - size().
+    void commit_back(size_type n) noexcept;
+    // After reading n elements from the readable segments, drops them from
+    // the front of the ring without calling the Popper.
+    void consume_front(size_type n) noexcept;
+
     void swap(type& rhs) noexcept;// (std::is_nothrow_swappable<Popper>::value);
 
     // Example implementation
@@ -94,16 +167,20 @@ namespace sg14
     const_reference at(size_type idx) const noexcept;
     size_type back_idx() const noexcept;
     void increase_size() noexcept;
+    template<class OutputIterator>
+    OutputIterator pop_run(T* p, size_type run, OutputIterator out, std::true_type);
+    template<class OutputIterator>
+    OutputIterator pop_run(T* p, size_type run, OutputIterator out, std::false_type);
 
     T* m_data;
     size_type m_size;
-    size_type m_capacity;
+    Capacity m_capacity;
     size_type m_front_idx;
     Popper m_popper;
   };
 
-  template<typename T, class Popper>
-  void swap(ring_span<T, Popper>&, ring_span<T, Popper>&) noexcept;
+  template<typename T, class Popper, class Capacity>
+  void swap(ring_span<T, Popper, Capacity>&, ring_span<T, Popper, Capacity>&) noexcept;
 
   template <typename Ring, bool is_const>
   class ring_iterator {
@@ -157,6 +234,111 @@ namespace sg14
 
   template <typename Ring, bool C>
   ring_iterator<Ring, C> operator-(ring_iterator<Ring, C> it, std::ptrdiff_t) noexcept;
+
+  // A ring_span that one producer thread and one consumer thread may use at once.
+  // The capacity is the largest power of two that fits in [begin, end).
+  // try_push and try_pop never block; they return false if the ring is full
+  // (respectively, empty).
+  template<typename T, class Popper = default_popper<T>>
+  class spsc_ring_span {
+  public:
+    using size_type = std::size_t;
+    using value_type = T;
+
+    template <class ContiguousIterator>
+    spsc_ring_span(ContiguousIterator begin, ContiguousIterator end, Popper p = Popper()) noexcept;
+
+    spsc_ring_span(const spsc_ring_span&) = delete;
+    spsc_ring_span& operator=(const spsc_ring_span&) = delete;
+
+    // These are snapshots; they may be stale by the time the caller looks at them.
+    bool empty() const noexcept;
+    bool full() const noexcept;
+    size_type size() const noexcept;
+    size_type capacity() const noexcept;
+
+    // Producer side.
+    bool try_push(const value_type& from_value);
+    bool try_push(value_type&& from_value);
+    template<class... FromType>
+    bool try_emplace(FromType&&... from_value);
+
+    // Consumer side. try_pop(out) assigns the Popper's result to out;
+    // try_pop() discards it, which is the only form usable with null_popper.
+    bool try_pop();
+    template<class U>
+    bool try_pop(U& out);
+
+    // Example implementation
+  private:
+    template<class F>
+    bool push_impl(F&& assign);
+    template<class F>
+    bool pop_impl(F&& consume);
+
+    T* m_data;
+    size_type m_mask;
+    Popper m_popper;
+    // Written by the producer.
+    alignas(ring_span_detail::cache_line_size) std::atomic<size_type> m_tail;
+    size_type m_head_cache;
+    // Written by the consumer.
+    alignas(ring_span_detail::cache_line_size) std::atomic<size_type> m_head;
+    size_type m_tail_cache;
+  };
+
+  // A ring_span that any number of producer and consumer threads may use at once.
+  // Like Dmitry Vyukov's bounded MPMC queue, each slot has a sequence number
+  // that says whether it is ready to be written or read; those live in an array
+  // allocated by the constructor, while the elements stay in [begin, end).
+  // try_push and try_pop never wait for another thread: if the slot they need
+  // is still in use, they report the ring as full (respectively, empty).
+  template<typename T, class Popper = default_popper<T>>
+  class mpmc_ring_span {
+  public:
+    using size_type = std::size_t;
+    using value_type = T;
+
+    template <class ContiguousIterator>
+    mpmc_ring_span(ContiguousIterator begin, ContiguousIterator end, Popper p = Popper());
+
+    mpmc_ring_span(const mpmc_ring_span&) = delete;
+    mpmc_ring_span& operator=(const mpmc_ring_span&) = delete;
+
+    // These are snapshots; they may be stale by the time the caller looks at them.
+    bool empty() const noexcept;
+    bool full() const noexcept;
+    size_type size() const noexcept;
+    size_type capacity() const noexcept;
+
+    bool try_push(const value_type& from_value);
+    bool try_push(value_type&& from_value);
+    template<class... FromType>
+    bool try_emplace(FromType&&... from_value);
+
+    bool try_pop();
+    template<class U>
+    bool try_pop(U& out);
+
+    // Example implementation
+  private:
+    // Publishes a claimed slot on scope exit, even if filling or draining it threw.
+    struct seq_release {
+      std::atomic<size_type>& seq;
+      size_type next;
+      ~seq_release() { seq.store(next, std::memory_order_release); }
+    };
+
+    bool claim(std::atomic<size_type>& counter, size_type lag, size_type& pos) noexcept;
+    void push_claimed(size_type pos, T&& value);
+
+    T* m_data;
+    size_type m_mask;
+    Popper m_popper;
+    std::unique_ptr<std::atomic<size_type>[]> m_seq;
+    alignas(ring_span_detail::cache_line_size) std::atomic<size_type> m_tail;
+    alignas(ring_span_detail::cache_line_size) std::atomic<size_type> m_head;
+  };
 } // namespace sg14
 
 // Sample implementation
@@ -181,9 +363,9 @@ T sg14::copy_popper<T>::operator()(T& t) const {
   return old;
 }
 
-template<typename T, class Popper>
+template<typename T, class Popper, class Capacity>
 template<class ContiguousIterator>
-sg14::ring_span<T, Popper>::ring_span(ContiguousIterator begin, ContiguousIterator end, Popper p) noexcept
+sg14::ring_span<T, Popper, Capacity>::ring_span(ContiguousIterator begin, ContiguousIterator end, Popper p) noexcept
   : m_data(&*begin)
   , m_size(0)
   , m_capacity(end - begin)
@@ -191,9 +373,9 @@ sg14::ring_span<T, Popper>::ring_span(ContiguousIterator begin, ContiguousIterat
   , m_popper(std::move(p))
 {}
 
-template<typename T, class Popper>
+template<typename T, class Popper, class Capacity>
 template<class ContiguousIterator>
-sg14::ring_span<T, Popper>::ring_span(ContiguousIterator begin, ContiguousIterator end, ContiguousIterator first, size_type size, Popper p) noexcept
+sg14::ring_span<T, Popper, Capacity>::ring_span(ContiguousIterator begin, ContiguousIterator end, ContiguousIterator first, size_type size, Popper p) noexcept
   : m_data(&*begin)
   , m_size(size)
   , m_capacity(end - begin)
@@ -201,155 +383,267 @@ sg14::ring_span<T, Popper>::ring_span(ContiguousIterator begin, ContiguousIterat
   , m_popper(std::move(p))
 {}
 
-template<typename T, class Popper>
-bool sg14::ring_span<T, Popper>::empty() const noexcept {
+template<typename T, class Popper, class Capacity>
+bool sg14::ring_span<T, Popper, Capacity>::empty() const noexcept {
   return m_size == 0;
 }
 
-template<typename T, class Popper>
-bool sg14::ring_span<T, Popper>::full() const noexcept {
-  return m_size == m_capacity;
+template<typename T, class Popper, class Capacity>
+bool sg14::ring_span<T, Popper, Capacity>::full() const noexcept {
+  return m_size == capacity();
 }
 
-template<typename T, class Popper>
-typename sg14::ring_span<T, Popper>::size_type sg14::ring_span<T, Popper>::size() const noexcept {
+template<typename T, class Popper, class Capacity>
+typename sg14::ring_span<T, Popper, Capacity>::size_type sg14::ring_span<T, Popper, Capacity>::size() const noexcept {
   return m_size;
 }
 
-template<typename T, class Popper>
-typename sg14::ring_span<T, Popper>::size_type sg14::ring_span<T, Popper>::capacity() const noexcept {
-  return m_capacity;
+template<typename T, class Popper, class Capacity>
+typename sg14::ring_span<T, Popper, Capacity>::size_type sg14::ring_span<T, Popper, Capacity>::capacity() const noexcept {
+  return m_capacity.value();
 }
 
-template<typename T, class Popper>
-typename sg14::ring_span<T, Popper>::reference sg14::ring_span<T, Popper>::front() noexcept {
+template<typename T, class Popper, class Capacity>
+typename sg14::ring_span<T, Popper, Capacity>::reference sg14::ring_span<T, Popper, Capacity>::front() noexcept {
   return *begin();
 }
 
-template<typename T, class Popper>
-typename sg14::ring_span<T, Popper>::reference sg14::ring_span<T, Popper>::back() noexcept {
+template<typename T, class Popper, class Capacity>
+typename sg14::ring_span<T, Popper, Capacity>::reference sg14::ring_span<T, Popper, Capacity>::back() noexcept {
   return *(--end());
 }
 
-template<typename T, class Popper>
-typename sg14::ring_span<T, Popper>::const_reference sg14::ring_span<T, Popper>::front() const noexcept {
+template<typename T, class Popper, class Capacity>
+typename sg14::ring_span<T, Popper, Capacity>::const_reference sg14::ring_span<T, Popper, Capacity>::front() const noexcept {
   return *begin();
 }
 
-template<typename T, class Popper>
-typename sg14::ring_span<T, Popper>::const_reference sg14::ring_span<T, Popper>::back() const noexcept
+template<typename T, class Popper, class Capacity>
+typename sg14::ring_span<T, Popper, Capacity>::const_reference sg14::ring_span<T, Popper, Capacity>::back() const noexcept
 {
   return *(--end());
 }
 
-template<typename T, class Popper>
-typename sg14::ring_span<T, Popper>::iterator sg14::ring_span<T, Popper>::begin() noexcept
+template<typename T, class Popper, class Capacity>
+typename sg14::ring_span<T, Popper, Capacity>::iterator sg14::ring_span<T, Popper, Capacity>::begin() noexcept
 {
   return iterator(m_front_idx, this);
 }
 
-template<typename T, class Popper>
-typename sg14::ring_span<T, Popper>::const_iterator sg14::ring_span<T, Popper>::begin() const noexcept
+template<typename T, class Popper, class Capacity>
+typename sg14::ring_span<T, Popper, Capacity>::const_iterator sg14::ring_span<T, Popper, Capacity>::begin() const noexcept
 {
   return const_iterator(m_front_idx, this);
 }
 
-template<typename T, class Popper>
-typename sg14::ring_span<T, Popper>::iterator sg14::ring_span<T, Popper>::end() noexcept
+template<typename T, class Popper, class Capacity>
+typename sg14::ring_span<T, Popper, Capacity>::iterator sg14::ring_span<T, Popper, Capacity>::end() noexcept
 {
   return iterator(size() + m_front_idx, this);
 }
 
-template<typename T, class Popper>
-typename sg14::ring_span<T, Popper>::const_iterator sg14::ring_span<T, Popper>::end() const noexcept
+template<typename T, class Popper, class Capacity>
+typename sg14::ring_span<T, Popper, Capacity>::const_iterator sg14::ring_span<T, Popper, Capacity>::end() const noexcept
 {
   return const_iterator(size() + m_front_idx, this);
 }
 
-template<typename T, class Popper>
-typename sg14::ring_span<T, Popper>::const_iterator sg14::ring_span<T, Popper>::cbegin() const noexcept
+template<typename T, class Popper, class Capacity>
+typename sg14::ring_span<T, Popper, Capacity>::const_iterator sg14::ring_span<T, Popper, Capacity>::cbegin() const noexcept
 {
   return begin();
 }
 
-template<typename T, class Popper>
-typename sg14::ring_span<T, Popper>::reverse_iterator sg14::ring_span<T, Popper>::rbegin() noexcept
+template<typename T, class Popper, class Capacity>
+typename sg14::ring_span<T, Popper, Capacity>::reverse_iterator sg14::ring_span<T, Popper, Capacity>::rbegin() noexcept
 {
   return reverse_iterator(end());
 }
 
-template<typename T, class Popper>
-typename sg14::ring_span<T, Popper>::const_reverse_iterator sg14::ring_span<T, Popper>::rbegin() const noexcept
+template<typename T, class Popper, class Capacity>
+typename sg14::ring_span<T, Popper, Capacity>::const_reverse_iterator sg14::ring_span<T, Popper, Capacity>::rbegin() const noexcept
 {
   return const_reverse_iterator(end());
 }
 
-template<typename T, class Popper>
-typename sg14::ring_span<T, Popper>::const_reverse_iterator sg14::ring_span<T, Popper>::crbegin() const noexcept
+template<typename T, class Popper, class Capacity>
+typename sg14::ring_span<T, Popper, Capacity>::const_reverse_iterator sg14::ring_span<T, Popper, Capacity>::crbegin() const noexcept
 {
   return const_reverse_iterator(end());
 }
 
-template<typename T, class Popper>
-typename sg14::ring_span<T, Popper>::const_iterator sg14::ring_span<T, Popper>::cend() const noexcept
+template<typename T, class Popper, class Capacity>
+typename sg14::ring_span<T, Popper, Capacity>::const_iterator sg14::ring_span<T, Popper, Capacity>::cend() const noexcept
 {
   return end();
 }
 
-template<typename T, class Popper>
-typename sg14::ring_span<T, Popper>::reverse_iterator sg14::ring_span<T, Popper>::rend() noexcept
+template<typename T, class Popper, class Capacity>
+typename sg14::ring_span<T, Popper, Capacity>::reverse_iterator sg14::ring_span<T, Popper, Capacity>::rend() noexcept
 {
   return reverse_iterator(begin());
 }
 
-template<typename T, class Popper>
-typename sg14::ring_span<T, Popper>::const_reverse_iterator sg14::ring_span<T, Popper>::rend() const noexcept
+template<typename T, class Popper, class Capacity>
+typename sg14::ring_span<T, Popper, Capacity>::const_reverse_iterator sg14::ring_span<T, Popper, Capacity>::rend() const noexcept
 {
   return const_reverse_iterator(begin());
 }
 
-template<typename T, class Popper>
-typename sg14::ring_span<T, Popper>::const_reverse_iterator sg14::ring_span<T, Popper>::crend() const noexcept
+template<typename T, class Popper, class Capacity>
+typename sg14::ring_span<T, Popper, Capacity>::const_reverse_iterator sg14::ring_span<T, Popper, Capacity>::crend() const noexcept
 {
   return const_reverse_iterator(begin());
 }
 
-template<typename T, class Popper>
+template<typename T, class Popper, class Capacity>
 template<bool b, typename>
-void sg14::ring_span<T, Popper>::push_back(const T& value) noexcept(std::is_nothrow_copy_assignable<T>::value)
+void sg14::ring_span<T, Popper, Capacity>::push_back(const T& value) noexcept(std::is_nothrow_copy_assignable<T>::value)
 {
   m_data[back_idx()] = value;
   increase_size();
 }
 
-template<typename T, class Popper>
+template<typename T, class Popper, class Capacity>
 template<bool b, typename>
-void sg14::ring_span<T, Popper>::push_back(T&& value) noexcept(std::is_nothrow_move_assignable<T>::value)
+void sg14::ring_span<T, Popper, Capacity>::push_back(T&& value) noexcept(std::is_nothrow_move_assignable<T>::value)
 {
   m_data[back_idx()] = std::move(value);
   increase_size();
 }
 
-template<typename T, class Popper>
+template<typename T, class Popper, class Capacity>
 template<class... FromType>
-void sg14::ring_span<T, Popper>::emplace_back(FromType&&... from_value) noexcept(std::is_nothrow_constructible<T, FromType...>::value && std::is_nothrow_move_assignable<T>::value)
+void sg14::ring_span<T, Popper, Capacity>::emplace_back(FromType&&... from_value) noexcept(std::is_nothrow_constructible<T, FromType...>::value && std::is_nothrow_move_assignable<T>::value)
 {
   m_data[back_idx()] = T(std::forward<FromType>(from_value)...);
   increase_size();
 }
 
-template<typename T, class Popper>
-auto sg14::ring_span<T, Popper>::pop_front()
+template<typename T, class Popper, class Capacity>
+auto sg14::ring_span<T, Popper, Capacity>::pop_front()
 {
   assert(m_size != 0);
   auto old_front_idx = m_front_idx;
-  m_front_idx = (m_front_idx + 1) % m_capacity;
+  m_front_idx = m_capacity.wrap(m_front_idx + 1);
   --m_size;
   return m_popper(m_data[old_front_idx]);
 }
 
-template<typename T, class Popper>
-void sg14::ring_span<T, Popper>::swap(sg14::ring_span<T, Popper>& rhs) noexcept//(std::is_nothrow_swappable<Popper>::value)
+template<typename T, class Popper, class Capacity>
+template<class InputIterator, class>
+void sg14::ring_span<T, Popper, Capacity>::push_back(InputIterator first, InputIterator last)
+{
+  using Category = typename std::iterator_traits<InputIterator>::iterator_category;
+  if (!std::is_base_of<std::forward_iterator_tag, Category>::value) {
+    for (; first != last; ++first) {
+      push_back(*first);
+    }
+    return;
+  }
+  size_type n = std::distance(first, last);
+  if (n > capacity()) {
+    // Everything but the last capacity() elements would be overwritten anyway.
+    std::advance(first, n - capacity());
+    n = capacity();
+  }
+  size_type back = back_idx();
+  size_type run = (n < capacity() - back) ? n : capacity() - back;
+  InputIterator mid = std::next(first, run);
+  std::copy(first, mid, m_data + back);
+  std::copy(mid, last, m_data);
+  if (m_size + n > capacity()) {
+    m_front_idx = m_capacity.wrap(m_front_idx + (m_size + n - capacity()));
+    m_size = capacity();
+  } else {
+    m_size += n;
+  }
+}
+
+template<typename T, class Popper, class Capacity>
+template<class OutputIterator>
+OutputIterator sg14::ring_span<T, Popper, Capacity>::pop_front_n(size_type n, OutputIterator out)
+{
+  assert(n <= m_size);
+  while (n != 0) {
+    size_type run = (n < capacity() - m_front_idx) ? n : capacity() - m_front_idx;
+    out = pop_run(m_data + m_front_idx, run, out, std::is_same<Popper, default_popper<T>>());
+    m_front_idx = m_capacity.wrap(m_front_idx + run);
+    m_size -= run;
+    n -= run;
+  }
+  return out;
+}
+
+template<typename T, class Popper, class Capacity>
+template<class OutputIterator>
+OutputIterator sg14::ring_span<T, Popper, Capacity>::pop_run(T* p, size_type run, OutputIterator out, std::true_type)
+{
+  // default_popper just moves from each element, so let std::move see the whole
+  // run; for trivially copyable T and a pointer out, that's a memmove.
+  return std::move(p, p + run, out);
+}
+
+template<typename T, class Popper, class Capacity>
+template<class OutputIterator>
+OutputIterator sg14::ring_span<T, Popper, Capacity>::pop_run(T* p, size_type run, OutputIterator out, std::false_type)
+{
+  for (size_type i = 0; i < run; ++i) {
+    *out = m_popper(p[i]);
+    ++out;
+  }
+  return out;
+}
+
+template<typename T, class Popper, class Capacity>
+void sg14::ring_span<T, Popper, Capacity>::pop_front_n(size_type n)
+{
+  assert(n <= m_size);
+  for (; n != 0; --n) {
+    pop_front();
+  }
+}
+
+template<typename T, class Popper, class Capacity>
+auto sg14::ring_span<T, Popper, Capacity>::readable_segments() noexcept -> std::pair<segment, segment>
+{
+  size_type run = (m_size < capacity() - m_front_idx) ? m_size : capacity() - m_front_idx;
+  return {segment(m_data + m_front_idx, run), segment(m_data, m_size - run)};
+}
+
+template<typename T, class Popper, class Capacity>
+auto sg14::ring_span<T, Popper, Capacity>::readable_segments() const noexcept -> std::pair<const_segment, const_segment>
+{
+  size_type run = (m_size < capacity() - m_front_idx) ? m_size : capacity() - m_front_idx;
+  return {const_segment(m_data + m_front_idx, run), const_segment(m_data, m_size - run)};
+}
+
+template<typename T, class Popper, class Capacity>
+auto sg14::ring_span<T, Popper, Capacity>::writable_segments() noexcept -> std::pair<segment, segment>
+{
+  size_type back = back_idx();
+  size_type free = capacity() - m_size;
+  size_type run = (free < capacity() - back) ? free : capacity() - back;
+  return {segment(m_data + back, run), segment(m_data, free - run)};
+}
+
+template<typename T, class Popper, class Capacity>
+void sg14::ring_span<T, Popper, Capacity>::commit_back(size_type n) noexcept
+{
+  assert(n <= capacity() - m_size);
+  m_size += n;
+}
+
+template<typename T, class Popper, class Capacity>
+void sg14::ring_span<T, Popper, Capacity>::consume_front(size_type n) noexcept
+{
+  assert(n <= m_size);
+  m_front_idx = m_capacity.wrap(m_front_idx + n);
+  m_size -= n;
+}
+
+template<typename T, class Popper, class Capacity>
+void sg14::ring_span<T, Popper, Capacity>::swap(sg14::ring_span<T, Popper, Capacity>& rhs) noexcept//(std::is_nothrow_swappable<Popper>::value)
 {
   using std::swap;
   swap(m_data, rhs.m_data);
@@ -359,31 +653,31 @@ void sg14::ring_span<T, Popper>::swap(sg14::ring_span<T, Popper>& rhs) noexcept/
   swap(m_popper, rhs.m_popper);
 }
 
-template<typename T, class Popper>
-typename sg14::ring_span<T, Popper>::reference sg14::ring_span<T, Popper>::at(size_type i) noexcept
+template<typename T, class Popper, class Capacity>
+typename sg14::ring_span<T, Popper, Capacity>::reference sg14::ring_span<T, Popper, Capacity>::at(size_type i) noexcept
 {
-  return m_data[i % m_capacity];
+  return m_data[m_capacity.wrap(i)];
 }
 
-template<typename T, class Popper>
-typename sg14::ring_span<T, Popper>::const_reference sg14::ring_span<T, Popper>::at(size_type i) const noexcept
+template<typename T, class Popper, class Capacity>
+typename sg14::ring_span<T, Popper, Capacity>::const_reference sg14::ring_span<T, Popper, Capacity>::at(size_type i) const noexcept
 {
-  return m_data[i % m_capacity];
+  return m_data[m_capacity.wrap(i)];
 }
 
-template<typename T, class Popper>
-typename sg14::ring_span<T, Popper>::size_type sg14::ring_span<T, Popper>::back_idx() const noexcept
+template<typename T, class Popper, class Capacity>
+typename sg14::ring_span<T, Popper, Capacity>::size_type sg14::ring_span<T, Popper, Capacity>::back_idx() const noexcept
 {
-  return (m_front_idx + m_size) % m_capacity;
+  return m_capacity.wrap(m_front_idx + m_size);
 }
 
-template<typename T, class Popper>
-void sg14::ring_span<T, Popper>::increase_size() noexcept
+template<typename T, class Popper, class Capacity>
+void sg14::ring_span<T, Popper, Capacity>::increase_size() noexcept
 {
-  if (++m_size > m_capacity)
+  if (++m_size > capacity())
   {
-    m_size = m_capacity;
-    m_front_idx = (m_front_idx + 1) % m_capacity;
+    m_size = capacity();
+    m_front_idx = m_capacity.wrap(m_front_idx + 1);
   }
 }
 
@@ -499,10 +793,240 @@ sg14::ring_iterator<Ring, is_const>::ring_iterator(typename sg14::ring_iterator<
 {}
 
 
+template<typename T, class Popper>
+template<class ContiguousIterator>
+sg14::spsc_ring_span<T, Popper>::spsc_ring_span(ContiguousIterator begin, ContiguousIterator end, Popper p) noexcept
+  : m_data(&*begin)
+  , m_mask(sg14::ring_span_detail::floor_pow2(end - begin) - 1)
+  , m_popper(std::move(p))
+  , m_tail(0)
+  , m_head_cache(0)
+  , m_head(0)
+  , m_tail_cache(0)
+{
+  assert(end - begin >= 1);
+}
+
+template<typename T, class Popper>
+bool sg14::spsc_ring_span<T, Popper>::empty() const noexcept
+{
+  return size() == 0;
+}
+
+template<typename T, class Popper>
+bool sg14::spsc_ring_span<T, Popper>::full() const noexcept
+{
+  return size() == capacity();
+}
+
+template<typename T, class Popper>
+typename sg14::spsc_ring_span<T, Popper>::size_type sg14::spsc_ring_span<T, Popper>::size() const noexcept
+{
+  size_type head = m_head.load(std::memory_order_acquire);
+  return m_tail.load(std::memory_order_acquire) - head;
+}
+
+template<typename T, class Popper>
+typename sg14::spsc_ring_span<T, Popper>::size_type sg14::spsc_ring_span<T, Popper>::capacity() const noexcept
+{
+  return m_mask + 1;
+}
+
+template<typename T, class Popper>
+bool sg14::spsc_ring_span<T, Popper>::try_push(const T& value)
+{
+  return push_impl([&](T& slot) { slot = value; });
+}
+
+template<typename T, class Popper>
+bool sg14::spsc_ring_span<T, Popper>::try_push(T&& value)
+{
+  return push_impl([&](T& slot) { slot = std::move(value); });
+}
+
+template<typename T, class Popper>
+template<class... FromType>
+bool sg14::spsc_ring_span<T, Popper>::try_emplace(FromType&&... from_value)
+{
+  return push_impl([&](T& slot) { slot = T(std::forward<FromType>(from_value)...); });
+}
+
+template<typename T, class Popper>
+bool sg14::spsc_ring_span<T, Popper>::try_pop()
+{
+  return pop_impl([&](T& slot) { m_popper(slot); });
+}
+
+template<typename T, class Popper>
+template<class U>
+bool sg14::spsc_ring_span<T, Popper>::try_pop(U& out)
+{
+  return pop_impl([&](T& slot) { out = m_popper(slot); });
+}
+
+template<typename T, class Popper>
+template<class F>
+bool sg14::spsc_ring_span<T, Popper>::push_impl(F&& assign)
+{
+  size_type tail = m_tail.load(std::memory_order_relaxed);
+  if (tail - m_head_cache > m_mask) {
+    // Only go to the consumer's cache line when the ring looks full.
+    m_head_cache = m_head.load(std::memory_order_acquire);
+    if (tail - m_head_cache > m_mask) {
+      return false;
+    }
+  }
+  // If this throws, the element is never published.
+  assign(m_data[tail & m_mask]);
+  m_tail.store(tail + 1, std::memory_order_release);
+  return true;
+}
+
+template<typename T, class Popper>
+template<class F>
+bool sg14::spsc_ring_span<T, Popper>::pop_impl(F&& consume)
+{
+  size_type head = m_head.load(std::memory_order_relaxed);
+  if (head == m_tail_cache) {
+    m_tail_cache = m_tail.load(std::memory_order_acquire);
+    if (head == m_tail_cache) {
+      return false;
+    }
+  }
+  consume(m_data[head & m_mask]);
+  m_head.store(head + 1, std::memory_order_release);
+  return true;
+}
+
+template<typename T, class Popper>
+template<class ContiguousIterator>
+sg14::mpmc_ring_span<T, Popper>::mpmc_ring_span(ContiguousIterator begin, ContiguousIterator end, Popper p)
+  : m_data(&*begin)
+  , m_mask(sg14::ring_span_detail::floor_pow2(end - begin) - 1)
+  , m_popper(std::move(p))
+  , m_seq(new std::atomic<size_type>[m_mask + 1])
+  , m_tail(0)
+  , m_head(0)
+{
+  assert(end - begin >= 1);
+  for (size_type i = 0; i <= m_mask; ++i) {
+    m_seq[i].store(i, std::memory_order_relaxed);
+  }
+}
+
+template<typename T, class Popper>
+bool sg14::mpmc_ring_span<T, Popper>::empty() const noexcept
+{
+  return size() == 0;
+}
+
+template<typename T, class Popper>
+bool sg14::mpmc_ring_span<T, Popper>::full() const noexcept
+{
+  return size() == capacity();
+}
+
+template<typename T, class Popper>
+typename sg14::mpmc_ring_span<T, Popper>::size_type sg14::mpmc_ring_span<T, Popper>::size() const noexcept
+{
+  size_type head = m_head.load(std::memory_order_acquire);
+  size_type tail = m_tail.load(std::memory_order_acquire);
+  // Claimed but unfinished pops can briefly put head ahead of our stale tail.
+  return (tail - head <= m_mask + 1) ? tail - head : 0;
+}
+
+template<typename T, class Popper>
+typename sg14::mpmc_ring_span<T, Popper>::size_type sg14::mpmc_ring_span<T, Popper>::capacity() const noexcept
+{
+  return m_mask + 1;
+}
+
+template<typename T, class Popper>
+bool sg14::mpmc_ring_span<T, Popper>::try_push(const T& value)
+{
+  return try_emplace(value);
+}
+
+template<typename T, class Popper>
+bool sg14::mpmc_ring_span<T, Popper>::try_push(T&& value)
+{
+  return try_emplace(std::move(value));
+}
+
+template<typename T, class Popper>
+template<class... FromType>
+bool sg14::mpmc_ring_span<T, Popper>::try_emplace(FromType&&... from_value)
+{
+  // Build the value before claiming a slot: once claimed, the slot must be
+  // published, so nothing that might throw should happen in between.
+  T value(std::forward<FromType>(from_value)...);
+  size_type pos;
+  if (!claim(m_tail, 0, pos)) {
+    return false;
+  }
+  push_claimed(pos, std::move(value));
+  return true;
+}
+
+template<typename T, class Popper>
+bool sg14::mpmc_ring_span<T, Popper>::try_pop()
+{
+  size_type pos;
+  if (!claim(m_head, 1, pos)) {
+    return false;
+  }
+  seq_release r = {m_seq[pos & m_mask], pos + m_mask + 1};
+  m_popper(m_data[pos & m_mask]);
+  return true;
+}
+
+template<typename T, class Popper>
+template<class U>
+bool sg14::mpmc_ring_span<T, Popper>::try_pop(U& out)
+{
+  size_type pos;
+  if (!claim(m_head, 1, pos)) {
+    return false;
+  }
+  // If the Popper throws, the element is dropped, but the slot is still released.
+  seq_release r = {m_seq[pos & m_mask], pos + m_mask + 1};
+  out = m_popper(m_data[pos & m_mask]);
+  return true;
+}
+
+// A slot at position pos is ready to be pushed into when its sequence number is pos,
+// and ready to be popped from when it is pos + 1; lag says which one we want.
+template<typename T, class Popper>
+bool sg14::mpmc_ring_span<T, Popper>::claim(std::atomic<size_type>& counter, size_type lag, size_type& pos) noexcept
+{
+  pos = counter.load(std::memory_order_relaxed);
+  for (;;) {
+    size_type seq = m_seq[pos & m_mask].load(std::memory_order_acquire);
+    std::ptrdiff_t dif = static_cast<std::ptrdiff_t>(seq - (pos + lag));
+    if (dif == 0) {
+      if (counter.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+        return true;
+      }
+    } else if (dif < 0) {
+      // The slot hasn't been released by the previous lap yet.
+      return false;
+    } else {
+      pos = counter.load(std::memory_order_relaxed);
+    }
+  }
+}
+
+template<typename T, class Popper>
+void sg14::mpmc_ring_span<T, Popper>::push_claimed(size_type pos, T&& value)
+{
+  seq_release r = {m_seq[pos & m_mask], pos + 1};
+  m_data[pos & m_mask] = std::move(value);
+}
+
 namespace sg14
 {
-  template<typename T, class Popper>
-  void swap(ring_span<T, Popper>& a, ring_span<T, Popper>& b) noexcept {
+  template<typename T, class Popper, class Capacity>
+  void swap(ring_span<T, Popper, Capacity>& a, ring_span<T, Popper, Capacity>& b) noexcept {
     a.swap(b);
   }
 
@@ -26,14 +26,28 @@
 
 #pragma once
 
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <algorithm>
+#include <functional>
 #include <initializer_list>
+#include <iterator>
+#include <limits>
+#include <memory>
 #include <type_traits>
 #include <utility>
 #include <vector>
 
 #ifndef SLOT_MAP_THROW_EXCEPTION
+#if defined(__cpp_exceptions) || defined(_CPPUNWIND)
 #include <stdexcept>
 #define SLOT_MAP_THROW_EXCEPTION(type, ...) throw type(__VA_ARGS__)
+#else
+#include <cassert>
+#include <stdlib.h>
+#define SLOT_MAP_THROW_EXCEPTION(type, ...) (assert(!#type), abort())
+#endif
 #endif
 
 namespace sg14 {
@@ -58,29 +72,239 @@ inline void reserve_if_possible(Ctr& ctr, const SizeType& n)
     slot_map_detail::reserve_if_possible(ctr, n, priority_tag<1>{});
 }
 
+// A Key is normally pair-like, accessed with std::get or (since C++17) structured bindings.
+// A Key with index(), generation(), set_index() and increment_generation() members,
+// such as packed_key, is accessed through those instead.
+template<class Key>
+constexpr auto key_get_index(const Key& k, priority_tag<1>) -> decltype(k.index()) { return k.index(); }
+template<class Key>
+constexpr auto key_get_generation(const Key& k, priority_tag<1>) -> decltype(k.generation()) { return k.generation(); }
+template<class Key, class Index>
+constexpr auto key_set_index(Key& k, Index value, priority_tag<1>) -> decltype(k.set_index(value)) { k.set_index(value); }
+template<class Key>
+constexpr auto key_increment_generation(Key& k, priority_tag<1>) -> decltype(k.increment_generation()) { k.increment_generation(); }
+
+// True if k's generation is the last one before wrapping around to zero. Only keys
+// with the member interface retire their slots at that point; pair-like keys keep
+// wrapping, as they always have, since retiring would quickly exhaust the index
+// space of a small bit-field key.
+template<class Key>
+constexpr auto key_is_last_generation(const Key& k, priority_tag<1>) -> decltype(bool(k.generation() == k.generation())) {
+    Key next = k;
+    next.increment_generation();
+    return next.generation() == 0;
+}
+
+#if __cplusplus >= 201703L
+template<class Key>
+constexpr auto key_get_index(const Key& k, priority_tag<0>) { const auto& [idx, gen] = k; return idx; }
+template<class Key>
+constexpr auto key_get_generation(const Key& k, priority_tag<0>) { const auto& [idx, gen] = k; return gen; }
+template<class Key, class Index>
+constexpr void key_set_index(Key& k, Index value, priority_tag<0>) { auto& [idx, gen] = k; idx = value; }
+template<class Key>
+constexpr void key_increment_generation(Key& k, priority_tag<0>) { auto& [idx, gen] = k; ++gen; }
+#else
+template<class Key>
+constexpr auto key_get_index(const Key& k, priority_tag<0>) { using std::get; return get<0>(k); }
+template<class Key>
+constexpr auto key_get_generation(const Key& k, priority_tag<0>) { using std::get; return get<1>(k); }
+template<class Key, class Index>
+constexpr void key_set_index(Key& k, Index value, priority_tag<0>) { using std::get; get<0>(k) = value; }
+template<class Key>
+constexpr void key_increment_generation(Key& k, priority_tag<0>) { using std::get; ++get<1>(k); }
+#endif
+template<class Key>
+constexpr bool key_is_last_generation(const Key&, priority_tag<0>) { return false; }
+
+// The largest index a Key can hold. The free list keeps the index one past
+// the newest slot in that slot, so this is also the most slots a slot_map can have.
+template<class Key, class Index>
+constexpr auto key_max_index(priority_tag<1>) -> decltype(Index(Key::max_index())) { return Key::max_index(); }
+template<class Key, class Index>
+constexpr Index key_max_index(priority_tag<0>) { return (std::numeric_limits<Index>::max)(); }
+
+// A hint only; it's a no-op unless It is random-access.
+template<class It, class SizeType>
+inline void prefetch_nth(It first, SizeType n, std::random_access_iterator_tag) {
+#if defined(__GNUC__) || defined(__clang__)
+    __builtin_prefetch(std::addressof(*std::next(first, n)));
+#else
+    (void)first; (void)n;
+#endif
+}
+template<class It, class SizeType>
+inline void prefetch_nth(It, SizeType, std::input_iterator_tag) {}
+
+// A snapshot is this header, then the slots as (index, generation) pairs, then the
+// reverse map, then the values, each aligned to snapshot_alignment relative to the header.
+// The fields are stored natively, so a reader checks byte_order before trusting them.
+struct snapshot_header {
+    char magic[8];
+    uint32_t version;
+    uint32_t byte_order;
+    uint32_t index_size;
+    uint32_t generation_size;
+    uint32_t value_size;
+    uint32_t reserved;
+    uint64_t size;
+    uint64_t slot_count;
+    uint64_t slots_offset;
+    uint64_t reverse_map_offset;
+    uint64_t values_offset;
+    uint64_t total_size;
+};
+
+template<class Index, class Generation>
+struct snapshot_slot {
+    Index index;
+    Generation generation;
+};
+
+constexpr char snapshot_magic[8] = {'S', 'G', '1', '4', 'S', 'M', 'A', 'P'};
+constexpr uint32_t snapshot_version = 1;
+constexpr uint32_t snapshot_byte_order = 0x01020304;
+constexpr uint64_t snapshot_alignment = 64;
+
+inline uint64_t snapshot_round_up(uint64_t n) {
+    return (n + (snapshot_alignment - 1)) & ~(snapshot_alignment - 1);
+}
+
+template<class Write>
+void snapshot_pad(Write& write, uint64_t from, uint64_t to) {
+    static const unsigned char zeros[snapshot_alignment] = {};
+    if (to != from) {
+        write(static_cast<const void*>(zeros), size_t(to - from));
+    }
+}
+
+// Writes f(x) for each x in [first, last), a bufferful at a time.
+template<class T, class It, class F, class Write>
+void snapshot_write_range(It first, It last, F f, Write& write) {
+    constexpr size_t batch = (sizeof(T) < 4096) ? (4096 / sizeof(T)) : 1;
+    unsigned char buffer[batch * sizeof(T)];
+    size_t n = 0;
+    for ( ; first != last; ++first) {
+        T t = f(*first);
+        memcpy(buffer + n * sizeof(T), &t, sizeof(T));
+        if (++n == batch) {
+            write(static_cast<const void*>(buffer), sizeof buffer);
+            n = 0;
+        }
+    }
+    if (n != 0) {
+        write(static_cast<const void*>(buffer), n * sizeof(T));
+    }
+}
+
+template<class T, class Ctr, class Write>
+inline auto snapshot_write_all(const Ctr& c, Write& write, priority_tag<1>) -> decltype(void(c.data())) {
+    if (c.size() != 0) {
+        write(static_cast<const void*>(c.data()), c.size() * sizeof(T));
+    }
+}
+
+template<class T, class Ctr, class Write>
+inline void snapshot_write_all(const Ctr& c, Write& write, priority_tag<0>) {
+    slot_map_detail::snapshot_write_range<T>(c.begin(), c.end(), [](const T& t) { return t; }, write);
+}
+
 } // namespace slot_map_detail
 
+// A slot_map key packed into a single unsigned integer: the low IndexBits bits
+// hold the slot index and the next GenBits bits hold the generation. It is half
+// the size of std::pair<unsigned, unsigned> when IndexBits + GenBits <= 32, and
+// is cheap to hash, compare, and pass in a register.
+// A slot is retired, rather than reused, once its generation runs out;
+// so with few GenBits, budget for IndexBits to cover the extra slots.
+template<size_t IndexBits = 32, size_t GenBits = 32>
+class packed_key {
+    static_assert(IndexBits > 0 && GenBits > 0, "packed_key needs at least one index bit and one generation bit");
+    static_assert(IndexBits + GenBits <= 64, "packed_key must fit in 64 bits");
+public:
+    using rep_type = std::conditional_t<(IndexBits + GenBits <= 32), uint32_t, uint64_t>;
+    using index_type = rep_type;
+    using generation_type = rep_type;
+
+    static constexpr size_t index_bits = IndexBits;
+    static constexpr size_t generation_bits = GenBits;
+
+    constexpr packed_key() = default;
+    constexpr packed_key(index_type idx, generation_type gen) noexcept
+        : rep_(static_cast<rep_type>((idx & index_mask()) | ((gen & generation_mask()) << IndexBits))) {}
+
+    static constexpr packed_key from_rep(rep_type rep) noexcept { packed_key k; k.rep_ = rep; return k; }
+    constexpr rep_type rep() const noexcept { return rep_; }
+
+    static constexpr index_type max_index() noexcept { return index_mask(); }
+    constexpr index_type index() const noexcept { return rep_ & index_mask(); }
+    constexpr generation_type generation() const noexcept { return (rep_ >> IndexBits) & generation_mask(); }
+    constexpr void set_index(index_type idx) noexcept {
+        rep_ = static_cast<rep_type>((rep_ & ~index_mask()) | (idx & index_mask()));
+    }
+    constexpr void increment_generation() noexcept {
+        *this = packed_key(this->index(), this->generation() + 1);
+    }
+
+    friend constexpr bool operator==(const packed_key& a, const packed_key& b) noexcept { return a.rep_ == b.rep_; }
+    friend constexpr bool operator!=(const packed_key& a, const packed_key& b) noexcept { return a.rep_ != b.rep_; }
+    friend constexpr bool operator<(const packed_key& a, const packed_key& b) noexcept { return a.rep_ < b.rep_; }
+
+private:
+    static constexpr rep_type low_bits(size_t n) noexcept {
+        return (n >= sizeof(rep_type) * 8) ? rep_type(-1) : static_cast<rep_type>((rep_type(1) << n) - 1);
+    }
+    static constexpr rep_type index_mask() noexcept { return low_bits(IndexBits); }
+    static constexpr rep_type generation_mask() noexcept { return low_bits(GenBits); }
+
+    rep_type rep_ = 0;
+};
+
+// The running counts returned by slot_map::stats().
+struct slot_map_stats {
+    size_t slots_created = 0;  // by emplace(), because the free list was empty
+    size_t free_list_reuses = 0;  // slots taken from the free list, including those added by reserve_slots()
+    size_t generation_wraps = 0;  // pair-like keys whose generation wrapped around to zero
+    size_t slots_retired = 0;  // slots taken out of use because their generations ran out
+    size_t reverse_map_fixups = 0;  // values moved within the underlying container, each needing its slot updated
+};
+
+// The last template parameter of slot_map. A slot_map derives privately from its stats
+// policy, which receives the counts through add_count(). The default, none, is empty
+// and discards them; counting keeps them, and makes slot_map::stats() available.
+namespace slot_map_stats_policy {
+    struct none {
+        static constexpr bool enabled = false;
+        constexpr void add_count(size_t slot_map_stats::*, size_t) noexcept {}
+        constexpr slot_map_stats counts() const noexcept { return slot_map_stats(); }
+    };
+    struct counting {
+        static constexpr bool enabled = true;
+        constexpr void add_count(size_t slot_map_stats::*field, size_t n) noexcept { counts_.*field += n; }
+        constexpr slot_map_stats counts() const noexcept { return counts_; }
+    private:
+        slot_map_stats counts_;
+    };
+}
+
 template<
     class T,
     class Key = std::pair<unsigned, unsigned>,
-    template<class...> class Container = std::vector
+    template<class...> class Container = std::vector,
+    class StatsPolicy = slot_map_stats_policy::none
 >
-class slot_map
+class slot_map : private StatsPolicy
 {
-#if __cplusplus >= 201703L
-    static constexpr auto get_index(const Key& k) { const auto& [idx, gen] = k; return idx; }
-    static constexpr auto get_generation(const Key& k) { const auto& [idx, gen] = k; return gen; }
-    template<class Integral> static constexpr void set_index(Key& k, Integral value) { auto& [idx, gen] = k; idx = static_cast<key_index_type>(value); }
-    static constexpr void increment_generation(Key& k) { auto& [idx, gen] = k; ++gen; }
-#else
-    static constexpr auto get_index(const Key& k) { using std::get; return get<0>(k); }
-    static constexpr auto get_generation(const Key& k) { using std::get; return get<1>(k); }
-    template<class Integral> static constexpr void set_index(Key& k, Integral value) { using std::get; get<0>(k) = static_cast<key_index_type>(value); }
-    static constexpr void increment_generation(Key& k) { using std::get; ++get<1>(k); }
-#endif
+    static constexpr auto get_index(const Key& k) { return slot_map_detail::key_get_index(k, slot_map_detail::priority_tag<1>{}); }
+    static constexpr auto get_generation(const Key& k) { return slot_map_detail::key_get_generation(k, slot_map_detail::priority_tag<1>{}); }
+    template<class Integral> static constexpr void set_index(Key& k, Integral value) { slot_map_detail::key_set_index(k, static_cast<key_index_type>(value), slot_map_detail::priority_tag<1>{}); }
+    static constexpr void increment_generation(Key& k) { slot_map_detail::key_increment_generation(k, slot_map_detail::priority_tag<1>{}); }
 
     using slot_iterator = typename Container<Key>::iterator;
 
+    template<class T2, class K2, template<class...> class C2, class S2, class Write>
+    friend void write_snapshot(const slot_map<T2, K2, C2, S2>& sm, Write write);
+
 public:
     using key_type = Key;
     using mapped_type = T;
@@ -229,6 +453,9 @@ public:
     // generation counter increases to be more evenly distributed across the slots.
     //
     constexpr void reserve_slots(size_type n) {
+        if (n > max_slot_count()) {
+            SLOT_MAP_THROW_EXCEPTION(std::length_error, "reserve_slots");
+        }
         slot_map_detail::reserve_if_possible(slots_, n);
         key_index_type original_num_slots = static_cast<key_index_type>(slots_.size());
         if (original_num_slots < n) {
@@ -244,6 +471,13 @@ public:
     }
     constexpr size_type slot_count() const { return slots_.size(); }
 
+    // The most slots the key type can index. Since retired slots are never reused,
+    // a packed_key with few GenBits can reach this after enough erasures, even
+    // when size() is small; emplace() then throws std::length_error.
+    static constexpr size_type max_slot_count() {
+        return static_cast<size_type>(slot_map_detail::key_max_index<Key, key_index_type>(slot_map_detail::priority_tag<1>{}));
+    }
+
     // These operations have O(1) time and space complexity.
     // When size() == capacity() an allocation is required
     // which has O(n) time and space complexity.
@@ -252,6 +486,9 @@ public:
     constexpr key_type insert(mapped_type&& value)        { return this->emplace(std::move(value)); }
 
     template<class... Args> constexpr key_type emplace(Args&&... args) {
+        if (next_available_slot_index_ == slots_.size() && slots_.size() >= max_slot_count()) {
+            SLOT_MAP_THROW_EXCEPTION(std::length_error, "emplace");
+        }
         auto value_pos = values_.size();
         values_.emplace_back(std::forward<Args>(args)...);
         reverse_map_.emplace_back(next_available_slot_index_);
@@ -259,18 +496,62 @@ public:
             auto idx = next_available_slot_index_; ++idx;
             slots_.emplace_back(key_type{idx, key_generation_type{}});  // make a new slot
             last_available_slot_index_ = idx;
-        }
-        auto slot_iter = std::next(slots_.begin(), next_available_slot_index_);
-        if (next_available_slot_index_ == last_available_slot_index_) {
-            next_available_slot_index_ = static_cast<key_index_type>(slots_.size());
-            last_available_slot_index_ = next_available_slot_index_;
+            this->add_count(&slot_map_stats::slots_created, 1);
         } else {
-            next_available_slot_index_ = this->get_index(*slot_iter);
+            this->add_count(&slot_map_stats::free_list_reuses, 1);
         }
-        this->set_index(*slot_iter, value_pos);
-        key_type result = *slot_iter;
-        this->set_index(result, std::distance(slots_.begin(), slot_iter));
-        return result;
+        return this->take_free_slot(value_pos);
+    }
+
+    // emplace_n() constructs n values, each from args, and writes their keys to out.
+    // It grows each of the underlying containers at most once: the slots that the
+    // free list can't supply are all created up front, and then every value takes
+    // its slot straight off the free list.
+    // O(n) time complexity.
+    //
+    template<class OutputIt, class... Args>
+    constexpr OutputIt emplace_n(size_type n, OutputIt out, const Args&... args) {
+        size_type reused = 0;
+        if (next_available_slot_index_ != slots_.size()) {
+            key_index_type idx = next_available_slot_index_;
+            while (reused != n) {
+                ++reused;
+                if (idx == last_available_slot_index_) {
+                    break;
+                }
+                idx = this->get_index(*std::next(slots_.begin(), idx));
+            }
+        }
+        size_type created = n - reused;
+        if (created > max_slot_count() - slots_.size()) {
+            SLOT_MAP_THROW_EXCEPTION(std::length_error, "emplace_n");
+        }
+        slot_map_detail::reserve_if_possible(values_, values_.size() + n);
+        slot_map_detail::reserve_if_possible(reverse_map_, reverse_map_.size() + n);
+        this->reserve_slots(slots_.size() + created);  // puts the new slots on the free list
+        this->add_count(&slot_map_stats::slots_created, created);
+        this->add_count(&slot_map_stats::free_list_reuses, reused);
+        for (size_type i = 0; i < n; ++i) {
+            auto value_pos = values_.size();
+            values_.emplace_back(args...);
+            reverse_map_.emplace_back(next_available_slot_index_);
+            *out = this->take_free_slot(value_pos);
+            ++out;
+        }
+        return out;
+    }
+
+    // find_many() writes find(k) to out for each key k in [first, last).
+    // Keys are taken a batch at a time, and the batch's slots are prefetched
+    // before any of them is examined, so that their cache misses overlap.
+    //
+    template<class InputIt, class OutputIt>
+    constexpr OutputIt find_many(InputIt first, InputIt last, OutputIt out) {
+        return this->find_many_impl(*this, first, last, out);
+    }
+    template<class InputIt, class OutputIt>
+    constexpr OutputIt find_many(InputIt first, InputIt last, OutputIt out) const {
+        return this->find_many_impl(*this, first, last, out);
     }
 
     // Each erase() version has an O(1) time complexity per value
@@ -302,6 +583,36 @@ public:
         return 1;
     }
 
+    // Erases the value of each valid key in [first, last), and returns how many
+    // were erased. The keys are all expired first; then the holes are filled from
+    // the back as by erase(), highest first, so that no doomed value is moved.
+    // O(k log k) time and O(k) space complexity, for k keys.
+    //
+    template<class InputIt,
+             class = std::enable_if_t<std::is_convertible<typename std::iterator_traits<InputIt>::reference, const key_type&>::value>,
+             class = std::enable_if_t<!std::is_convertible<InputIt, const_iterator>::value>>
+    constexpr size_type erase(InputIt first, InputIt last) {
+        std::vector<key_index_type> doomed;  // the value indices
+        for ( ; first != last; ++first) {
+            const key_type& key = *first;
+            auto slot_index = get_index(key);
+            if (slot_index >= slots_.size()) {
+                continue;
+            }
+            auto slot_iter = std::next(slots_.begin(), slot_index);
+            if (get_generation(*slot_iter) != get_generation(key)) {
+                continue;
+            }
+            doomed.push_back(get_index(*slot_iter));
+            this->expire_slot(slot_iter, slot_index);
+        }
+        std::sort(doomed.begin(), doomed.end(), std::greater<key_index_type>());
+        for (key_index_type value_index : doomed) {
+            this->erase_value_at(value_index);
+        }
+        return doomed.size();
+    }
+
     constexpr void underlying_swap(const_iterator cit, const_iterator cjt) {
         // Swap *it and *jt in the underlying container,
         // but then fix up their keys so they don't appear to move.
@@ -318,6 +629,7 @@ public:
         swap(*it, *jt);
         swap(*it_slot_iter, *jt_slot_iter);
         swap(*it_reversemap_iter, *jt_reversemap_iter);
+        this->add_count(&slot_map_stats::reverse_map_fixups, 2);
     }
 
     template<class Pred>
@@ -342,6 +654,77 @@ public:
         }
     }
 
+    // sort() stably sorts the underlying container by comp,
+    // and fixes up the slots so that every key still refers to its value.
+    // O(n log n) time complexity and O(n) space complexity.
+    //
+    template<class Compare>
+    constexpr void sort(Compare comp) {
+        std::vector<iterator> value_iters;
+        for (auto it = values_.begin(); it != values_.end(); ++it) {
+            value_iters.push_back(it);
+        }
+        std::vector<size_t> order(value_iters.size());
+        for (size_t i = 0; i < order.size(); ++i) {
+            order[i] = i;
+        }
+        std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+            return bool(comp(*value_iters[a], *value_iters[b]));
+        });
+        this->rearrange(order, value_iters);
+    }
+
+    // erase_deferred() expires key at once, so that find(key) fails, but leaves
+    // its value in place; the values keep their order until the next
+    // compact_in_order(). Until then, the value is still part of the
+    // underlying container, so it's still visited by iteration and counted by size(),
+    // and its slot isn't reused. Don't erase() it by iterator in the meantime.
+    // O(1) time complexity.
+    //
+    constexpr size_type erase_deferred(const key_type& key) {
+        auto slot_index = get_index(key);
+        if (slot_index >= slots_.size()) {
+            return 0;
+        }
+        auto slot_iter = std::next(slots_.begin(), slot_index);
+        if (get_generation(*slot_iter) != get_generation(key)) {
+            return 0;
+        }
+        this->increment_generation(*slot_iter);
+        this->add_count(&slot_map_stats::generation_wraps, get_generation(*slot_iter) == key_generation_type{});
+        deferred_.emplace_back(static_cast<key_index_type>(slot_index));
+        return 1;
+    }
+    constexpr size_type deferred_count() const { return deferred_.size(); }
+
+    // compact_in_order() erases every value passed to erase_deferred(),
+    // preserving the relative order of the rest, and frees their slots.
+    // O(n) time and space complexity.
+    //
+    constexpr void compact_in_order() {
+        if (deferred_.size() == 0) {
+            return;
+        }
+        std::vector<bool> doomed(values_.size());
+        for (auto&& slot_index : deferred_) {
+            doomed[get_index(*std::next(slots_.begin(), slot_index))] = true;
+        }
+        std::vector<iterator> value_iters;
+        std::vector<size_t> order;
+        size_t i = 0;
+        for (auto it = values_.begin(); it != values_.end(); ++it, ++i) {
+            value_iters.push_back(it);
+            if (!doomed[i]) {
+                order.push_back(i);
+            }
+        }
+        this->rearrange(order, value_iters);
+        for (auto&& slot_index : deferred_) {
+            this->release_slot(slot_index);
+        }
+        deferred_.clear();
+    }
+
     // clear() has O(n) time complexity and O(1) space complexity.
     // It also has semantics differing from erase(begin(), end())
     // in that it also resets the generation counter of every slot
@@ -352,6 +735,7 @@ public:
         slots_.clear();
         values_.clear();
         reverse_map_.clear();
+        deferred_.clear();
         next_available_slot_index_ = key_index_type{};
         last_available_slot_index_ = key_index_type{};
     }
@@ -362,8 +746,17 @@ public:
         swap(slots_, rhs.slots_);
         swap(values_, rhs.values_);
         swap(reverse_map_, rhs.reverse_map_);
+        swap(deferred_, rhs.deferred_);
         swap(next_available_slot_index_, rhs.next_available_slot_index_);
         swap(last_available_slot_index_, rhs.last_available_slot_index_);
+        swap(static_cast<StatsPolicy&>(*this), static_cast<StatsPolicy&>(rhs));
+    }
+
+    // The counters are copied, moved and swapped along with the slots,
+    // and aren't reset by clear().
+    constexpr slot_map_stats stats() const noexcept {
+        static_assert(StatsPolicy::enabled, "slot_map::stats() requires a counting stats policy, such as sg14::slot_map_stats_policy::counting");
+        return this->counts();
     }
 
 protected:
@@ -383,6 +776,14 @@ private:
     constexpr iterator erase_slot_iter(slot_iterator slot_iter) {
         auto slot_index = std::distance(slots_.begin(), slot_iter);
         auto value_index = get_index(*slot_iter);
+        this->erase_value_at(value_index);
+        this->expire_slot(slot_iter, slot_index);
+        return std::next(values_.begin(), value_index);
+    }
+    // Fills the value at value_index from the back, and shrinks the containers by one.
+    // The slot that pointed at it is left for the caller to expire.
+    template<class ValueIndex>
+    constexpr void erase_value_at(ValueIndex value_index) {
         auto value_iter = std::next(values_.begin(), value_index);
         auto value_back_iter = std::prev(values_.end());
         if (value_iter != value_back_iter) {
@@ -391,11 +792,41 @@ private:
             this->set_index(*slot_back_iter, value_index);
             auto reverse_map_iter = std::next(reverse_map_.begin(), value_index);
             *reverse_map_iter = static_cast<key_index_type>(std::distance(slots_.begin(), slot_back_iter));
+            this->add_count(&slot_map_stats::reverse_map_fixups, 1);
         }
         values_.pop_back();
         reverse_map_.pop_back();
-        // Expire this key.
-        if (next_available_slot_index_ == slots_.size()) {
+    }
+    // Takes the slot at the head of the free list, which mustn't be empty, and points it
+    // at the value at value_pos. Returns its key.
+    constexpr key_type take_free_slot(size_type value_pos) {
+        auto slot_iter = std::next(slots_.begin(), next_available_slot_index_);
+        if (next_available_slot_index_ == last_available_slot_index_) {
+            next_available_slot_index_ = static_cast<key_index_type>(slots_.size());
+            last_available_slot_index_ = next_available_slot_index_;
+        } else {
+            next_available_slot_index_ = this->get_index(*slot_iter);
+        }
+        this->set_index(*slot_iter, value_pos);
+        key_type result = *slot_iter;
+        this->set_index(result, std::distance(slots_.begin(), slot_iter));
+        return result;
+    }
+    template<class SlotIndex>
+    constexpr void expire_slot(slot_iterator slot_iter, SlotIndex slot_index) {
+        this->increment_generation(*slot_iter);
+        this->add_count(&slot_map_stats::generation_wraps, get_generation(*slot_iter) == key_generation_type{});
+        this->release_slot(slot_index);
+    }
+    // Puts an already-expired slot on the free list.
+    template<class SlotIndex>
+    constexpr void release_slot(SlotIndex slot_index) {
+        auto slot_iter = std::next(slots_.begin(), slot_index);
+        if (slot_map_detail::key_is_last_generation(*slot_iter, slot_map_detail::priority_tag<1>{})) {
+            // Retire the slot: no key with this generation has been handed out,
+            // and none can be without wrapping around to one that has.
+            this->add_count(&slot_map_stats::slots_retired, 1);
+        } else if (next_available_slot_index_ == slots_.size()) {
             next_available_slot_index_ = static_cast<key_index_type>(slot_index);
             last_available_slot_index_ = static_cast<key_index_type>(slot_index);
         } else {
@@ -403,13 +834,59 @@ private:
             this->set_index(*last_slot_iter, slot_index);
             last_available_slot_index_ = static_cast<key_index_type>(slot_index);
         }
-        this->increment_generation(*slot_iter);
-        return std::next(values_.begin(), value_index);
+    }
+    // Makes element t of the underlying container what element order[t] was,
+    // for each t, and drops the rest. value_iters[i] is an iterator to element i.
+    constexpr void rearrange(const std::vector<size_t>& order, const std::vector<iterator>& value_iters) {
+        std::vector<slot_iterator> slot_iters;
+        for (auto it = slots_.begin(); it != slots_.end(); ++it) {
+            slot_iters.push_back(it);
+        }
+        std::vector<key_index_type> old_reverse_map(reverse_map_.begin(), reverse_map_.end());
+        std::vector<mapped_type> moved;
+        moved.reserve(order.size());
+        for (size_t i : order) {
+            moved.emplace_back(std::move(*value_iters[i]));
+        }
+        auto value_iter = values_.begin();
+        auto reverse_iter = reverse_map_.begin();
+        for (size_t t = 0; t < order.size(); ++t, ++value_iter, ++reverse_iter) {
+            *value_iter = std::move(moved[t]);
+            *reverse_iter = old_reverse_map[order[t]];
+            this->set_index(*slot_iters[*reverse_iter], t);
+            this->add_count(&slot_map_stats::reverse_map_fixups, order[t] != t);
+        }
+        while (values_.size() != order.size()) {
+            values_.pop_back();
+            reverse_map_.pop_back();
+        }
+    }
+    template<class Self, class InputIt, class OutputIt>
+    static constexpr OutputIt find_many_impl(Self& self, InputIt first, InputIt last, OutputIt out) {
+        using SlotCategory = typename std::iterator_traits<slot_iterator>::iterator_category;
+        constexpr size_t batch = 16;
+        key_type keys[batch] = {};
+        while (first != last) {
+            size_t n = 0;
+            for ( ; n < batch && first != last; ++first, ++n) {
+                keys[n] = *first;
+                auto slot_index = get_index(keys[n]);
+                if (slot_index < self.slots_.size()) {
+                    slot_map_detail::prefetch_nth(self.slots_.begin(), slot_index, SlotCategory());
+                }
+            }
+            for (size_t i = 0; i < n; ++i) {
+                *out = self.find(keys[i]);
+                ++out;
+            }
+        }
+        return out;
     }
 
     Container<key_type> slots_;  // high_water_mark() entries
     Container<key_index_type> reverse_map_;  // exactly size() entries
     Container<mapped_type> values_;  // exactly size() entries
+    Container<key_index_type> deferred_;  // slots expired by erase_deferred(), but not yet freed
     key_index_type next_available_slot_index_{};
     key_index_type last_available_slot_index_{};
 
@@ -421,9 +898,170 @@ private:
     // is only one available slot at the moment).
 };
 
-template<class T, class Key, template<class...> class Container>
-constexpr void swap(slot_map<T, Key, Container>& lhs, slot_map<T, Key, Container>& rhs) {
+template<class T, class Key, template<class...> class Container, class StatsPolicy>
+constexpr void swap(slot_map<T, Key, Container, StatsPolicy>& lhs, slot_map<T, Key, Container, StatsPolicy>& rhs) {
     lhs.swap(rhs);
 }
 
+// write_snapshot(sm, write) writes sm in the format read by slot_map_view,
+// as a series of calls to write(const void *p, size_t n).
+// T and the key's index and generation types must be trivially copyable.
+// O(n) time complexity; O(1) space complexity.
+//
+template<class T, class Key, template<class...> class Container, class StatsPolicy, class Write>
+void write_snapshot(const slot_map<T, Key, Container, StatsPolicy>& sm, Write write)
+{
+    using SM = slot_map<T, Key, Container, StatsPolicy>;
+    using Index = typename SM::key_index_type;
+    using Generation = typename SM::key_generation_type;
+    using Slot = slot_map_detail::snapshot_slot<Index, Generation>;
+    static_assert(std::is_trivially_copyable<T>::value, "write_snapshot requires a trivially copyable value type");
+    static_assert(std::is_trivially_copyable<Index>::value && std::is_trivially_copyable<Generation>::value, "");
+    static_assert(alignof(T) <= slot_map_detail::snapshot_alignment && alignof(Slot) <= slot_map_detail::snapshot_alignment, "");
+    slot_map_detail::snapshot_header h = {};
+    memcpy(h.magic, slot_map_detail::snapshot_magic, sizeof h.magic);
+    h.version = slot_map_detail::snapshot_version;
+    h.byte_order = slot_map_detail::snapshot_byte_order;
+    h.index_size = sizeof(Index);
+    h.generation_size = sizeof(Generation);
+    h.value_size = sizeof(T);
+    h.size = sm.values_.size();
+    h.slot_count = sm.slots_.size();
+    h.slots_offset = slot_map_detail::snapshot_round_up(sizeof h);
+    h.reverse_map_offset = slot_map_detail::snapshot_round_up(h.slots_offset + h.slot_count * sizeof(Slot));
+    h.values_offset = slot_map_detail::snapshot_round_up(h.reverse_map_offset + h.size * sizeof(Index));
+    h.total_size = h.values_offset + h.size * sizeof(T);
+    write(static_cast<const void*>(&h), sizeof h);
+    slot_map_detail::snapshot_pad(write, sizeof h, h.slots_offset);
+    slot_map_detail::snapshot_write_range<Slot>(sm.slots_.begin(), sm.slots_.end(), [](const Key& k) {
+        Slot slot;
+        memset(&slot, 0, sizeof slot);  // no uninitialized padding in the file
+        slot.index = SM::get_index(k);
+        slot.generation = SM::get_generation(k);
+        return slot;
+    }, write);
+    slot_map_detail::snapshot_pad(write, h.slots_offset + h.slot_count * sizeof(Slot), h.reverse_map_offset);
+    slot_map_detail::snapshot_write_all<Index>(sm.reverse_map_, write, slot_map_detail::priority_tag<1>{});
+    slot_map_detail::snapshot_pad(write, h.reverse_map_offset + h.size * sizeof(Index), h.values_offset);
+    slot_map_detail::snapshot_write_all<T>(sm.values_, write, slot_map_detail::priority_tag<1>{});
+}
+
+// A slot_map_view is a read-only slot_map whose slots and values live in a snapshot
+// written by write_snapshot, for example in a memory-mapped file; nothing is copied
+// or deserialized. The memory must outlive the view, and must be aligned at least
+// as strictly as T, the key's index and generation types, and uint64_t.
+// Keys from the slot_map that was written find the same values in the view.
+//
+template<class T, class Key = std::pair<unsigned, unsigned>>
+class slot_map_view
+{
+    static constexpr auto get_index(const Key& k) { return slot_map_detail::key_get_index(k, slot_map_detail::priority_tag<1>{}); }
+    static constexpr auto get_generation(const Key& k) { return slot_map_detail::key_get_generation(k, slot_map_detail::priority_tag<1>{}); }
+
+    static_assert(std::is_trivially_copyable<T>::value, "slot_map_view requires a trivially copyable value type");
+
+public:
+    using key_type = Key;
+    using mapped_type = T;
+    using key_index_type = decltype(slot_map_view::get_index(std::declval<Key>()));
+    using key_generation_type = decltype(slot_map_view::get_generation(std::declval<Key>()));
+    using value_type = T;
+    using reference = const T&;
+    using const_reference = const T&;
+    using pointer = const T*;
+    using const_pointer = const T*;
+    using iterator = const T*;
+    using const_iterator = const T*;
+    using reverse_iterator = std::reverse_iterator<const T*>;
+    using const_reverse_iterator = std::reverse_iterator<const T*>;
+    using size_type = size_t;
+
+    slot_map_view() = default;
+
+    // Throws std::invalid_argument unless [data, data+size) holds a snapshot
+    // written on a machine like this one, for this value type and key type.
+    explicit slot_map_view(const void *data, size_t size) {
+        const size_t align = (std::max)({alignof(T), alignof(slot), alignof(slot_map_detail::snapshot_header)});
+        if (size < sizeof(slot_map_detail::snapshot_header) || reinterpret_cast<uintptr_t>(data) % align != 0) {
+            SLOT_MAP_THROW_EXCEPTION(std::invalid_argument, "slot_map_view: too short or misaligned");
+        }
+        slot_map_detail::snapshot_header h;
+        memcpy(&h, data, sizeof h);
+        if (memcmp(h.magic, slot_map_detail::snapshot_magic, sizeof h.magic) != 0 || h.version != slot_map_detail::snapshot_version) {
+            SLOT_MAP_THROW_EXCEPTION(std::invalid_argument, "slot_map_view: not a slot_map snapshot");
+        } else if (h.byte_order != slot_map_detail::snapshot_byte_order) {
+            SLOT_MAP_THROW_EXCEPTION(std::invalid_argument, "slot_map_view: snapshot has the wrong byte order");
+        } else if (h.index_size != sizeof(key_index_type) || h.generation_size != sizeof(key_generation_type) || h.value_size != sizeof(T)) {
+            SLOT_MAP_THROW_EXCEPTION(std::invalid_argument, "slot_map_view: snapshot has the wrong key or value type");
+        } else if (h.total_size > size || h.slots_offset > h.total_size || h.reverse_map_offset > h.total_size ||
+                   h.values_offset > h.total_size || h.size > size || h.slot_count > size ||
+                   h.slots_offset < sizeof h || h.slots_offset % slot_map_detail::snapshot_alignment != 0 ||
+                   h.reverse_map_offset % slot_map_detail::snapshot_alignment != 0 ||
+                   h.values_offset % slot_map_detail::snapshot_alignment != 0 ||
+                   h.reverse_map_offset < h.slots_offset + h.slot_count * sizeof(slot) ||
+                   h.values_offset < h.reverse_map_offset + h.size * sizeof(key_index_type) ||
+                   h.total_size != h.values_offset + h.size * sizeof(T)) {
+            SLOT_MAP_THROW_EXCEPTION(std::invalid_argument, "slot_map_view: snapshot is truncated or corrupt");
+        }
+        const char *base = static_cast<const char*>(data);
+        slots_ = reinterpret_cast<const slot*>(base + h.slots_offset);
+        slot_count_ = size_t(h.slot_count);
+        values_ = reinterpret_cast<const T*>(base + h.values_offset);
+        size_ = size_t(h.size);
+    }
+
+    // The find() functions have generation counter checking, and also check
+    // that the slot refers to a value in the snapshot.
+    // If either check fails, the result of end() is returned.
+    // O(1) time and space complexity.
+    //
+    const_iterator find(const key_type& key) const {
+        auto slot_index = get_index(key);
+        if (slot_index >= slot_count_) {
+            return end();
+        }
+        const slot& sl = slots_[slot_index];
+        if (sl.generation != get_generation(key) || sl.index >= size_) {
+            return end();
+        }
+        return values_ + sl.index;
+    }
+
+    const_reference at(const key_type& key) const {
+        auto value_iter = this->find(key);
+        if (value_iter == this->end()) {
+            SLOT_MAP_THROW_EXCEPTION(std::out_of_range, "at");
+        }
+        return *value_iter;
+    }
+
+    const_iterator begin() const noexcept { return values_; }
+    const_iterator end() const noexcept { return values_ + size_; }
+    const_iterator cbegin() const noexcept { return values_; }
+    const_iterator cend() const noexcept { return values_ + size_; }
+    const_reverse_iterator rbegin() const noexcept { return const_reverse_iterator(end()); }
+    const_reverse_iterator rend() const noexcept { return const_reverse_iterator(begin()); }
+
+    bool empty() const noexcept { return size_ == 0; }
+    size_type size() const noexcept { return size_; }
+    size_type slot_count() const noexcept { return slot_count_; }
+
+private:
+    using slot = slot_map_detail::snapshot_slot<key_index_type, key_generation_type>;
+
+    const slot *slots_ = nullptr;
+    size_t slot_count_ = 0;
+    const T *values_ = nullptr;
+    size_t size_ = 0;
+};
+
 } // namespace sg14
+
+namespace std {
+template<size_t IndexBits, size_t GenBits>
+struct hash<sg14::packed_key<IndexBits, GenBits>> {
+    size_t operator()(const sg14::packed_key<IndexBits, GenBits>& k) const noexcept {
+        return std::hash<typename sg14::packed_key<IndexBits, GenBits>::rep_type>()(k.rep());
+    }
+};
+} // namespace std
@@ -0,0 +1,127 @@
+#include <sg14/concurrent_slot_map.h>
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+TEST(concurrent_slot_map, Basic)
+{
+    sg14::concurrent_slot_map<std::string> sm;
+    EXPECT_TRUE(sm.empty());
+    auto k1 = sm.insert("hello");
+    auto k2 = sm.emplace(3, 'x');
+    EXPECT_EQ(sm.size(), 2u);
+    ASSERT_NE(sm.find(k1), nullptr);
+    EXPECT_EQ(*sm.find(k1), "hello");
+    EXPECT_EQ(*sm.find(k2), "xxx");
+    const std::string *p = sm.find(k2);
+    for (int i = 0; i < 1000; ++i) {
+        sm.insert(std::to_string(i));
+    }
+    EXPECT_EQ(sm.find(k2), p);  // values never move
+    EXPECT_EQ(sm.erase(k1), 1u);
+    EXPECT_EQ(sm.erase(k1), 0u);
+    EXPECT_FALSE(sm.contains(k1));
+    EXPECT_TRUE(sm.contains(k2));
+    EXPECT_EQ(sm.size(), 1001u);
+
+    // The freed slot is reused, under a new generation.
+    auto k3 = sm.insert("again");
+    EXPECT_EQ(k3.first, k1.first);
+    EXPECT_NE(k3.second, k1.second);
+    EXPECT_FALSE(sm.contains(k1));
+    EXPECT_EQ(*sm.find(k3), "again");
+
+    // Forged keys are rejected.
+    EXPECT_FALSE(sm.contains({k3.first, k3.second + 1}));
+    EXPECT_FALSE(sm.contains({0xFFFFFFF0u, 1}));
+    EXPECT_EQ(sm.erase({0xFFFFFFF0u, 1}), 0u);
+
+    size_t visited = 0;
+    sm.for_each([&](const sg14::concurrent_slot_map<std::string>::key_type& k, std::string& s) {
+        EXPECT_EQ(sm.find(k), &s);
+        ++visited;
+    });
+    EXPECT_EQ(visited, sm.size());
+}
+
+TEST(concurrent_slot_map, DestroysValues)
+{
+    auto counter = std::make_shared<int>();
+    if (true) {
+        sg14::concurrent_slot_map<std::shared_ptr<int>, 4> sm;
+        std::vector<sg14::concurrent_slot_map<std::shared_ptr<int>, 4>::key_type> keys;
+        for (int i = 0; i < 100; ++i) {
+            keys.push_back(sm.insert(counter));
+        }
+        EXPECT_EQ(counter.use_count(), 101);
+        for (int i = 0; i < 100; i += 2) {
+            sm.erase(keys[i]);
+        }
+        EXPECT_EQ(counter.use_count(), 51);
+    }
+    EXPECT_EQ(counter.use_count(), 1);
+}
+
+TEST(concurrent_slot_map, ManyThreads)
+{
+    using SM = sg14::concurrent_slot_map<int, 8>;
+    SM sm;
+    constexpr int threads = 8;
+    constexpr int per_thread = 5000;
+    std::vector<std::vector<SM::key_type>> keys(threads);
+    std::atomic<bool> go{false};
+    std::atomic<int> bad{0};
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; ++t) {
+        workers.emplace_back([&, t]() {
+            while (!go.load()) {
+                std::this_thread::yield();
+            }
+            for (int i = 0; i < per_thread; ++i) {
+                auto k = sm.emplace(t * per_thread + i);
+                keys[t].push_back(k);
+                const int *p = sm.find(k);
+                if (p == nullptr || *p != t * per_thread + i) {
+                    bad += 1;
+                }
+                if (i % 2 == 1) {
+                    // Erase the previous one, and check that it's gone.
+                    auto old = keys[t][i - 1];
+                    if (sm.erase(old) != 1 || sm.contains(old)) {
+                        bad += 1;
+                    }
+                }
+            }
+        });
+    }
+    go = true;
+    for (auto& w : workers) {
+        w.join();
+    }
+    EXPECT_EQ(bad.load(), 0);
+    EXPECT_EQ(sm.size(), size_t(threads * per_thread / 2));
+    for (int t = 0; t < threads; ++t) {
+        for (int i = 0; i < per_thread; ++i) {
+            EXPECT_EQ(sm.contains(keys[t][i]), i % 2 == 1);
+        }
+    }
+
+    // Erase everything from other threads than the ones that emplaced it.
+    workers.clear();
+    for (int t = 0; t < threads; ++t) {
+        workers.emplace_back([&, t]() {
+            for (auto&& k : keys[(t + 1) % threads]) {
+                sm.erase(k);
+            }
+        });
+    }
+    for (auto& w : workers) {
+        w.join();
+    }
+    EXPECT_TRUE(sm.empty());
+}
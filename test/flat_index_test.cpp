@@ -0,0 +1,82 @@
+#include <sg14/flat_index.h>
+
+#include <gtest/gtest.h>
+
+#include <sg14/flat_map.h>
+#include <sg14/flat_set.h>
+
+#include <deque>
+#include <functional>
+#include <string>
+#include <vector>
+
+template<class T> struct flat_indext : testing::Test {};
+
+using flat_indext_types = testing::Types<
+    sg14::flat_set<int>
+    , sg14::flat_set<int, std::greater<int>>
+    , sg14::flat_set<int, std::less<>, std::deque<int>>
+    , sg14::flat_map<int, const char*>
+    , sg14::flat_map<int, const char*, std::greater<>>
+>;
+TYPED_TEST_SUITE(flat_indext, flat_indext_types);
+
+static int make_value(int k, int*) { return k; }
+static std::pair<int, const char*> make_value(int k, std::pair<const int, const char*>*) { return {k, "x"}; }
+
+TYPED_TEST(flat_indext, MatchesContainer)
+{
+    using FC = TypeParam;
+    for (int n = 0; n < 70; ++n) {
+        FC fc;
+        for (int i = 0; i < n; ++i) {
+            fc.insert(make_value(2*i, static_cast<typename FC::value_type*>(nullptr)));
+        }
+        const FC& cfc = fc;
+        sg14::flat_index<FC> idx(fc);
+        for (int k = -2; k <= 2*n + 1; ++k) {
+            EXPECT_TRUE(idx.lower_bound(k) == cfc.lower_bound(k));
+            EXPECT_TRUE(idx.upper_bound(k) == cfc.upper_bound(k));
+            EXPECT_TRUE(idx.equal_range(k) == cfc.equal_range(k));
+            EXPECT_TRUE(idx.find(k) == cfc.find(k));
+            EXPECT_EQ(idx.contains(k), cfc.contains(k));
+            EXPECT_EQ(idx.count(k), cfc.count(k));
+        }
+    }
+}
+
+TEST(flat_index, Invalidate)
+{
+    sg14::flat_set<int> fs = {1, 3, 5};
+    sg14::flat_index<sg14::flat_set<int>> idx(fs);
+    EXPECT_FALSE(idx.stale());
+    EXPECT_TRUE(idx.contains(3));
+    EXPECT_FALSE(idx.contains(4));
+
+    fs.insert({4, 0});
+    idx.invalidate();
+    EXPECT_TRUE(idx.stale());
+    EXPECT_TRUE(idx.contains(4));
+    EXPECT_FALSE(idx.stale());
+    EXPECT_TRUE(idx.find(0) == fs.begin());
+    EXPECT_TRUE(idx.lower_bound(2) == fs.begin() + 2);
+    EXPECT_TRUE(&idx.container() == &fs);
+
+    fs.clear();
+    idx.rebuild();
+    EXPECT_TRUE(idx.find(4) == fs.end());
+    EXPECT_TRUE(idx.lower_bound(4) == fs.end());
+}
+
+TEST(flat_index, Transparent)
+{
+    using FM = sg14::flat_map<std::string, int, std::less<>>;
+    FM fm = {{"apple", 1}, {"banana", 2}, {"cherry", 3}};
+    sg14::flat_index<FM> idx(fm);
+    EXPECT_TRUE(idx.find("banana") == fm.begin() + 1);
+    EXPECT_TRUE(idx.find(std::string("cherry")) == fm.begin() + 2);
+    EXPECT_TRUE(idx.find("durian") == fm.end());
+    EXPECT_TRUE(idx.lower_bound("b") == fm.begin() + 1);
+    EXPECT_TRUE(idx.upper_bound("banana") == fm.begin() + 2);
+    EXPECT_EQ(idx.count("apple"), 1u);
+}
@@ -2,12 +2,16 @@
 
 #include <gtest/gtest.h>
 
+#include <cstdint>
 #include <deque>
 #include <functional>
+#include <iterator>
 #include <list>
+#include <map>
 #if __has_include(<memory_resource>)
 #include <memory_resource>
 #endif
+#include <sstream>
 #include <string>
 #include <vector>
 
@@ -30,6 +34,7 @@ using flat_mapt_types = testing::Types<
     , sg14::flat_map<int, const char*, std::less<int>, std::deque<int>>             // custom container
 #if __cplusplus >= 201702L
     , sg14::flat_map<int, const char*, std::less<int>, sg14::inplace_vector<int, 100>, sg14::inplace_vector<const char*, 50>>
+    , sg14::flat_map<int, const char*, std::less<int>, sg14::small_vector<int, 4>, sg14::small_vector<const char*, 4>>
 #endif
 #if __cpp_lib_memory_resource >= 201603
     , sg14::flat_map<int, const char*, std::less<int>, std::pmr::vector<int>>       // pmr container
@@ -489,6 +494,44 @@ TYPED_TEST(flat_mapt, InsertOrAssign)
     EXPECT_TRUE(fm[3] == Str("b"));
 }
 
+TYPED_TEST(flat_mapt, InsertRange)
+{
+    using FM = TypeParam;
+    using Mapped = typename FM::mapped_type;
+    using Str = std::conditional_t<std::is_same<Mapped, const char *>::value, std::string, Mapped>;
+
+    if (true) {
+        // Existing keys win; among new equivalent keys, the first one wins.
+        FM fm = {{2, "x"}, {4, "y"}, {6, "z"}};
+        std::vector<std::pair<int, const char*>> v = {{5, "a"}, {4, "b"}, {1, "c"}, {5, "d"}, {7, "e"}, {1, "f"}, {3, "g"}};
+        fm.insert(v.begin(), v.end());
+        EXPECT_EQ(fm.size(), 7u);
+        EXPECT_TRUE(fm.at(1) == Str("c"));
+        EXPECT_TRUE(fm.at(2) == Str("x"));
+        EXPECT_TRUE(fm.at(3) == Str("g"));
+        EXPECT_TRUE(fm.at(4) == Str("y"));
+        EXPECT_TRUE(fm.at(5) == Str("a"));
+        EXPECT_TRUE(fm.at(6) == Str("z"));
+        EXPECT_TRUE(fm.at(7) == Str("e"));
+        EXPECT_TRUE(std::is_sorted(fm.keys().begin(), fm.keys().end(), fm.key_comp()));
+        fm.insert(v.begin(), v.begin());
+        EXPECT_EQ(fm.size(), 7u);
+    }
+    if (true) {
+        // The sorted_unique overload still skips keys that are already present.
+        FM fm = {{2, "x"}, {4, "y"}};
+        FM other = {{1, "a"}, {2, "b"}, {3, "c"}, {5, "d"}};
+        fm.insert(sg14::sorted_unique, other.begin(), other.end());
+        EXPECT_EQ(fm.size(), 5u);
+        EXPECT_TRUE(fm.at(1) == Str("a"));
+        EXPECT_TRUE(fm.at(2) == Str("x"));
+        EXPECT_TRUE(fm.at(3) == Str("c"));
+        EXPECT_TRUE(fm.at(4) == Str("y"));
+        EXPECT_TRUE(fm.at(5) == Str("d"));
+        EXPECT_TRUE(std::is_sorted(fm.keys().begin(), fm.keys().end(), fm.key_comp()));
+    }
+}
+
 TYPED_TEST(flat_mapt, SpecialMembers)
 {
     using FS = TypeParam;
@@ -638,3 +681,223 @@ TEST(flat_map, ExtractReplace)
     EXPECT_EQ(fm.keys(), expected_keys);
     EXPECT_EQ(fm.values(), expected_values);
 }
+
+template<class FM>
+static void check_searches_against_std()
+{
+    using Key = typename FM::key_type;
+    for (int n = 0; n < 150; ++n) {
+        FM fm;
+        for (int i = 0; i < n; ++i) {
+            fm.emplace(Key(3 * i), i);
+        }
+        const auto& v = fm.keys();
+        auto comp = fm.key_comp();
+        for (int i = -2; i < 3 * n + 2; ++i) {
+            Key k = Key(i);
+            size_t lb = std::lower_bound(v.begin(), v.end(), k, comp) - v.begin();
+            size_t ub = std::upper_bound(v.begin(), v.end(), k, comp) - v.begin();
+            EXPECT_EQ(size_t(fm.lower_bound(k) - fm.begin()), lb);
+            EXPECT_EQ(size_t(fm.upper_bound(k) - fm.begin()), ub);
+            EXPECT_EQ(fm.contains(k), lb != ub);
+            EXPECT_EQ(fm.count(k), ub - lb);
+            EXPECT_TRUE(fm.find(k) == ((lb != ub) ? fm.begin() + lb : fm.end()));
+        }
+    }
+}
+
+TEST(flat_map, ArithmeticKeySearch)
+{
+    check_searches_against_std<sg14::flat_map<std::uint32_t, int>>();
+    check_searches_against_std<sg14::flat_map<std::uint64_t, int, std::greater<>>>();
+    check_searches_against_std<sg14::flat_map<float, int>>();
+    check_searches_against_std<sg14::flat_map<int, int, std::less<int>, std::deque<int>>>();
+}
+
+TEST(flat_map, FindMany)
+{
+    using FM = sg14::flat_map<int, int, std::greater<>>;
+    FM fm;
+    for (int i = 0; i < 1000; ++i) {
+        fm.emplace(3 * i, i);
+    }
+    std::vector<int> probes;
+    for (int i = 0; i < 500; ++i) {
+        probes.push_back((i * 7919) % 3010 - 5);
+    }
+    if (true) {
+        std::vector<FM::iterator> lbs, finds;
+        fm.lower_bound_many(probes.begin(), probes.end(), std::back_inserter(lbs));
+        fm.find_many(probes.begin(), probes.end(), std::back_inserter(finds));
+        ASSERT_EQ(lbs.size(), probes.size());
+        ASSERT_EQ(finds.size(), probes.size());
+        for (size_t i = 0; i < probes.size(); ++i) {
+            EXPECT_TRUE(lbs[i] == fm.lower_bound(probes[i]));
+            EXPECT_TRUE(finds[i] == fm.find(probes[i]));
+        }
+    }
+    if (true) {
+        // Probes sorted by key_comp() take the galloping path.
+        std::sort(probes.begin(), probes.end(), fm.key_comp());
+        const FM& cfm = fm;
+        std::vector<FM::const_iterator> finds(probes.size());
+        auto it = cfm.find_many(probes.begin(), probes.end(), finds.begin());
+        EXPECT_TRUE(it == finds.end());
+        for (size_t i = 0; i < probes.size(); ++i) {
+            EXPECT_TRUE(finds[i] == cfm.find(probes[i]));
+        }
+    }
+    if (true) {
+        // Single-pass input is searched one key at a time.
+        std::istringstream iss("2997 3 4 -1");
+        std::vector<FM::iterator> finds;
+        fm.find_many(std::istream_iterator<int>(iss), std::istream_iterator<int>(), std::back_inserter(finds));
+        ASSERT_EQ(finds.size(), 4u);
+        EXPECT_TRUE(finds[0] == fm.begin());
+        EXPECT_TRUE(finds[1] == fm.end() - 2);
+        EXPECT_TRUE(finds[2] == fm.end());
+        EXPECT_TRUE(finds[3] == fm.end());
+    }
+#if SG14_EXECUTION_POLICIES
+    if (true) {
+        std::vector<int> many;
+        for (int i = 0; i < 20000; ++i) {
+            many.push_back((i * 7919) % 3010 - 5);
+        }
+        std::vector<FM::const_iterator> finds(many.size());
+        auto it = fm.find_many(std::execution::par, many.begin(), many.end(), finds.begin());
+        EXPECT_TRUE(it == finds.end());
+        for (size_t i = 0; i < many.size(); ++i) {
+            EXPECT_TRUE(finds[i] == fm.find(many[i]));
+        }
+    }
+#endif
+}
+
+TEST(flat_map, MergeAndSubtract)
+{
+    using FM = sg14::flat_map<int, std::string>;
+    if (true) {
+        FM fm = {{1, "a"}, {3, "b"}, {5, "c"}};
+        fm.merge(FM{{0, "x"}, {3, "y"}, {4, "z"}, {9, "w"}});
+        EXPECT_EQ(fm, (FM{{0, "x"}, {1, "a"}, {3, "b"}, {4, "z"}, {5, "c"}, {9, "w"}}));
+        FM empty;
+        empty.merge(std::move(fm));
+        EXPECT_EQ(empty.size(), 6u);
+        EXPECT_TRUE(fm.empty());
+    }
+    if (true) {
+        // subtract() looks only at keys.
+        FM fm = {{1, "a"}, {2, "b"}, {3, "c"}, {4, "d"}};
+        fm.subtract(FM{{2, "not b"}, {4, "d"}, {6, "e"}});
+        EXPECT_EQ(fm, (FM{{1, "a"}, {3, "c"}}));
+        std::vector<int> keys = {0, 1};
+        fm.subtract(sg14::sorted_unique, keys.begin(), keys.end());
+        EXPECT_EQ(fm, (FM{{3, "c"}}));
+    }
+    if (true) {
+        using GM = sg14::flat_map<int, int, std::greater<int>, std::deque<int>>;
+        GM gm = {{1, 1}, {5, 5}};
+        gm.merge(GM{{2, 2}, {5, 50}, {7, 7}});
+        EXPECT_EQ(gm, (GM{{1, 1}, {2, 2}, {5, 5}, {7, 7}}));
+        gm.subtract(GM{{7, 0}, {1, 0}});
+        EXPECT_EQ(gm, (GM{{2, 2}, {5, 5}}));
+    }
+}
+
+template<class FM>
+static void check_replace_against_std(int n, int range)
+{
+    using Key = typename FM::key_type;
+    typename FM::key_container_type keys;
+    std::vector<std::string> values;
+    for (int i = 0; i < n; ++i) {
+        Key k = Key((i * 7919) % range - range / 2);
+        keys.push_back(k);
+        values.push_back(std::to_string(k));
+    }
+    FM fm;
+    fm.replace(keys, values);
+    std::map<Key, std::string, typename FM::key_compare> expected;
+    for (int i = 0; i < n; ++i) {
+        expected.emplace(keys[i], values[i]);
+    }
+    ASSERT_EQ(fm.size(), expected.size());
+    auto it = expected.begin();
+    for (auto&& kv : fm) {
+        EXPECT_EQ(kv.first, it->first);
+        EXPECT_EQ(kv.second, it->second);
+        ++it;
+    }
+#if SG14_EXECUTION_POLICIES
+    FM pfm(std::execution::par, keys, values);
+    EXPECT_EQ(pfm, fm);
+    pfm.replace(std::execution::par_unseq, std::move(keys), std::move(values));
+    EXPECT_EQ(pfm, fm);
+#endif
+}
+
+TEST(flat_map, ReplaceSortsIntegerKeys)
+{
+    // Big enough to take the radix-sort path, and small enough not to.
+    check_replace_against_std<sg14::flat_map<int, std::string>>(5000, 3001);
+    check_replace_against_std<sg14::flat_map<int, std::string>>(100, 51);
+    check_replace_against_std<sg14::flat_map<std::int8_t, std::string>>(4000, 250);
+    check_replace_against_std<sg14::flat_map<std::uint64_t, std::string, std::greater<>>>(5000, 100000);
+    check_replace_against_std<sg14::flat_map<long long, std::string, std::greater<long long>>>(5000, 4001);
+    check_replace_against_std<sg14::flat_map<int, std::string, std::less<int>, std::deque<int>>>(5000, 3001);
+}
+
+TEST(flat_map, SnapshotView)
+{
+    struct Point { short x; double y; };
+    sg14::flat_map<int, Point, std::greater<int>> fm;
+    for (int i = 0; i < 1000; ++i) {
+        fm.emplace(i * 3, Point{short(i), i * 0.5});
+    }
+    std::vector<char> bytes;
+    sg14::write_snapshot(fm, [&](const void *p, size_t n) {
+        bytes.insert(bytes.end(), static_cast<const char*>(p), static_cast<const char*>(p) + n);
+    });
+
+    using View = sg14::flat_map_view<int, Point, std::greater<int>>;
+    View v(bytes.data(), bytes.size());
+    ASSERT_EQ(v.size(), fm.size());
+    EXPECT_TRUE(std::equal(v.keys(), v.keys() + v.size(), fm.keys().begin()));
+    auto it = fm.begin();
+    for (auto&& kv : v) {
+        EXPECT_EQ(kv.first, it->first);
+        EXPECT_EQ(kv.second.x, it->second.x);
+        ++it;
+    }
+    for (int k : {-1, 0, 1, 1500, 2997, 2998, 3000}) {
+        auto vit = v.find(k);
+        auto fit = fm.find(k);
+        ASSERT_EQ(vit == v.end(), fit == fm.end());
+        if (fit != fm.end()) {
+            EXPECT_EQ(vit->second.y, fit->second.y);
+            EXPECT_EQ(v.at(k).x, fm.at(k).x);
+        }
+        EXPECT_EQ(v.lower_bound(k) - v.begin(), fm.lower_bound(k) - fm.begin());
+        EXPECT_EQ(v.upper_bound(k) - v.begin(), fm.upper_bound(k) - fm.begin());
+        EXPECT_EQ(v.equal_range(k).second - v.equal_range(k).first, ptrdiff_t(fm.count(k)));
+        EXPECT_EQ(v.contains(k), fm.contains(k));
+    }
+    EXPECT_THROW(v.at(1), std::out_of_range);
+
+    View empty;
+    EXPECT_TRUE(empty.empty());
+    EXPECT_TRUE(empty.begin() == empty.end());
+    EXPECT_TRUE(empty.find(3) == empty.end());
+
+    // A corrupt, truncated, or mistyped snapshot is rejected.
+    EXPECT_THROW(View(bytes.data(), bytes.size() - 1), std::invalid_argument);
+    EXPECT_THROW(View(bytes.data(), 8), std::invalid_argument);
+    EXPECT_THROW((sg14::flat_map_view<long long, Point, std::greater<int>>(bytes.data(), bytes.size())), std::invalid_argument);
+    std::vector<char> bad = bytes;
+    bad[0] = 'X';
+    EXPECT_THROW(View(bad.data(), bad.size()), std::invalid_argument);
+    bad = bytes;
+    std::reverse(bad.begin() + 12, bad.begin() + 16);  // the byte-order mark
+    EXPECT_THROW(View(bad.data(), bad.size()), std::invalid_argument);
+}
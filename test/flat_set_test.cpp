@@ -3,12 +3,15 @@
 #include <gtest/gtest.h>
 
 #include <algorithm>
+#include <cstdint>
 #include <deque>
 #include <forward_list>
 #include <functional>
 #if __has_include(<memory_resource>)
 #include <memory_resource>
 #endif
+#include <random>
+#include <set>
 #include <string>
 #include <vector>
 
@@ -412,3 +415,171 @@ TEST(flat_set, InsertRange)
     }
 #endif // __cpp_lib_ranges >= 201911L && __cpp_lib_ranges_to_container >= 202202L
 }
+
+template<class FS>
+static void check_searches_against_std()
+{
+    using Key = typename FS::key_type;
+    for (int n = 0; n < 150; ++n) {
+        FS fs;
+        for (int i = 0; i < n; ++i) {
+            fs.insert(Key(3 * i));
+        }
+        std::vector<Key> v(fs.begin(), fs.end());
+        auto comp = fs.key_comp();
+        for (int i = -2; i < 3 * n + 2; ++i) {
+            Key k = Key(i);
+            size_t lb = std::lower_bound(v.begin(), v.end(), k, comp) - v.begin();
+            size_t ub = std::upper_bound(v.begin(), v.end(), k, comp) - v.begin();
+            EXPECT_EQ(size_t(fs.lower_bound(k) - fs.begin()), lb);
+            EXPECT_EQ(size_t(fs.upper_bound(k) - fs.begin()), ub);
+            EXPECT_EQ(fs.contains(k), lb != ub);
+            EXPECT_EQ(fs.count(k), ub - lb);
+            EXPECT_TRUE(fs.find(k) == ((lb != ub) ? fs.begin() + lb : fs.end()));
+        }
+    }
+}
+
+TEST(flat_set, ArithmeticKeySearch)
+{
+    check_searches_against_std<sg14::flat_set<int>>();
+    check_searches_against_std<sg14::flat_set<unsigned char>>();
+    check_searches_against_std<sg14::flat_set<unsigned long long, std::greater<>>>();
+    check_searches_against_std<sg14::flat_set<double, std::greater<double>>>();
+    check_searches_against_std<sg14::flat_set<short, std::less<int>>>();
+    check_searches_against_std<sg14::flat_set<int, std::less<int>, std::deque<int>>>();
+}
+
+TEST(flat_set, FindMany)
+{
+    sg14::flat_set<int> fs;
+    for (int i = 0; i < 1000; ++i) {
+        fs.insert(3 * i);
+    }
+    std::vector<int> probes;
+    std::mt19937 g;
+    for (int i = 0; i < 500; ++i) {
+        probes.push_back(int(g() % 3010) - 5);
+    }
+    if (true) {
+        // Unsorted probes are searched in interleaved groups.
+        std::vector<sg14::flat_set<int>::iterator> lbs, finds;
+        auto it = fs.lower_bound_many(probes.begin(), probes.end(), std::back_inserter(lbs));
+        (void)it;
+        fs.find_many(probes.begin(), probes.end(), std::back_inserter(finds));
+        ASSERT_EQ(lbs.size(), probes.size());
+        ASSERT_EQ(finds.size(), probes.size());
+        for (size_t i = 0; i < probes.size(); ++i) {
+            EXPECT_TRUE(lbs[i] == fs.lower_bound(probes[i]));
+            EXPECT_TRUE(finds[i] == fs.find(probes[i]));
+        }
+    }
+    if (true) {
+        // Sorted probes (with duplicates) take the galloping path.
+        std::sort(probes.begin(), probes.end());
+        std::vector<sg14::flat_set<int>::const_iterator> lbs(probes.size()), finds(probes.size());
+        const auto& cfs = fs;
+        auto it = cfs.lower_bound_many(probes.begin(), probes.end(), lbs.begin());
+        EXPECT_TRUE(it == lbs.end());
+        cfs.find_many(probes.begin(), probes.end(), finds.begin());
+        for (size_t i = 0; i < probes.size(); ++i) {
+            EXPECT_TRUE(lbs[i] == cfs.lower_bound(probes[i]));
+            EXPECT_TRUE(finds[i] == cfs.find(probes[i]));
+        }
+    }
+    if (true) {
+        // An empty set, and an empty batch.
+        sg14::flat_set<int, std::greater<int>> empty;
+        std::vector<sg14::flat_set<int, std::greater<int>>::iterator> v;
+        empty.find_many(probes.begin(), probes.end(), std::back_inserter(v));
+        EXPECT_EQ(v.size(), probes.size());
+        EXPECT_TRUE(std::all_of(v.begin(), v.end(), [&](auto it) { return it == empty.end(); }));
+        v.clear();
+        fs.find_many(probes.begin(), probes.begin(), std::back_inserter(v));
+        EXPECT_TRUE(v.empty());
+    }
+}
+
+TEST(flat_set, MergeAndSubtract)
+{
+    using FS = sg14::flat_set<int>;
+    if (true) {
+        FS fs = {1, 3, 5, 7, 9};
+        fs.merge(FS{0, 3, 4, 9, 10, 11});
+        EXPECT_EQ(fs, (FS{0, 1, 3, 4, 5, 7, 9, 10, 11}));
+        fs.merge(FS{});
+        EXPECT_EQ(fs, (FS{0, 1, 3, 4, 5, 7, 9, 10, 11}));
+        FS empty;
+        empty.merge(std::move(fs));
+        EXPECT_EQ(empty, (FS{0, 1, 3, 4, 5, 7, 9, 10, 11}));
+        EXPECT_TRUE(fs.empty());
+    }
+    if (true) {
+        // When only the source has room for the result, its storage is reused.
+        std::vector<int> big;
+        big.reserve(100);
+        big = {2, 4, 6, 8};
+        FS source;
+        source.replace(sg14::sorted_unique, std::move(big));
+        const int *storage = source.keys().data();
+        std::vector<int> small = {1, 4, 9};
+        small.shrink_to_fit();
+        FS fs;
+        fs.replace(sg14::sorted_unique, std::move(small));
+        fs.merge(std::move(source));
+        EXPECT_EQ(fs, (FS{1, 2, 4, 6, 8, 9}));
+        EXPECT_EQ(fs.keys().data(), storage);
+        EXPECT_TRUE(source.empty());
+    }
+    if (true) {
+        using GS = sg14::flat_set<std::string, std::greater<>, std::deque<std::string>>;
+        GS gs = {"a", "c", "e"};
+        gs.merge(GS{"b", "c", "d", "f"});
+        EXPECT_EQ(gs, (GS{"a", "b", "c", "d", "e", "f"}));
+        gs.subtract(GS{"a", "c", "z"});
+        EXPECT_EQ(gs, (GS{"b", "d", "e", "f"}));
+        std::vector<const char*> v = {"f", "e"};
+        gs.subtract(sg14::sorted_unique, v.begin(), v.end());
+        EXPECT_EQ(gs, (GS{"b", "d"}));
+    }
+    if (true) {
+        FS fs = {1, 2, 3, 4, 5};
+        fs.subtract(FS{});
+        EXPECT_EQ(fs, (FS{1, 2, 3, 4, 5}));
+        fs.subtract(FS{0, 2, 4, 6});
+        EXPECT_EQ(fs, (FS{1, 3, 5}));
+        fs.subtract(fs);
+        EXPECT_TRUE(fs.empty());
+    }
+}
+
+template<class FS>
+static void check_replace_against_std(int n, int range)
+{
+    using Key = typename FS::key_type;
+    typename FS::container_type keys;
+    for (int i = 0; i < n; ++i) {
+        keys.push_back(Key((i * 7919) % range - range / 2));
+    }
+    FS fs;
+    fs.replace(keys);
+    std::set<Key, typename FS::key_compare> expected(keys.begin(), keys.end());
+    EXPECT_TRUE(std::equal(fs.begin(), fs.end(), expected.begin(), expected.end()));
+#if SG14_EXECUTION_POLICIES
+    FS pfs(std::execution::par, keys);
+    EXPECT_EQ(pfs, fs);
+    pfs.replace(std::execution::par_unseq, std::move(keys));
+    EXPECT_EQ(pfs, fs);
+#endif
+}
+
+TEST(flat_set, ReplaceSortsIntegerKeys)
+{
+    // Big enough to take the radix-sort path, and small enough not to.
+    check_replace_against_std<sg14::flat_set<int>>(5000, 3001);
+    check_replace_against_std<sg14::flat_set<int>>(100, 51);
+    check_replace_against_std<sg14::flat_set<std::int8_t>>(4000, 250);
+    check_replace_against_std<sg14::flat_set<std::uint64_t, std::greater<>>>(5000, 100000);
+    check_replace_against_std<sg14::flat_set<long long, std::greater<long long>>>(5000, 4001);
+    check_replace_against_std<sg14::flat_set<int, std::less<int>, std::deque<int>>>(5000, 3001);
+}
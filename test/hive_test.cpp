@@ -8,11 +8,13 @@
 #include <gtest/gtest.h>
 
 #include <algorithm>
+#include <atomic>
 #if __has_include(<concepts>)
 #include <concepts>
 #endif
 #include <functional>
 #include <iterator>
+#include <map>
 #include <memory>
 #if __has_include(<memory_resource>)
 #include <memory_resource>
@@ -20,6 +22,7 @@
 #include <numeric>
 #include <random>
 #include <string>
+#include <thread>
 #include <utility>
 #include <vector>
 
@@ -1789,6 +1792,55 @@ TYPED_TEST(hivet, SortGreater)
     EXPECT_INVARIANTS(h2);
 }
 
+TYPED_TEST(hivet, SortWithErasures)
+{
+    using Hive = TypeParam;
+    using Value = typename Hive::value_type;
+
+    std::mt19937 g;
+    Hive h;
+    for (int i = 0; i < 20'000; ++i) {
+        h.insert(hivet_setup<Hive>::value(g() % 65536));
+    }
+    for (auto it = h.begin(); it != h.end(); ) {
+        it = (g() % 3 == 0) ? h.erase(it) : std::next(it);
+    }
+    std::vector<const Value*> addresses;
+    for (const Value& x : h) {
+        addresses.push_back(std::addressof(x));
+    }
+    std::vector<Value> v(h.begin(), h.end());
+    h.sort();
+    std::sort(v.begin(), v.end());
+    EXPECT_TRUE(std::equal(h.begin(), h.end(), v.begin(), v.end()));
+
+    // The values have moved, but the cells haven't.
+    size_t i = 0;
+    for (const Value& x : h) {
+        EXPECT_EQ(std::addressof(x), addresses[i++]);
+    }
+    EXPECT_INVARIANTS(h);
+}
+
+#if SG14_EXECUTION_POLICIES
+TEST(hive, ParallelSort)
+{
+    std::mt19937 g;
+    sg14::hive<int> h;
+    for (int i = 0; i < 100'000; ++i) {
+        h.insert(int(g() % 65536));
+    }
+    for (auto it = h.begin(); it != h.end(); ) {
+        it = (g() % 5 == 0) ? h.erase(it) : std::next(it);
+    }
+    std::vector<int> v(h.begin(), h.end());
+    h.sort(std::execution::par, std::greater<int>());
+    std::sort(v.begin(), v.end(), std::greater<int>());
+    EXPECT_TRUE(std::equal(h.begin(), h.end(), v.begin(), v.end()));
+    EXPECT_INVARIANTS(h);
+}
+#endif // SG14_EXECUTION_POLICIES
+
 TYPED_TEST(hivet, SortAndUnique)
 {
     using Hive = TypeParam;
@@ -2482,6 +2534,22 @@ TEST(hive, SpliceRegressionTest)
     EXPECT_EQ(h.capacity(), 300u);
 }
 
+TEST(hive, SpliceAfterErasingAtTheEnd)
+{
+    // The end group's trailing capacity must merge with the skipblock just before it.
+    sg14::hive<int> h = {1, 2, 3, 4, 5};
+    h.erase(std::prev(h.end()));
+    h.erase(std::prev(h.end()));
+    sg14::hive<int> h2 = {6, 7, 8};
+    h.splice(h2);
+    EXPECT_INVARIANTS(h);
+    EXPECT_EQ(h.size(), 6u);
+    EXPECT_EQ(std::distance(h.begin(), h.end()), 6);
+    EXPECT_EQ(std::accumulate(h.begin(), h.end(), 0), 1 + 2 + 3 + 6 + 7 + 8);
+    h.insert(9);
+    EXPECT_INVARIANTS(h);
+}
+
 TEST(hive, TrimDoesntMove)
 {
     struct S {
@@ -2562,6 +2630,311 @@ TYPED_TEST(hivet, TrimWhileEmpty)
     }
 }
 
+TYPED_TEST(hivet, BlockTraversal)
+{
+    using Hive = TypeParam;
+    using T = typename Hive::value_type;
+
+    std::mt19937 g;
+    Hive h;
+    for (int i = 0; i < 3000; ++i) {
+        h.insert(hivet_setup<Hive>::value(i));
+    }
+    for (auto it = h.begin(); it != h.end(); ) {
+        it = (g() % 3 == 0) ? h.erase(it) : std::next(it);
+    }
+    h.erase(h.begin());
+    h.erase(std::prev(h.end()));
+    EXPECT_INVARIANTS(h);
+
+    std::vector<T> expected(h.begin(), h.end());
+    std::vector<T> actual;
+    size_t total = 0;
+    h.for_each_block([&](typename Hive::block b) {
+        total += b.size();
+        EXPECT_LE(b.size(), b.extent());
+        EXPECT_LE(b.extent(), b.capacity());
+        size_t live = 0;
+        size_t prev_hi = 0;
+        b.for_each_index_run([&](size_t lo, size_t hi) {
+            EXPECT_LT(lo, hi);
+            EXPECT_TRUE(prev_hi == 0 || prev_hi < lo);  // runs are maximal
+            for (size_t i = prev_hi; i < lo; ++i) {
+                EXPECT_FALSE(b.is_live(i));
+            }
+            for (size_t i = lo; i < hi; ++i) {
+                EXPECT_TRUE(b.is_live(i));
+                EXPECT_EQ(b.skipfield()[i], 0);
+            }
+            live += hi - lo;
+            prev_hi = hi;
+        });
+        EXPECT_EQ(live, b.size());
+        b.for_each([&](T& x) { actual.push_back(x); });
+    });
+    EXPECT_EQ(total, h.size());
+    EXPECT_EQ(actual, expected);
+
+    actual.clear();
+    const Hive& ch = h;
+    sg14::for_each(ch, [&](const T& x) { actual.push_back(x); });
+    EXPECT_EQ(actual, expected);
+
+    Hive empty;
+    empty.insert(hivet_setup<Hive>::value(1));
+    empty.clear();
+    int calls = 0;
+    empty.for_each_block([&](typename Hive::block) { ++calls; });
+    EXPECT_EQ(calls, 0);
+}
+
+TYPED_TEST(hivet, RunIteration)
+{
+    using Hive = TypeParam;
+    using T = typename Hive::value_type;
+
+    Hive h;
+    for (int i = 0; i < 2000; ++i) {
+        h.insert(hivet_setup<Hive>::value(i));
+    }
+    // With no erasures, each group is a single run.
+    size_t blocks = 0;
+    h.for_each_block([&](const typename Hive::block&) { ++blocks; });
+    size_t runs = 0;
+    h.for_each_run([&](T*, size_t) { ++runs; });
+    if (Hive::block::has_contiguous_runs) {
+        EXPECT_EQ(runs, blocks);
+    } else {
+        EXPECT_EQ(runs, h.size());
+    }
+
+    std::mt19937 g;
+    for (auto it = h.begin(); it != h.end(); ) {
+        it = (g() % 4 == 0) ? h.erase(it) : std::next(it);
+    }
+    std::vector<T> expected(h.begin(), h.end());
+    std::vector<T> actual;
+    const T *prev_end = nullptr;
+    const Hive& ch = h;
+    ch.for_each_run([&](const T *p, size_t n) {
+        EXPECT_NE(p, prev_end);  // runs are maximal
+        for (size_t i = 0; i < n; ++i) {
+            actual.push_back(p[i]);
+        }
+        prev_end = p + n;
+    });
+    EXPECT_EQ(actual, expected);
+}
+
+#if SG14_EXECUTION_POLICIES
+TEST(hive, ParallelForEach)
+{
+    sg14::hive<int> h;
+    for (int i = 0; i < 200'000; ++i) {
+        h.insert(i);
+    }
+    std::erase_if(h, [](int x) { return x % 7 == 0; });
+    sg14::for_each(std::execution::par, h, [](int& x) { x *= 2; });
+    long long expected = 0;
+    for (int i = 0; i < 200'000; ++i) {
+        expected += (i % 7 == 0) ? 0 : 2 * i;
+    }
+    EXPECT_EQ(std::accumulate(h.begin(), h.end(), 0LL), expected);
+    std::atomic<long long> sum{0};
+    sg14::for_each(std::execution::par_unseq, std::as_const(h), [&](int x) { sum += x; });
+    EXPECT_EQ(sum.load(), expected);
+}
+#endif // SG14_EXECUTION_POLICIES
+
+TYPED_TEST(hivet, Compact)
+{
+    using Hive = TypeParam;
+    using Value = typename Hive::value_type;
+
+    std::mt19937 g;
+    Hive h;
+    for (int i = 0; i < 20'000; ++i) {
+        h.insert(hivet_setup<Hive>::value(i));
+    }
+    for (auto it = h.begin(); it != h.end(); ) {
+        it = (g() % 10 < 7) ? h.erase(it) : std::next(it);
+    }
+    std::map<const Value*, Value> where;
+    for (const Value& x : h) {
+        where.emplace(std::addressof(x), x);
+    }
+    std::vector<Value> expected(h.begin(), h.end());
+    std::sort(expected.begin(), expected.end());
+    auto count_blocks = [&]() {
+        size_t n = 0;
+        h.for_each_block([&](const typename Hive::block& b) {
+            EXPECT_GT(b.occupancy(), 0.0);
+            EXPECT_LE(b.occupancy(), 1.0);
+            ++n;
+        });
+        return n;
+    };
+    size_t blocks = count_blocks();
+    auto on_move = [&](Value *from, Value *to) {
+        auto it = where.find(from);
+        ASSERT_NE(it, where.end());
+        EXPECT_EQ(*to, it->second);
+        Value v = it->second;
+        where.erase(it);
+        EXPECT_TRUE(where.emplace(to, v).second);
+    };
+
+    EXPECT_EQ(h.compact(10, on_move), 10u);
+    EXPECT_INVARIANTS(h);
+    size_t moved = 10;
+    while (size_t n = h.compact(1000, on_move)) {
+        moved += n;
+        EXPECT_INVARIANTS(h);
+    }
+    EXPECT_GT(moved, 10u);
+    EXPECT_LT(count_blocks(), blocks);
+    EXPECT_EQ(where.size(), h.size());
+    for (const Value& x : h) {
+        auto it = where.find(std::addressof(x));
+        ASSERT_NE(it, where.end());
+        EXPECT_EQ(x, it->second);
+    }
+    std::vector<Value> actual(h.begin(), h.end());
+    std::sort(actual.begin(), actual.end());
+    EXPECT_EQ(actual, expected);
+
+    // Once compacted, there's no group whose elements fit in the others' holes.
+    EXPECT_EQ(h.compact(1000), 0u);
+    size_t cap = h.capacity();
+    h.trim_capacity();
+    EXPECT_LT(h.capacity(), cap);
+    EXPECT_INVARIANTS(h);
+}
+
+TYPED_TEST(hivet, CompactThrowingCallback)
+{
+    using Hive = TypeParam;
+    using Value = typename Hive::value_type;
+
+    std::mt19937 g;
+    Hive h;
+    for (int i = 0; i < 2000; ++i) {
+        h.insert(hivet_setup<Hive>::value(i));
+    }
+    for (auto it = h.begin(); it != h.end(); ) {
+        it = (g() % 10 < 7) ? h.erase(it) : std::next(it);
+    }
+    std::vector<Value> expected(h.begin(), h.end());
+    std::sort(expected.begin(), expected.end());
+    size_t n = h.size();
+
+    // The moved element must be in the hive exactly once, even though on_move throws.
+    Value *last_to = nullptr;
+    auto on_move = [&](Value *, Value *to) { last_to = to; throw 42; };
+    ASSERT_THROW(h.compact(1000, on_move), int);
+    ASSERT_NE(last_to, nullptr);
+    EXPECT_INVARIANTS(h);
+    EXPECT_EQ(h.size(), n);
+    std::vector<Value> actual(h.begin(), h.end());
+    std::sort(actual.begin(), actual.end());
+    EXPECT_EQ(actual, expected);
+    EXPECT_EQ(std::count_if(h.begin(), h.end(), [&](const Value& x) { return std::addressof(x) == last_to; }), 1);
+}
+
+TYPED_TEST(hivet, EraseIfRepeatedly)
+{
+    using Hive = TypeParam;
+    using Value = typename Hive::value_type;
+
+    std::mt19937 g;
+    Hive h;
+    for (int round = 0; round < 10; ++round) {
+        for (int i = 0; i < 2000; ++i) {
+            h.insert(hivet_setup<Hive>::value(round * 2000 + i));
+        }
+        // The predicate sees each element exactly once, in iteration order.
+        std::vector<Value> expected;
+        std::vector<bool> doomed;
+        for (const Value& x : h) {
+            doomed.push_back(g() % 10 < unsigned(round % 3 == 2 ? 9 : 3));
+            if (!doomed.back()) {
+                expected.push_back(x);
+            }
+        }
+        size_t i = 0;
+        auto n = std::erase_if(h, [&](const Value&) { return doomed[i++]; });
+        EXPECT_EQ(i, doomed.size());
+        EXPECT_EQ(n, doomed.size() - expected.size());
+        EXPECT_EQ(h.size(), expected.size());
+        EXPECT_TRUE(std::equal(h.begin(), h.end(), expected.begin(), expected.end()));
+        EXPECT_EQ(std::distance(h.rbegin(), h.rend()), std::ptrdiff_t(expected.size()));
+        EXPECT_INVARIANTS(h);
+    }
+    std::erase_if(h, [](const Value&) { return true; });
+    EXPECT_TRUE(h.empty());
+    EXPECT_INVARIANTS(h);
+    h.insert(hivet_setup<Hive>::value(1));
+    EXPECT_EQ(h.size(), 1u);
+    EXPECT_INVARIANTS(h);
+}
+
+TEST(hive, GroupPool)
+{
+    using Alloc = sg14::hive_pool_allocator<int>;
+    using Hive = sg14::hive<int, Alloc>;
+    sg14::hive_group_pool pool;
+    EXPECT_EQ(pool.cached_blocks(), 0u);
+    {
+        Hive h(Alloc{pool});
+        for (int i = 0; i < 1000; ++i) {
+            h.insert(i);
+        }
+    }
+    size_t cached = pool.cached_blocks();
+    EXPECT_GT(cached, 0u);
+    {
+        // The same sequence of groups comes back out of the pool.
+        Hive h(Alloc{pool});
+        for (int i = 0; i < 1000; ++i) {
+            h.insert(i);
+        }
+        EXPECT_EQ(pool.cached_blocks(), 0u);
+
+        // Hives on the same pool can splice freely.
+        Hive h2(Alloc{pool});
+        h2.reserve(100);
+        h2.insert(42);
+        h.splice(h2);
+        EXPECT_EQ(h.size(), 1001u);
+        EXPECT_INVARIANTS(h);
+        EXPECT_TRUE(h2.empty());
+    }
+    EXPECT_GT(pool.cached_blocks(), cached);
+    pool.release();
+    EXPECT_EQ(pool.cached_blocks(), 0u);
+
+    // An empty hive returns its reserved groups, too.
+    {
+        Hive h(Alloc{pool});
+        h.reserve(500);
+    }
+    EXPECT_GT(pool.cached_blocks(), 0u);
+
+    // A default-constructed allocator uses the calling thread's pool.
+    sg14::hive_group_pool::this_thread().release();
+    {
+        Hive h = {1, 2, 3};
+    }
+    EXPECT_EQ(sg14::hive_group_pool::this_thread().cached_blocks(), 1u);
+    std::thread([]() {
+        Hive h = {1, 2, 3};
+        h.clear();
+        EXPECT_EQ(sg14::hive_group_pool::this_thread().cached_blocks(), 0u);
+    }).join();
+    EXPECT_EQ(Alloc(), Alloc());
+    EXPECT_NE(Alloc(), Alloc(pool));
+}
+
 TEST(hive, StdErase)
 {
     std::mt19937 g;
@@ -2624,6 +2997,47 @@ TEST(hive, StdEraseIf)
     EXPECT_TRUE(std::all_of(h.begin(), h.end(), [](int i){ return i < 500; }));
 }
 
+TEST(hive, StdEraseIfThrows)
+{
+    sg14::hive<std::string> h;
+    for (int i = 0; i < 1000; ++i) {
+        h.insert(std::to_string(i));
+    }
+    int calls = 0;
+    auto pred = [&](const std::string& s) {
+        if (++calls == 700) {
+            throw 42;
+        }
+        return s.back() == '7';
+    };
+    EXPECT_THROW(erase_if(h, pred), int);
+    EXPECT_EQ(h.size(), 1000u - 70u);
+    EXPECT_INVARIANTS(h);
+    EXPECT_EQ(std::count_if(h.begin(), h.end(), [](const std::string& s) { return s.back() == '7'; }), 30);
+
+    // compact() turns the end group's trailing capacity into a skipblock whose interior
+    // skipfield is zero; a throwing pred mustn't mistake that interior for live elements.
+    sg14::hive<int> h2;
+    for (int i = 0; i < 100; ++i) {
+        h2.insert(i);
+    }
+    for (auto it = h2.begin(); it != h2.end(); ) {
+        it = (*it >= 50 && *it % 5 != 0) ? h2.erase(it) : std::next(it);
+    }
+    EXPECT_EQ(h2.compact(1), 1u);  // moves an element out of the sparse end group
+    EXPECT_INVARIANTS(h2);
+    int last = *std::prev(h2.end());
+    auto pred2 = [&](int x) {
+        if (x == last) {
+            throw 42;  // while culling the end group
+        }
+        return x % 2 == 0;
+    };
+    EXPECT_THROW(erase_if(h2, pred2), int);
+    EXPECT_INVARIANTS(h2);
+    EXPECT_EQ(size_t(std::distance(h2.begin(), h2.end())), h2.size());
+}
+
 #if __cplusplus >= 202002L
 TEST(hive, ConstexprCtor)
 {
@@ -2823,4 +3237,72 @@ TEST(hive, RangeInsertRegressionTest)
   EXPECT_EQ(sum, 4200);
 }
 
+TEST(hive, Stats)
+{
+    using Hive = sg14::hive<int, std::allocator<int>, sg14::hive_priority::performance, sg14::hive_stats_policy::counting>;
+    static_assert(sizeof(Hive) > sizeof(sg14::hive<int>));
+    Hive h;
+    EXPECT_EQ(h.stats().groups_allocated, 0u);
+    for (int i = 0; i < 100; ++i) {
+        h.insert(i);
+    }
+    while (h.size() != h.capacity()) {
+        h.insert(0);
+    }
+    size_t groups = h.stats().groups_allocated;
+    EXPECT_GE(groups, 1u);
+    EXPECT_EQ(h.stats().groups_deallocated, 0u);
+    EXPECT_EQ(h.stats().skipblocks, 0u);
+    EXPECT_EQ(h.stats().erasure_list_length, 0u);
+
+    // Erase every other element, leaving one-slot skipblocks.
+    size_t n = h.size();
+    for (auto it = h.begin(); it != h.end(); ) {
+        it = h.erase(it);
+        if (it != h.end()) ++it;
+    }
+    size_t erased = n - h.size();
+    auto st = h.stats();
+    EXPECT_EQ(st.skipblocks, erased);
+    EXPECT_EQ(st.skipped_slots, erased);
+    EXPECT_EQ(st.longest_skipblock, 1u);
+    EXPECT_GE(st.erasure_list_length, 1u);
+    EXPECT_EQ(st.erased_slot_reuses, 0u);
+
+    // With no spare capacity at the end, insertions fill the erased slots.
+    for (int i = 0; i < 10; ++i) {
+        h.insert(i);
+    }
+    h.insert(5, 42);
+    st = h.stats();
+    EXPECT_EQ(st.erased_slot_reuses, 15u);
+    EXPECT_EQ(st.skipblocks, erased - 15);
+    EXPECT_EQ(st.groups_allocated, groups);
+
+    // clear() keeps the groups, so refilling the hive reuses them.
+    h.clear();
+    EXPECT_EQ(h.stats().skipblocks, 0u);
+    EXPECT_EQ(h.stats().erasure_list_length, 0u);
+    for (size_t i = 0; i < n; ++i) {
+        h.insert(1);
+    }
+    st = h.stats();
+    EXPECT_EQ(st.groups_allocated, groups);
+    EXPECT_EQ(st.unused_group_reuses, groups - 1);  // the first group stays in use across clear()
+
+    // A copy counts only its own history; a move takes the counters along.
+    Hive copy = h;
+    EXPECT_EQ(copy.stats().erased_slot_reuses, 0u);
+    EXPECT_EQ(copy.stats().unused_group_reuses, 0u);
+    Hive moved = std::move(h);
+    EXPECT_EQ(moved.stats().erased_slot_reuses, 15u);
+
+    // shrink_to_fit() frees the groups it empties, even though it works through a scratch hive.
+    moved.clear();
+    moved.shrink_to_fit();
+    st = moved.stats();
+    EXPECT_EQ(st.groups_allocated - st.groups_deallocated, (moved.capacity() == 0) ? 0u : 1u);
+    EXPECT_INVARIANTS(moved);
+}
+
 #endif // __cplusplus >= 201703L
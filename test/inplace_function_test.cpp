@@ -2,6 +2,7 @@
 
 #include <gtest/gtest.h>
 
+#include <array>
 #include <memory>
 #include <string>
 #include <type_traits>
@@ -370,7 +371,7 @@ TEST(inplace_function, StructLayout)
     static_assert(std::alignment_of< sg14::inplace_function<void(int), 8> >::value == expected_alignment_for_capacity<8>(), "");
     static_assert(std::alignment_of< sg14::inplace_function<void(int), 16> >::value == expected_alignment_for_capacity<16>(), "");
     static_assert(std::alignment_of< sg14::inplace_function<void(int), 32> >::value == expected_alignment_for_capacity<32>(), "");
-    static_assert(sizeof( sg14::inplace_function<void(int), sizeof(void*)> ) == 2 * sizeof(void*), "");
+    static_assert(sizeof( sg14::inplace_function<void(int), sizeof(void*)> ) == (2 + SG14_INPLACE_FUNCTION_INLINE_INVOKER) * sizeof(void*), "");
 }
 
 TEST(inplace_function, ConvertibleFromNullptr)
@@ -698,3 +699,241 @@ TEST(inplace_function, Assignment)
     EXPECT_TRUE(func != nullptr);
     called_with = 0; expected = 42; func(42); EXPECT_TRUE(called_with == 42);
 }
+
+TEST(inplace_function, TriviallyCopyableCallables)
+{
+    using IPF = sg14::inplace_function<int(int), 32>;
+    int a = 1, b = 2, c = 3;
+    auto trivial = [a, b, c](int x) { return a * 100 + b * 10 + c + x; };
+    static_assert(std::is_trivially_copyable<decltype(trivial)>::value, "");
+
+    IPF f = trivial;
+    IPF g = f;
+    EXPECT_EQ(f(0), 123);
+    EXPECT_EQ(g(1), 124);
+    IPF h = std::move(g);
+    EXPECT_FALSE(bool(g));
+    EXPECT_EQ(h(2), 125);
+
+    // Swap and assign between trivial and non-trivial callables.
+    auto p = std::make_shared<int>(7);
+    IPF nt = [p](int x) { return *p + x; };
+    EXPECT_EQ(p.use_count(), 2);
+    nt.swap(h);
+    EXPECT_EQ(nt(0), 123);
+    EXPECT_EQ(h(0), 7);
+    EXPECT_EQ(p.use_count(), 2);
+    swap(nt, h);
+    EXPECT_EQ(nt(0), 7);
+    IPF copy = nt;
+    EXPECT_EQ(p.use_count(), 3);
+    copy = f;
+    EXPECT_EQ(p.use_count(), 2);
+    EXPECT_EQ(copy(0), 123);
+    nt = nullptr;
+    EXPECT_EQ(p.use_count(), 1);
+
+    // Conversion to a larger capacity.
+    sg14::inplace_function<int(int), 64> big = f;
+    EXPECT_EQ(big(5), 128);
+    sg14::inplace_function<int(int), 64> big2 = std::move(f);
+    EXPECT_FALSE(bool(f));
+    EXPECT_EQ(big2(6), 129);
+}
+
+TEST(inplace_function, MoveOnlyFunction)
+{
+    using IPF = sg14::inplace_move_only_function<int(int), 16>;
+    static_assert(!std::is_copy_constructible<IPF>::value, "");
+    static_assert(std::is_nothrow_move_constructible<IPF>::value, "");
+
+    auto p = std::make_unique<int>(40);
+    IPF f = [p = std::move(p)](int x) { return *p + x; };
+    EXPECT_TRUE(bool(f));
+    EXPECT_EQ(f(2), 42);
+
+    IPF g = std::move(f);
+    EXPECT_FALSE(bool(f));
+    EXPECT_EQ(g(3), 43);
+
+    f = [](int x) { return -x; };
+    f.swap(g);
+    EXPECT_EQ(f(1), 41);
+    EXPECT_EQ(g(1), -1);
+    swap(f, g);
+    EXPECT_EQ(f(1), -1);
+
+    // It can hold anything inplace_function can, and take it from one of smaller capacity.
+    sg14::inplace_function<int(int), 8> copyable = [](int x) { return x * 2; };
+    IPF h = copyable;
+    EXPECT_EQ(h(4), 8);
+    EXPECT_TRUE(bool(copyable));
+    IPF h2 = std::move(copyable);
+    EXPECT_FALSE(bool(copyable));
+    EXPECT_EQ(h2(5), 10);
+    sg14::inplace_move_only_function<int(int), 32> bigger = std::move(g);
+    EXPECT_EQ(bigger(7), 47);
+
+    auto count = std::make_shared<int>(0);
+    {
+        sg14::inplace_move_only_function<void()> k = [count]() { ++*count; };
+        k();
+        EXPECT_EQ(count.use_count(), 2);
+        k = nullptr;
+        EXPECT_EQ(count.use_count(), 1);
+        EXPECT_TRUE(k == nullptr);
+    }
+    EXPECT_EQ(*count, 1);
+    h = nullptr;
+    EXPECT_THROW(h(1), std::bad_function_call);
+}
+
+TEST(inplace_function, FunctionRef)
+{
+    using Ref = sg14::inplace_function_ref<int(int)>;
+    static_assert(sizeof(Ref) == 2 * sizeof(void*), "");
+    static_assert(std::is_trivially_copyable<Ref>::value, "");
+
+    // It refers to the callable, rather than copying it.
+    int calls = 0;
+    auto counter = [&calls](int x) { ++calls; return x + calls; };
+    Ref r = counter;
+    EXPECT_EQ(r(10), 11);
+    Ref r2 = r;
+    EXPECT_EQ(r2(10), 12);
+    EXPECT_EQ(calls, 2);
+
+    struct Immobile {
+        int state = 0;
+        Immobile() = default;
+        Immobile(Immobile&&) = delete;
+        int operator()(int x) { return state += x; }
+    } im;
+    Ref r3 = im;
+    r3(5);
+    r3(6);
+    EXPECT_EQ(im.state, 11);
+
+    const auto add_one = [](int x) { return x + 1; };
+    r3 = add_one;
+    EXPECT_EQ(r3(1), 2);
+
+    int (*twice)(int) = [](int x) { return 2 * x; };
+    Ref r4 = twice;
+    twice = nullptr;  // r4 holds the function pointer itself
+    EXPECT_EQ(r4(21), 42);
+
+    auto call = [](sg14::inplace_function_ref<void(std::unique_ptr<int>)> f) {
+        f(std::make_unique<int>(3));
+    };
+    int got = 0;
+    call([&](std::unique_ptr<int> p) { got = *p; });
+    EXPECT_EQ(got, 3);
+}
+
+namespace {
+
+// A bump allocator over a fixed buffer, like the arenas callers would spill into.
+struct Arena {
+    alignas(std::max_align_t) unsigned char buf[1024];
+    size_t used = 0;
+    int live = 0;
+};
+
+template<class T>
+struct ArenaAllocator {
+    using value_type = T;
+    Arena *arena_;
+
+    explicit ArenaAllocator(Arena *a) : arena_(a) {}
+    template<class U> ArenaAllocator(const ArenaAllocator<U>& rhs) : arena_(rhs.arena_) {}
+
+    T *allocate(size_t n) {
+        size_t at = (arena_->used + alignof(T) - 1) & ~(alignof(T) - 1);
+        arena_->used = at + n * sizeof(T);
+        arena_->live += 1;
+        return reinterpret_cast<T*>(arena_->buf + at);
+    }
+    void deallocate(T *, size_t) { arena_->live -= 1; }
+
+    template<class U> bool operator==(const ArenaAllocator<U>& rhs) const { return arena_ == rhs.arena_; }
+    template<class U> bool operator!=(const ArenaAllocator<U>& rhs) const { return arena_ != rhs.arena_; }
+};
+
+} // anonymous namespace
+
+TEST(inplace_function, SpillToArena)
+{
+    using IPF = sg14::inplace_function<int(int), 2 * sizeof(void*)>;
+    Arena arena;
+    ArenaAllocator<char> alloc(&arena);
+
+    // A callable that fits stays inplace, and allocates nothing.
+    IPF small(std::allocator_arg, alloc, [](int x) { return x + 1; });
+    EXPECT_FALSE(small.spilled());
+    EXPECT_EQ(small(1), 2);
+    EXPECT_EQ(arena.used, 0u);
+
+    std::array<int, 16> table;
+    table.fill(3);
+    IPF big(std::allocator_arg, alloc, [table](int x) { return table[x] * x; });
+    EXPECT_TRUE(big.spilled());
+    EXPECT_EQ(big(5), 15);
+    EXPECT_GE(arena.used, sizeof(table));
+    EXPECT_EQ(arena.live, 1);
+
+    // Moving keeps the spilled callable where it is; copying puts a new one in the arena.
+    size_t used = arena.used;
+    IPF moved = std::move(big);
+    EXPECT_TRUE(moved.spilled());
+    EXPECT_FALSE(bool(big));
+    EXPECT_FALSE(big.spilled());
+    EXPECT_EQ(arena.used, used);
+    IPF copy = moved;
+    EXPECT_TRUE(copy.spilled());
+    EXPECT_EQ(copy(2), 6);
+    EXPECT_EQ(arena.live, 2);
+
+    sg14::inplace_function<int(int), 64> wider = copy;
+    EXPECT_TRUE(wider.spilled());
+    EXPECT_EQ(arena.live, 3);
+
+    copy.swap(small);
+    EXPECT_FALSE(copy.spilled());
+    EXPECT_TRUE(small.spilled());
+    EXPECT_EQ(small(4), 12);
+    EXPECT_EQ(copy(4), 5);
+
+    small = nullptr;
+    wider = nullptr;
+    moved = copy;
+    EXPECT_EQ(arena.live, 0);
+
+    // A move-only callable can spill into inplace_move_only_function.
+    auto p = std::make_unique<std::array<int, 16>>(table);
+    sg14::inplace_move_only_function<int(int), 2 * sizeof(void*)> mo(std::allocator_arg, alloc,
+        [p = std::move(p), table](int x) { return (*p)[x] + table[x]; });
+    EXPECT_TRUE(mo.spilled());
+    EXPECT_EQ(mo(0), 6);
+    auto mo2 = std::move(mo);
+    EXPECT_EQ(mo2(1), 6);
+    EXPECT_EQ(arena.live, 1);
+    mo2 = nullptr;
+    EXPECT_EQ(arena.live, 0);
+
+    // Once spilled, only a pointer moves, so the callable's move constructor may throw.
+    struct ThrowingMove {
+        std::array<int, 16> t_;
+        explicit ThrowingMove(const std::array<int, 16>& t) : t_(t) {}
+        ThrowingMove(ThrowingMove&& rhs) noexcept(false) : t_(rhs.t_) {}
+        int operator()(int x) const { return t_[x] - x; }
+    };
+    static_assert(!std::is_nothrow_move_constructible<ThrowingMove>::value, "");
+    sg14::inplace_move_only_function<int(int), 2 * sizeof(void*)> tm(std::allocator_arg, alloc, ThrowingMove(table));
+    EXPECT_TRUE(tm.spilled());
+    auto tm2 = std::move(tm);
+    EXPECT_EQ(tm2(1), 2);
+    EXPECT_EQ(arena.live, 1);
+    tm2 = nullptr;
+    EXPECT_EQ(arena.live, 0);
+}
@@ -0,0 +1,151 @@
+#if __cplusplus >= 201703
+
+#include <sg14/inplace_ring.h>
+
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace {
+
+struct Counted {
+    static int live;
+    int v_;
+    explicit Counted(int v) : v_(v) { ++live; }
+    Counted(const Counted& rhs) : v_(rhs.v_) { ++live; }
+    Counted& operator=(const Counted&) = default;
+    ~Counted() { --live; }
+};
+int Counted::live = 0;
+
+struct NoDefault {
+    explicit NoDefault(std::string s) : s_(std::move(s)) {}
+    std::string s_;
+};
+
+} // namespace
+
+TEST(inplace_ring, TrivialTraits)
+{
+    {
+        using T = sg14::inplace_ring<int, 10>;
+        static_assert(std::is_trivially_copyable_v<T>);
+        static_assert(std::is_trivially_destructible_v<T>);
+        static_assert(std::is_nothrow_move_constructible_v<T>);
+    }
+    {
+        using T = sg14::inplace_ring<std::string, 10>;
+        static_assert(!std::is_trivially_copyable_v<T>);
+        static_assert(std::is_copy_constructible_v<T>);
+        static_assert(std::is_nothrow_move_constructible_v<T>);
+    }
+    {
+        using T = sg14::inplace_ring<std::unique_ptr<int>, 10>;
+        static_assert(!std::is_copy_constructible_v<T>);
+        static_assert(std::is_move_constructible_v<T>);
+        static_assert(std::is_move_assignable_v<T>);
+    }
+    {
+        using T = sg14::inplace_ring<std::mutex, 10>;
+        static_assert(!std::is_copy_constructible_v<T>);
+        static_assert(!std::is_move_constructible_v<T>);
+        static_assert(std::is_default_constructible_v<T>);
+    }
+}
+
+TEST(inplace_ring, Basic)
+{
+    sg14::inplace_ring<int, 3> r;
+    EXPECT_TRUE(r.empty());
+    EXPECT_EQ(r.capacity(), 3u);
+    r.push_back(1);
+    r.push_back(2);
+    EXPECT_EQ(r.size(), 2u);
+    EXPECT_EQ(r.front(), 1);
+    EXPECT_EQ(r.back(), 2);
+    EXPECT_EQ(r.pop_front(), 1);
+    r.push_back(3);
+    r.push_back(4);
+    EXPECT_TRUE(r.full());
+    r.emplace_back(5);  // overwrites 2, like ring_span
+    EXPECT_EQ(std::vector<int>(r.begin(), r.end()), (std::vector<int>{3, 4, 5}));
+    EXPECT_EQ(std::vector<int>(r.rbegin(), r.rend()), (std::vector<int>{5, 4, 3}));
+    EXPECT_EQ(r[1], 4);
+    EXPECT_EQ(r.end() - r.begin(), 3);
+    sg14::inplace_ring<int, 3>::const_iterator cit = r.begin();
+    EXPECT_EQ(cit, r.cbegin());
+    EXPECT_EQ(*(cit + 2), 5);
+
+    auto copy = r;
+    r.clear();
+    EXPECT_TRUE(r.empty());
+    EXPECT_EQ(std::vector<int>(copy.begin(), copy.end()), (std::vector<int>{3, 4, 5}));
+}
+
+TEST(inplace_ring, ConstructsAndDestroys)
+{
+    {
+        sg14::inplace_ring<Counted, 4> r;
+        EXPECT_EQ(Counted::live, 0);
+        for (int i = 0; i < 6; ++i) {
+            r.emplace_back(i);
+        }
+        EXPECT_EQ(Counted::live, 4);
+        EXPECT_EQ(r.pop_front().v_, 2);
+        EXPECT_EQ(Counted::live, 3);
+
+        // Copies of a wrapped-around ring keep the order.
+        auto copy = r;
+        EXPECT_EQ(Counted::live, 6);
+        EXPECT_EQ(copy.front().v_, 3);
+        EXPECT_EQ(copy.back().v_, 5);
+        r = copy;
+        EXPECT_EQ(Counted::live, 6);
+        r.push_back(r.front());  // refers to an element of r itself
+        r.push_back(r.front());  // now r is full, and this overwrites the element it refers to
+        EXPECT_EQ(r.front().v_, 4);
+        EXPECT_EQ(r.back().v_, 3);
+        EXPECT_EQ(Counted::live, 7);
+    }
+    EXPECT_EQ(Counted::live, 0);
+}
+
+TEST(inplace_ring, NonDefaultConstructible)
+{
+    sg14::inplace_ring<NoDefault, 2> r;
+    r.emplace_back("quick");
+    r.emplace_back("brown");
+    r.emplace_back("fox");
+    EXPECT_EQ(r.front().s_, "brown");
+    auto moved = std::move(r);
+    EXPECT_EQ(moved.pop_front().s_, "brown");
+    EXPECT_EQ(moved.pop_front().s_, "fox");
+    EXPECT_TRUE(moved.empty());
+
+    sg14::inplace_ring<std::unique_ptr<int>, 2> a, b;
+    a.push_back(std::make_unique<int>(1));
+    b.push_back(std::make_unique<int>(2));
+    b.push_back(std::make_unique<int>(3));
+    swap(a, b);
+    EXPECT_EQ(a.size(), 2u);
+    EXPECT_EQ(*a.back(), 3);
+    EXPECT_EQ(*b.front(), 1);
+}
+
+TEST(inplace_ring, Immobile)
+{
+    sg14::inplace_ring<std::mutex, 2> r;
+    r.emplace_back();
+    r.emplace_back();
+    r.emplace_back();
+    EXPECT_EQ(r.size(), 2u);
+    r.front().lock();
+    r.front().unlock();
+    r.clear();
+}
+
+#endif // __cplusplus >= 201703
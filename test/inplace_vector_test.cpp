@@ -977,6 +977,45 @@ TEST(inplace_vector, InsertMulti)
     }
 }
 
+namespace {
+struct Counted {
+    int v_;
+    static inline int countdown = 0;
+    explicit Counted(int v) : v_(v) {}
+    Counted(const Counted& rhs) : v_(rhs.v_) { if (countdown != 0 && --countdown == 0) throw 42; }
+    Counted(Counted&&) = default;
+    Counted& operator=(const Counted&) = default;
+    ~Counted() = default;
+    bool operator==(int v) const { return v_ == v; }
+};
+} // namespace
+
+TEST(inplace_vector, InsertIntoRelocatedWindow)
+{
+    // A trivially relocatable type is shifted by memmove to open a window for the
+    // new elements; if copying into the window throws, the window is closed again.
+    static_assert(sg14::ipv_trivially_relocatable_v<Counted>);
+    using V = sg14::inplace_vector<Counted, 8>;
+    V v;
+    for (int i = 1; i <= 4; ++i) {
+        v.emplace_back(i);
+    }
+    auto it = v.insert(v.begin() + 1, 2, Counted(9));
+    EXPECT_EQ(it, v.begin() + 1);
+    EXPECT_TRUE(std::equal(v.begin(), v.end(), std::vector<int>{1, 9, 9, 2, 3, 4}.begin()));
+    Counted::countdown = 2;
+    ASSERT_THROW(v.insert(v.begin() + 2, 2, Counted(7)), int);
+    EXPECT_TRUE(std::equal(v.begin(), v.end(), std::vector<int>{1, 9, 9, 2, 3, 4}.begin()));
+    Counted a[2] = {Counted(5), Counted(6)};
+    Counted::countdown = 2;
+    ASSERT_THROW(v.insert(v.begin(), a, a + 2), int);
+    EXPECT_EQ(v.size(), 6u);
+    EXPECT_TRUE(std::equal(v.begin(), v.end(), std::vector<int>{1, 9, 9, 2, 3, 4}.begin()));
+    v.erase(v.begin() + 1, v.begin() + 3);
+    v.erase(v.begin());
+    EXPECT_TRUE(std::equal(v.begin(), v.end(), std::vector<int>{2, 3, 4}.begin()));
+}
+
 TEST(inplace_vector, Assign)
 {
     {
@@ -1543,4 +1582,65 @@ TEST(inplace_vector, Resize)
     EXPECT_EQ(v, (sg14::inplace_vector<std::string, 4>{"", "b"})); // unchanged
 }
 
+TEST(inplace_vector, UncheckedAppendRange)
+{
+#if __cpp_lib_ranges >= 201911L
+    {
+        using V = sg14::inplace_vector<unsigned char, 16>;
+        V v = {1, 2};
+        unsigned char packet[] = {3, 4, 5};
+        v.unchecked_append_range(packet);
+        EXPECT_EQ(v, (V{1, 2, 3, 4, 5}));
+        v.unchecked_append_range(std::vector<unsigned char>{});
+        v.unchecked_append_range(std::vector<int>{6, 7});  // converts, rather than memcpy
+        EXPECT_EQ(v, (V{1, 2, 3, 4, 5, 6, 7}));
+    }
+    {
+        using V = sg14::inplace_vector<std::string, 5>;
+        V v;
+        v.unchecked_append_range(std::vector<std::string>{"1", "2"});
+        std::list<const char*> lst = {"3", "4"};
+        v.unchecked_append_range(lst);
+        EXPECT_EQ(v, Seq("1", "2", "3", "4"));
+    }
+    {
+        constexpr int sum = []() {
+            sg14::inplace_vector<int, 4> v;
+            int a[] = {1, 2, 3};
+            v.unchecked_append_range(a);
+            return v[0] + v[1] + v[2] + int(v.size());
+        }();
+        static_assert(sum == 9);
+    }
+#endif // __cpp_lib_ranges >= 201911L
+#if __cpp_lib_ranges >= 201911L && __cpp_lib_ranges_to_container >= 202202L
+    {
+        using V = sg14::inplace_vector<int, 4>;
+        V v = {1, 2};
+        ASSERT_THROW(v.append_range(std::vector<int>{3, 4, 5}), std::bad_alloc);
+        EXPECT_EQ(v, (V{1, 2}));  // unchanged, since the size is known up front
+        v.append_range(std::vector<int>{3, 4});
+        EXPECT_EQ(v, (V{1, 2, 3, 4}));
+    }
+#endif // __cpp_lib_ranges >= 201911L && __cpp_lib_ranges_to_container >= 202202L
+}
+
+TEST(inplace_vector, ResizeAndOverwrite)
+{
+    using V = sg14::inplace_vector<char, 8>;
+    V v = {'a', 'b'};
+    v.resize_and_overwrite(8, [](char *p, size_t n) {
+        EXPECT_EQ(n, 8u);
+        EXPECT_EQ(p[1], 'b');
+        p[2] = 'c';
+        p[3] = 'd';
+        return 4;
+    });
+    EXPECT_EQ(v, (V{'a', 'b', 'c', 'd'}));
+    v.resize_and_overwrite(3, [](char *, size_t) { return 1; });
+    EXPECT_EQ(v, (V{'a'}));
+    ASSERT_THROW(v.resize_and_overwrite(9, [](char *, size_t n) { return n; }), std::bad_alloc);
+    EXPECT_EQ(v, (V{'a'}));
+}
+
 #endif // __cplusplus >= 201703
@@ -2,8 +2,14 @@
 
 #include <gtest/gtest.h>
 
+#include <string.h>
+#include <atomic>
+#include <iterator>
+#include <memory>
 #include <numeric>
+#include <sstream>
 #include <string>
+#include <thread>
 #include <vector>
 
 TEST(ring_span, Basic)
@@ -156,3 +162,248 @@ TEST(ring_span, ReverseIterator)
     static_assert(std::is_same<decltype(r.crend()), decltype(r)::const_reverse_iterator>::value, "");
     static_assert(std::is_same<decltype(c.crend()), decltype(r)::const_reverse_iterator>::value, "");
 }
+
+TEST(ring_span, SpscBasic)
+{
+    int a[6];
+    sg14::spsc_ring_span<int> r(a, a+6);
+    EXPECT_EQ(r.capacity(), 4u);  // rounded down to a power of two
+    EXPECT_TRUE(r.empty());
+    int out = 0;
+    EXPECT_FALSE(r.try_pop(out));
+    for (int i = 0; i < 4; ++i) {
+        EXPECT_TRUE(r.try_push(i));
+    }
+    EXPECT_TRUE(r.full());
+    EXPECT_FALSE(r.try_push(4));
+    EXPECT_TRUE(r.try_pop(out));
+    EXPECT_EQ(out, 0);
+    EXPECT_TRUE(r.try_emplace(4));
+    EXPECT_EQ(r.size(), 4u);
+    for (int i = 1; i <= 4; ++i) {
+        EXPECT_TRUE(r.try_pop(out));
+        EXPECT_EQ(out, i);
+    }
+    EXPECT_TRUE(r.empty());
+}
+
+TEST(ring_span, PoppersOnConcurrentRings)
+{
+    std::vector<std::string> v(2);
+    sg14::spsc_ring_span<std::string, sg14::copy_popper<std::string>> s(v.begin(), v.end(), {"popped"});
+    std::string result;
+    EXPECT_TRUE(s.try_emplace("quick"));
+    EXPECT_TRUE(s.try_pop(result));
+    EXPECT_EQ(result, "quick");
+    EXPECT_EQ(v[0], "popped");
+
+    int a[2];
+    sg14::mpmc_ring_span<int, sg14::null_popper<int>> m(a, a+2);
+    EXPECT_TRUE(m.try_push(1));
+    EXPECT_TRUE(m.try_push(2));
+    EXPECT_FALSE(m.try_push(3));
+    EXPECT_TRUE(m.try_pop());
+    EXPECT_TRUE(m.try_pop());
+    EXPECT_FALSE(m.try_pop());
+    EXPECT_EQ(a[0], 1);
+    EXPECT_EQ(a[1], 2);
+}
+
+TEST(ring_span, MpmcBasic)
+{
+    std::vector<std::unique_ptr<int>> v(8);
+    sg14::mpmc_ring_span<std::unique_ptr<int>> r(v.begin(), v.end());
+    EXPECT_EQ(r.capacity(), 8u);
+    for (int lap = 0; lap < 3; ++lap) {
+        for (int i = 0; i < 8; ++i) {
+            EXPECT_TRUE(r.try_push(std::make_unique<int>(i)));
+        }
+        EXPECT_TRUE(r.full());
+        EXPECT_FALSE(r.try_emplace(new int(8)));
+        std::unique_ptr<int> out;
+        for (int i = 0; i < 8; ++i) {
+            EXPECT_TRUE(r.try_pop(out));
+            EXPECT_EQ(*out, i);
+        }
+        EXPECT_FALSE(r.try_pop(out));
+        EXPECT_TRUE(r.empty());
+    }
+}
+
+template<template<class, class> class Ring>
+static void test_threaded_ring(int producers, int consumers)
+{
+    constexpr int per_producer = 20000;
+    long long a[64];
+    Ring<long long, sg14::default_popper<long long>> r(a, a+64);
+    std::atomic<long long> sum{0};
+    std::atomic<int> popped{0};
+    std::vector<std::thread> threads;
+    for (int p = 0; p < producers; ++p) {
+        threads.emplace_back([&, p]() {
+            for (int i = 0; i < per_producer; ++i) {
+                long long x = (long long)p * per_producer + i;
+                while (!r.try_push(x)) {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+    const int total = producers * per_producer;
+    for (int c = 0; c < consumers; ++c) {
+        threads.emplace_back([&]() {
+            long long local = 0;
+            long long last[8] = {-1, -1, -1, -1, -1, -1, -1, -1};
+            long long x;
+            while (popped.load() < total) {
+                if (r.try_pop(x)) {
+                    // Each producer's values come out in the order it pushed them.
+                    int p = int(x / per_producer);
+                    EXPECT_LT(last[p], x);
+                    last[p] = x;
+                    local += x;
+                    popped.fetch_add(1);
+                } else {
+                    std::this_thread::yield();
+                }
+            }
+            sum.fetch_add(local);
+        });
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+    EXPECT_EQ(popped.load(), total);
+    EXPECT_EQ(sum.load(), (long long)total * (total - 1) / 2);
+    EXPECT_TRUE(r.empty());
+}
+
+TEST(ring_span, SpscThreads)
+{
+    test_threaded_ring<sg14::spsc_ring_span>(1, 1);
+}
+
+TEST(ring_span, MpmcThreads)
+{
+    test_threaded_ring<sg14::mpmc_ring_span>(4, 4);
+    test_threaded_ring<sg14::mpmc_ring_span>(1, 3);
+}
+
+TEST(ring_span, BulkPushPop)
+{
+    int a[5];
+    auto r = sg14::ring_span<int>(a, a+5);
+    std::vector<int> in = {1, 2, 3};
+    r.push_back(in.begin(), in.end());
+    EXPECT_EQ(r.size(), 3u);
+    r.pop_front();
+    r.push_back(in.begin(), in.end());  // wraps around the end of a
+    EXPECT_EQ(std::vector<int>(r.begin(), r.end()), (std::vector<int>{2, 3, 1, 2, 3}));
+    int more[] = {4, 5};
+    r.push_back(more, more+2);  // overwrites the two oldest
+    EXPECT_EQ(std::vector<int>(r.begin(), r.end()), (std::vector<int>{1, 2, 3, 4, 5}));
+    std::vector<int> big(12);
+    std::iota(big.begin(), big.end(), 10);
+    r.push_back(big.begin(), big.end());
+    EXPECT_EQ(std::vector<int>(r.begin(), r.end()), (std::vector<int>{17, 18, 19, 20, 21}));
+
+    int out[4] = {};
+    int *end = r.pop_front_n(4, out);
+    EXPECT_EQ(end, out+4);
+    EXPECT_EQ(std::vector<int>(out, out+4), (std::vector<int>{17, 18, 19, 20}));
+    EXPECT_EQ(r.size(), 1u);
+    EXPECT_EQ(r.front(), 21);
+    r.pop_front_n(1);
+    EXPECT_TRUE(r.empty());
+
+    // Input iterators are pushed one at a time.
+    std::istringstream iss("6 7 8");
+    r.push_back(std::istream_iterator<int>(iss), std::istream_iterator<int>());
+    EXPECT_EQ(std::vector<int>(r.begin(), r.end()), (std::vector<int>{6, 7, 8}));
+
+    std::vector<std::string> v = { "quick", "brown", "fox" };
+    sg14::ring_span<std::string, sg14::copy_popper<std::string>> rs(v.begin(), v.end(), {"popped"});
+    std::string words[] = {"slow", "red", "dog"};
+    rs.push_back(words, words+3);
+    std::vector<std::string> result;
+    rs.pop_front_n(2, std::back_inserter(result));
+    EXPECT_EQ(result, (std::vector<std::string>{"slow", "red"}));
+    EXPECT_EQ(v, (std::vector<std::string>{"popped", "popped", "dog"}));
+}
+
+TEST(ring_span, Segments)
+{
+    char a[8];
+    auto r = sg14::ring_span<char>(a, a+8);
+    auto w = r.writable_segments();
+    EXPECT_EQ(w.first.first, a);
+    EXPECT_EQ(w.first.second, 8u);
+    EXPECT_EQ(w.second.second, 0u);
+    memcpy(w.first.first, "abcdef", 6);
+    r.commit_back(6);
+    EXPECT_EQ(std::string(r.begin(), r.end()), "abcdef");
+    r.consume_front(4);
+    EXPECT_EQ(std::string(r.begin(), r.end()), "ef");
+
+    w = r.writable_segments();
+    EXPECT_EQ(w.first.first, a+6);
+    EXPECT_EQ(w.first.second, 2u);
+    EXPECT_EQ(w.second.first, a);
+    EXPECT_EQ(w.second.second, 4u);
+    memcpy(w.first.first, "gh", 2);
+    memcpy(w.second.first, "ij", 2);
+    r.commit_back(4);
+    EXPECT_EQ(std::string(r.begin(), r.end()), "efghij");
+
+    const auto& cr = r;
+    auto rd = cr.readable_segments();
+    EXPECT_EQ(std::string(rd.first.first, rd.first.second), "efgh");
+    EXPECT_EQ(std::string(rd.second.first, rd.second.second), "ij");
+    r.push_back('k');
+    r.push_back('l');
+    r.push_back('m');  // overwrites 'e'
+    auto rw = r.readable_segments();
+    EXPECT_EQ(std::string(rw.first.first, rw.first.second), "fgh");
+    EXPECT_EQ(std::string(rw.second.first, rw.second.second), "ijklm");
+    w = r.writable_segments();
+    EXPECT_EQ(w.first.second + w.second.second, 0u);
+}
+
+template<class Ring>
+static void test_capacity_policy(Ring r)
+{
+    EXPECT_EQ(r.capacity(), 4u);
+    for (int i = 0; i < 10; ++i) {
+        r.push_back(i);
+    }
+    EXPECT_EQ(std::vector<int>(r.begin(), r.end()), (std::vector<int>{6, 7, 8, 9}));
+    EXPECT_EQ(std::vector<int>(r.rbegin(), r.rend()), (std::vector<int>{9, 8, 7, 6}));
+    EXPECT_EQ(r.pop_front(), 6);
+    int in[] = {10, 11};
+    r.push_back(in, in+2);
+    EXPECT_EQ(std::vector<int>(r.begin(), r.end()), (std::vector<int>{8, 9, 10, 11}));
+    auto rd = r.readable_segments();
+    EXPECT_EQ(rd.first.second + rd.second.second, 4u);
+    int out[3];
+    r.pop_front_n(3, out);
+    EXPECT_EQ(std::vector<int>(out, out+3), (std::vector<int>{8, 9, 10}));
+    EXPECT_EQ(r.front(), 11);
+    EXPECT_EQ(r.back(), 11);
+}
+
+TEST(ring_span, CapacityPolicies)
+{
+    int a[4];
+    test_capacity_policy(sg14::ring_span<int>(a, a+4));
+    test_capacity_policy(sg14::ring_span<int, sg14::default_popper<int>, sg14::pow2_capacity>(a, a+4));
+    test_capacity_policy(sg14::ring_span<int, sg14::default_popper<int>, sg14::static_capacity<4>>(a, a+4));
+
+    double b[3];
+    sg14::ring_span<double, sg14::default_popper<double>, sg14::static_capacity<3>> r(b, b+3, b+2, 0);
+    r.push_back(1.0);
+    r.push_back(2.0);
+    EXPECT_EQ(r.size(), 2u);
+    EXPECT_EQ(r.front(), 1.0);
+    EXPECT_EQ(b[0], 2.0);
+    static_assert(decltype(r)::capacity_type::value() == 3, "");
+}
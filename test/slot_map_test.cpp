@@ -545,6 +545,114 @@ static void IndexesAreUsedEvenlyTest()
 #endif
 }
 
+template<class SM>
+static void BulkOperationsTest()
+{
+    using T = typename SM::mapped_type;
+    using Key = typename SM::key_type;
+    SM sm;
+    std::vector<Key> keys;
+    for (int i = 0; i < 10; ++i) {
+        keys.push_back(sm.emplace(Monad<T>::from_value(i)));
+    }
+    sm.erase(keys[3]);  // leave a slot on the free list
+    std::vector<Key> bulk_keys(40);
+    auto out = sm.emplace_n(40, bulk_keys.begin(), Monad<T>::from_value(100));
+    EXPECT_TRUE(out == bulk_keys.end());
+    EXPECT_TRUE(sm.size() == 49);
+    EXPECT_TRUE(sm.slot_count() == 49);  // one slot reused, 39 created
+    for (auto&& k : bulk_keys) {
+        EXPECT_TRUE(Monad<T>::value_of(*sm.find(k)) == 100);
+    }
+
+    // find_many() agrees with find(), including on expired keys.
+    std::vector<Key> probes = keys;
+    probes.insert(probes.end(), bulk_keys.begin(), bulk_keys.end());
+    std::vector<typename SM::iterator> found;
+    sm.find_many(probes.begin(), probes.end(), std::back_inserter(found));
+    ASSERT_TRUE(found.size() == probes.size());
+    const SM& csm = sm;
+    std::vector<typename SM::const_iterator> cfound;
+    csm.find_many(probes.begin(), probes.end(), std::back_inserter(cfound));
+    ASSERT_TRUE(cfound.size() == probes.size());
+    for (size_t i = 0; i < probes.size(); ++i) {
+        EXPECT_TRUE(found[i] == sm.find(probes[i]));
+        EXPECT_TRUE(cfound[i] == csm.find(probes[i]));
+    }
+
+    // Erase an expired key, a duplicated key, and every other bulk key.
+    std::vector<Key> doomed = { keys[3], keys[0], keys[9], keys[0] };
+    for (size_t i = 0; i < bulk_keys.size(); i += 2) {
+        doomed.push_back(bulk_keys[i]);
+    }
+    auto erased = sm.erase(doomed.begin(), doomed.end());
+    EXPECT_TRUE(erased == 22);
+    EXPECT_TRUE(sm.size() == 27);
+    for (auto&& k : doomed) {
+        EXPECT_TRUE(sm.find(k) == sm.end());
+    }
+    for (int i = 1; i < 9; ++i) {
+        if (i != 3) {
+            EXPECT_TRUE(Monad<T>::value_of(*sm.find(keys[i])) == Monad<T>::from_value(i));
+        }
+    }
+    for (size_t i = 1; i < bulk_keys.size(); i += 2) {
+        EXPECT_TRUE(Monad<T>::value_of(*sm.find(bulk_keys[i])) == 100);
+    }
+    EXPECT_TRUE(sm.erase(probes.begin(), probes.end()) == 27);
+    EXPECT_TRUE(sm.empty());
+}
+
+template<class SM>
+static void SortAndDeferredEraseTest()
+{
+    using T = typename SM::mapped_type;
+    auto value_of = [](const T& v) { return static_cast<int>(Monad<T>::value_of(v)); };
+    SM sm;
+    std::vector<typename SM::key_type> keys;
+    for (int i = 0; i < 20; ++i) {
+        keys.push_back(sm.emplace(Monad<T>::from_value((i * 7) % 20)));
+    }
+    sm.sort([&](const T& a, const T& b) { return value_of(a) < value_of(b); });
+    int expected = 0;
+    for (auto&& v : sm) {
+        EXPECT_TRUE(value_of(v) == expected);
+        ++expected;
+    }
+    for (int i = 0; i < 20; ++i) {
+        EXPECT_TRUE(value_of(*sm.find(keys[i])) == (i * 7) % 20);
+    }
+
+    // Deferred erasure expires the keys, but leaves the values in order until compaction.
+    for (int i = 0; i < 20; i += 3) {
+        EXPECT_TRUE(sm.erase_deferred(keys[i]) == 1);
+        EXPECT_TRUE(sm.erase_deferred(keys[i]) == 0);
+        EXPECT_TRUE(sm.find(keys[i]) == sm.end());
+    }
+    EXPECT_TRUE(sm.deferred_count() == 7);
+    EXPECT_TRUE(sm.size() == 20);
+    auto slots = sm.slot_count();
+    auto k100 = sm.emplace(Monad<T>::from_value(100));
+    EXPECT_TRUE(sm.slot_count() == slots + 1);  // the deferred slots aren't reused yet
+    sm.compact_in_order();
+    EXPECT_TRUE(sm.deferred_count() == 0);
+    EXPECT_TRUE(sm.size() == 14);
+    EXPECT_TRUE(std::is_sorted(sm.begin(), sm.end(), [&](const T& a, const T& b) { return value_of(a) < value_of(b); }));
+    EXPECT_TRUE(value_of(*sm.find(k100)) == 100);
+    for (int i = 0; i < 20; ++i) {
+        if (i % 3 == 0) {
+            EXPECT_TRUE(sm.find(keys[i]) == sm.end());
+        } else {
+            EXPECT_TRUE(value_of(*sm.find(keys[i])) == (i * 7) % 20);
+        }
+    }
+    slots = sm.slot_count();
+    for (int i = 0; i < 7; ++i) {
+        sm.emplace(Monad<T>::from_value(i));
+    }
+    EXPECT_TRUE(sm.slot_count() == slots);  // now they are
+}
+
 TEST(slot_map, Basic)
 {
     // Test the most basic slot_map.
@@ -561,6 +669,8 @@ TEST(slot_map, Basic)
     VerifyCapacityExists<slot_map_1>(true);
     GenerationsDontSkipTest<slot_map_1>();
     IndexesAreUsedEvenlyTest<slot_map_1>();
+    BulkOperationsTest<slot_map_1>();
+    SortAndDeferredEraseTest<slot_map_1>();
 }
 
 TEST(slot_map, CustomKeyType)
@@ -578,6 +688,8 @@ TEST(slot_map, CustomKeyType)
     VerifyCapacityExists<slot_map_2>(true);
     GenerationsDontSkipTest<slot_map_2>();
     IndexesAreUsedEvenlyTest<slot_map_2>();
+    BulkOperationsTest<slot_map_2>();
+    SortAndDeferredEraseTest<slot_map_2>();
 
 #if __cplusplus >= 201703L
     // Test slot_map with a custom key type (C++17 destructuring).
@@ -593,6 +705,8 @@ TEST(slot_map, CustomKeyType)
     VerifyCapacityExists<slot_map_3>(true);
     GenerationsDontSkipTest<slot_map_3>();
     IndexesAreUsedEvenlyTest<slot_map_3>();
+    BulkOperationsTest<slot_map_3>();
+    SortAndDeferredEraseTest<slot_map_3>();
 #endif // __cplusplus >= 201703L
 }
 
@@ -611,6 +725,8 @@ TEST(slot_map, DequeContainer)
     VerifyCapacityExists<slot_map_4>(false);
     GenerationsDontSkipTest<slot_map_4>();
     IndexesAreUsedEvenlyTest<slot_map_4>();
+    BulkOperationsTest<slot_map_4>();
+    SortAndDeferredEraseTest<slot_map_4>();
 }
 
 TEST(slot_map, CustomRAContainer)
@@ -629,6 +745,8 @@ TEST(slot_map, CustomRAContainer)
     VerifyCapacityExists<slot_map_5>(false);
     GenerationsDontSkipTest<slot_map_5>();
     IndexesAreUsedEvenlyTest<slot_map_5>();
+    BulkOperationsTest<slot_map_5>();
+    SortAndDeferredEraseTest<slot_map_5>();
 }
 
 TEST(slot_map, CustomBidiContainer)
@@ -648,6 +766,8 @@ TEST(slot_map, CustomBidiContainer)
     VerifyCapacityExists<slot_map_6>(false);
     GenerationsDontSkipTest<slot_map_6>();
     IndexesAreUsedEvenlyTest<slot_map_6>();
+    BulkOperationsTest<slot_map_6>();
+    SortAndDeferredEraseTest<slot_map_6>();
 }
 
 TEST(slot_map, MoveOnlyValueType)
@@ -670,6 +790,7 @@ TEST(slot_map, MoveOnlyValueType)
     VerifyCapacityExists<slot_map_7>(false);
     GenerationsDontSkipTest<slot_map_7>();
     IndexesAreUsedEvenlyTest<slot_map_7>();
+    SortAndDeferredEraseTest<slot_map_7>();
 }
 
 #if __cpp_concepts >= 202002
@@ -707,3 +828,213 @@ static_assert(SlotMapContainer<std::list>);
 static_assert(!SlotMapContainer<std::forward_list>);
 static_assert(!SlotMapContainer<std::pair>);
 #endif // __cpp_concepts >= 202002
+
+TEST(slot_map, PackedKey)
+{
+    using K = sg14::packed_key<20, 12>;
+    static_assert(sizeof(K) == 4, "");
+    static_assert(sizeof(sg14::packed_key<>) == 8, "");
+    static_assert(std::is_same<K::index_type, uint32_t>::value, "");
+    K k(5, 7);
+    EXPECT_EQ(k.index(), 5u);
+    EXPECT_EQ(k.generation(), 7u);
+    k.set_index(0xFFFFF);
+    k.increment_generation();
+    EXPECT_EQ(k.index(), 0xFFFFFu);
+    EXPECT_EQ(k.generation(), 8u);
+    EXPECT_EQ(K::from_rep(k.rep()), k);
+    EXPECT_EQ(std::hash<K>()(k), std::hash<uint32_t>()(k.rep()));
+
+    using slot_map_8 = sg14::slot_map<int, K>;
+    static_assert(std::is_same<typename slot_map_8::key_index_type, uint32_t>::value, "");
+    static_assert(std::is_same<typename slot_map_8::key_generation_type, uint32_t>::value, "");
+    BasicTests<slot_map_8>(42, 37);
+    BoundsCheckingTest<slot_map_8>();
+    FullContainerStressTest<slot_map_8>([]() { return 42; });
+    InsertEraseStressTest<slot_map_8>([i=3]() mutable { return ++i; });
+    EraseInLoopTest<slot_map_8>();
+    EraseRangeTest<slot_map_8>();
+    PartitionTest<slot_map_8>();
+    ReserveTest<slot_map_8>();
+    VerifyCapacityExists<slot_map_8>(true);
+    BulkOperationsTest<slot_map_8>();
+    SortAndDeferredEraseTest<slot_map_8>();
+}
+
+TEST(slot_map, GenerationWrapRetiresSlot)
+{
+    // With two generation bits, a slot hands out generations 0, 1 and 2,
+    // and is then retired rather than wrapping around to generation 0.
+    using SM = sg14::slot_map<int, sg14::packed_key<8, 2>>;
+    SM sm;
+    std::vector<SM::key_type> expired;
+    for (int i = 0; i < 3; ++i) {
+        auto k = sm.insert(i);
+        EXPECT_EQ(k.index(), 0u);
+        EXPECT_EQ(k.generation(), static_cast<unsigned>(i));
+        sm.erase(k);
+        expired.push_back(k);
+    }
+    auto k = sm.insert(3);
+    EXPECT_EQ(k.index(), 1u);
+    EXPECT_EQ(k.generation(), 0u);
+    EXPECT_EQ(sm.slot_count(), 2u);
+    for (auto&& ek : expired) {
+        EXPECT_TRUE(sm.find(ek) == sm.end());
+    }
+    EXPECT_EQ(sm.at(k), 3);
+}
+
+TEST(slot_map, IndexSpaceExhausted)
+{
+    // packed_key<8, 2> can index 255 slots, each good for three generations.
+    // Once they're all retired, there is no index left for a new slot.
+    using SM = sg14::slot_map<int, sg14::packed_key<8, 2>>;
+    static_assert(SM::max_slot_count() == 255, "");
+    SM sm;
+    EXPECT_THROW(sm.reserve_slots(256), std::length_error);
+    EXPECT_EQ(sm.slot_count(), 0u);
+    std::vector<SM::key_type> expired;
+    for (int i = 0; i < 255 * 3; ++i) {
+        auto k = sm.insert(i);
+        sm.erase(k);
+        expired.push_back(k);
+    }
+    EXPECT_EQ(sm.slot_count(), 255u);
+    EXPECT_THROW(sm.insert(0), std::length_error);
+    SM::key_type bulk[2];
+    EXPECT_THROW(sm.emplace_n(1, bulk, 0), std::length_error);
+    EXPECT_TRUE(sm.empty());
+    EXPECT_EQ(sm.slot_count(), 255u);
+    std::sort(expired.begin(), expired.end());
+    EXPECT_TRUE(std::adjacent_find(expired.begin(), expired.end()) == expired.end());
+
+    // A map that never retires its slots can still fill them all.
+    SM full;
+    for (int i = 0; i < 255; ++i) {
+        full.insert(i);
+    }
+    EXPECT_THROW(full.insert(255), std::length_error);
+    EXPECT_EQ(full.size(), 255u);
+    full.erase(full.begin());
+    auto k = full.insert(255);
+    EXPECT_EQ(full.at(k), 255);
+    full.erase(k);
+    EXPECT_THROW(full.emplace_n(2, bulk, 256), std::length_error);  // only one slot is free
+    EXPECT_EQ(full.size(), 254u);
+    EXPECT_TRUE(full.emplace_n(1, bulk, 256) == bulk + 1);
+    EXPECT_EQ(full.at(bulk[0]), 256);
+}
+
+TEST(slot_map, Stats)
+{
+    using Counting = sg14::slot_map_stats_policy::counting;
+    static_assert(sizeof(sg14::slot_map<int, std::pair<unsigned, unsigned>, std::vector, Counting>) > sizeof(sg14::slot_map<int>), "");
+    sg14::slot_map<int, std::pair<unsigned, unsigned>, std::vector, Counting> sm;
+    auto k0 = sm.insert(0);
+    auto k1 = sm.insert(1);
+    sm.insert(2);
+    EXPECT_EQ(sm.stats().slots_created, 3u);
+    EXPECT_EQ(sm.stats().free_list_reuses, 0u);
+
+    // Erasing from the middle moves the last value into the hole.
+    sm.erase(k1);
+    EXPECT_EQ(sm.stats().reverse_map_fixups, 1u);
+    sm.insert(3);
+    EXPECT_EQ(sm.stats().free_list_reuses, 1u);
+
+    sm.reserve_slots(10);
+    sm.insert(4);
+    EXPECT_EQ(sm.stats().slots_created, 3u);
+    EXPECT_EQ(sm.stats().free_list_reuses, 2u);
+
+    sm.sort(std::greater<int>());
+    EXPECT_GT(sm.stats().reverse_map_fixups, 1u);
+    EXPECT_EQ(sm[k0], 0);
+
+    sm.clear();
+    EXPECT_EQ(sm.stats().slots_created, 3u);
+    EXPECT_EQ(sm.stats().generation_wraps, 0u);
+    EXPECT_EQ(sm.stats().slots_retired, 0u);
+
+    // A pair-like key's generation wraps around to zero after 256 erasures.
+    sg14::slot_map<int, std::pair<unsigned, unsigned char>, std::vector, Counting> narrow;
+    for (int i = 0; i < 256; ++i) {
+        narrow.erase(narrow.insert(i));
+    }
+    EXPECT_EQ(narrow.stats().generation_wraps, 1u);
+    EXPECT_EQ(narrow.stats().slots_created, 1u);
+    EXPECT_EQ(narrow.stats().free_list_reuses, 255u);
+
+    // A packed_key's slot is retired instead.
+    sg14::slot_map<int, sg14::packed_key<8, 2>, std::vector, Counting> packed;
+    for (int i = 0; i < 3; ++i) {
+        packed.erase(packed.insert(i));
+    }
+    EXPECT_EQ(packed.stats().slots_retired, 1u);
+    EXPECT_EQ(packed.stats().generation_wraps, 0u);
+}
+
+TEST(slot_map, SnapshotView)
+{
+    sg14::slot_map<double, sg14::packed_key<20, 12>> sm;
+    std::vector<sg14::packed_key<20, 12>> keys;
+    for (int i = 0; i < 2000; ++i) {
+        keys.push_back(sm.insert(i * 0.5));
+    }
+    std::vector<sg14::packed_key<20, 12>> erased;
+    for (int i = 0; i < 2000; i += 3) {
+        sm.erase(keys[i]);
+        erased.push_back(keys[i]);
+    }
+    sm.insert(-1.0);  // take a slot off the free list
+    std::vector<char> bytes;
+    write_snapshot(sm, [&](const void *p, size_t n) {
+        bytes.insert(bytes.end(), static_cast<const char*>(p), static_cast<const char*>(p) + n);
+    });
+
+    using View = sg14::slot_map_view<double, sg14::packed_key<20, 12>>;
+    View v(bytes.data(), bytes.size());
+    ASSERT_EQ(v.size(), sm.size());
+    EXPECT_EQ(v.slot_count(), sm.slot_count());
+    EXPECT_TRUE(std::equal(v.begin(), v.end(), sm.begin(), sm.end()));
+    for (int i = 0; i < 2000; ++i) {
+        if (i % 3 == 0) {
+            EXPECT_TRUE(v.find(keys[i]) == v.end());
+        } else {
+            ASSERT_TRUE(v.find(keys[i]) != v.end());
+            EXPECT_EQ(*v.find(keys[i]), i * 0.5);
+            EXPECT_EQ(v.at(keys[i]), sm.at(keys[i]));
+        }
+    }
+    EXPECT_THROW(v.at(erased.back()), std::out_of_range);
+    EXPECT_TRUE(v.find(sg14::packed_key<20, 12>(5000, 0)) == v.end());
+
+    View empty;
+    EXPECT_TRUE(empty.empty());
+    EXPECT_TRUE(empty.find(keys[1]) == empty.end());
+
+    // A pair-like key works the same way, and is checked against the snapshot's key type.
+    sg14::slot_map<int> psm = {1, 2, 3};
+    auto pk = psm.insert(4);
+    bytes.clear();
+    sg14::write_snapshot(psm, [&](const void *p, size_t n) {
+        bytes.insert(bytes.end(), static_cast<const char*>(p), static_cast<const char*>(p) + n);
+    });
+    sg14::slot_map_view<int> pv(bytes.data(), bytes.size());
+    EXPECT_EQ(pv.at(pk), 4);
+    EXPECT_THROW(View(bytes.data(), bytes.size()), std::invalid_argument);
+    EXPECT_THROW((sg14::slot_map_view<int, std::pair<unsigned, unsigned char>>(bytes.data(), bytes.size())), std::invalid_argument);
+    EXPECT_THROW(sg14::slot_map_view<int>(bytes.data(), bytes.size() - 1), std::invalid_argument);
+    bytes[4] = 2;  // the version
+    EXPECT_THROW(sg14::slot_map_view<int>(bytes.data(), bytes.size()), std::invalid_argument);
+
+    // The underlying container needn't be contiguous.
+    sg14::slot_map<int, std::pair<unsigned, unsigned>, std::deque> dsm = {5, 6, 7};
+    bytes.clear();
+    sg14::write_snapshot(dsm, [&](const void *p, size_t n) {
+        bytes.insert(bytes.end(), static_cast<const char*>(p), static_cast<const char*>(p) + n);
+    });
+    sg14::slot_map_view<int> dv(bytes.data(), bytes.size());
+    EXPECT_TRUE(std::equal(dv.begin(), dv.end(), dsm.begin(), dsm.end()));
+}
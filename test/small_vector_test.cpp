@@ -0,0 +1,200 @@
+#if __cplusplus >= 201703
+
+#include <sg14/inplace_vector.h>
+#include <sg14/flat_map.h>
+
+#include <gtest/gtest.h>
+
+#include <list>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace {
+
+template<class V>
+bool is_inline(const V& v) {
+    auto p = (const char*)v.data();
+    return (const char*)&v <= p && p < (const char*)(&v + 1);
+}
+
+// Counts live heap buffers, and compares equal only to copies of itself.
+template<class T>
+struct CountingAllocator {
+    using value_type = T;
+    std::shared_ptr<int> live_;
+
+    explicit CountingAllocator() : live_(std::make_shared<int>(0)) {}
+    template<class U> CountingAllocator(const CountingAllocator<U>& rhs) : live_(rhs.live_) {}
+
+    T *allocate(size_t n) { *live_ += 1; return std::allocator<T>().allocate(n); }
+    void deallocate(T *p, size_t n) { *live_ -= 1; std::allocator<T>().deallocate(p, n); }
+
+    template<class U> bool operator==(const CountingAllocator<U>& rhs) const { return live_ == rhs.live_; }
+    template<class U> bool operator!=(const CountingAllocator<U>& rhs) const { return live_ != rhs.live_; }
+};
+
+struct MoveOnlyS {
+    explicit MoveOnlyS(const char *s) : s_(std::make_unique<std::string>(s)) {}
+    friend bool operator==(const MoveOnlyS& a, const MoveOnlyS& b) { return *a.s_ == *b.s_; }
+    std::unique_ptr<std::string> s_;
+};
+
+} // anonymous namespace
+
+TEST(small_vector, Traits)
+{
+    using V = sg14::small_vector<int, 8>;
+    static_assert(std::is_nothrow_move_constructible_v<V>);
+    static_assert(std::is_nothrow_move_assignable_v<V>);
+    static_assert(std::is_copy_constructible_v<V>);
+    static_assert(std::uses_allocator_v<V, std::allocator<int>>);
+    using M = sg14::small_vector<std::unique_ptr<int>, 2>;
+    static_assert(!std::is_copy_constructible_v<M>);
+    static_assert(!std::is_copy_assignable_v<M>);
+    static_assert(std::is_nothrow_move_constructible_v<M>);
+#if defined(__cpp_lib_trivially_relocatable)
+    static_assert(std::is_trivially_relocatable_v<V>);
+#endif // __cpp_lib_trivially_relocatable
+}
+
+TEST(small_vector, Spill)
+{
+    CountingAllocator<int> alloc;
+    sg14::small_vector<int, 4, CountingAllocator<int>> v(alloc);
+    for (int i = 0; i < 4; ++i) {
+        v.push_back(i);
+    }
+    EXPECT_TRUE(is_inline(v));
+    EXPECT_EQ(v.capacity(), 4u);
+    EXPECT_EQ(*alloc.live_, 0);
+
+    v.push_back(v[0]);  // grows while referring to one of its own elements
+    EXPECT_FALSE(is_inline(v));
+    EXPECT_EQ(v.capacity(), 8u);
+    EXPECT_EQ(*alloc.live_, 1);
+    EXPECT_EQ(v, (sg14::small_vector<int, 4, CountingAllocator<int>>({0, 1, 2, 3, 0}, alloc)));
+
+    v.insert(v.begin() + 1, 10, v[4]);
+    EXPECT_EQ(v.size(), 15u);
+    EXPECT_EQ(v[1], 0);
+    EXPECT_EQ(v[11], 1);
+    EXPECT_EQ(*alloc.live_, 1);
+
+    v.erase(v.begin() + 2, v.end());
+    EXPECT_EQ(v.size(), 2u);
+    v.shrink_to_fit();
+    EXPECT_TRUE(is_inline(v));
+    EXPECT_EQ(v.capacity(), 4u);
+    EXPECT_EQ(*alloc.live_, 0);
+    EXPECT_EQ(v, (sg14::small_vector<int, 4, CountingAllocator<int>>({0, 0}, alloc)));
+
+    v.reserve(100);
+    EXPECT_EQ(v.capacity(), 100u);
+    v.resize(50, 7);
+    v.shrink_to_fit();
+    EXPECT_EQ(v.capacity(), 50u);
+    v.clear();
+    EXPECT_EQ(v.capacity(), 50u);
+    EXPECT_EQ(*alloc.live_, 1);
+}
+
+TEST(small_vector, CopyAndMove)
+{
+    using V = sg14::small_vector<std::string, 2, CountingAllocator<std::string>>;
+    CountingAllocator<std::string> a1;
+    CountingAllocator<std::string> a2;
+    V big({"a", "b", "c"}, a1);
+    V small({"x"}, a1);
+
+    // A copy stays inline if it fits, however its source is stored.
+    big.pop_back();
+    V c1 = big;
+    EXPECT_TRUE(is_inline(c1));
+    EXPECT_EQ(c1, big);
+    big.push_back("c");
+    V c2(big, a2);
+    EXPECT_FALSE(is_inline(c2));
+    EXPECT_EQ(c2, big);
+    EXPECT_EQ(*a2.live_, 1);
+
+    // Moving a spilled vector steals its buffer; moving an inline one moves the elements.
+    const std::string *p = big.data();
+    V m1 = std::move(big);
+    EXPECT_EQ(m1.data(), p);
+    EXPECT_TRUE(big.empty());
+    V m2 = std::move(small);
+    EXPECT_TRUE(is_inline(m2));
+    EXPECT_EQ(m2, V({"x"}, a1));
+    EXPECT_EQ(*a1.live_, 1);
+
+    // With unequal allocators, a move can't steal.
+    V m3(std::move(m1), a2);
+    EXPECT_EQ(m3, c2);
+    EXPECT_EQ(*a2.live_, 2);
+
+    m2 = c2;
+    EXPECT_EQ(m2, c2);
+    m2 = std::move(m3);
+    EXPECT_EQ(m2, c2);
+    swap(m2, c1);
+    EXPECT_EQ(c1, c2);
+    EXPECT_EQ(m2, V({"a", "b"}, a1));
+    m2 = {"q", "r", "s", "t"};
+    EXPECT_EQ(m2.size(), 4u);
+    EXPECT_TRUE(m2 != c1);
+}
+
+TEST(small_vector, MoveOnly)
+{
+    sg14::small_vector<MoveOnlyS, 1> v;
+    v.emplace_back("a");
+    v.emplace_back("b");
+    v.emplace(v.begin(), "c");
+    EXPECT_EQ(v.size(), 3u);
+    EXPECT_EQ(*v[0].s_, "c");
+    EXPECT_EQ(*v[2].s_, "b");
+    auto w = std::move(v);
+    EXPECT_EQ(*w.at(1).s_, "a");
+    EXPECT_THROW(w.at(3), std::out_of_range);
+    EXPECT_EQ(sg14::erase_if(w, [](const MoveOnlyS& m) { return *m.s_ != "a"; }), 2u);
+    w.shrink_to_fit();
+    EXPECT_TRUE(is_inline(w));
+    EXPECT_EQ(*w.front().s_, "a");
+}
+
+TEST(small_vector, ZeroCapacity)
+{
+    sg14::small_vector<int, 0> v;
+    EXPECT_EQ(v.capacity(), 0u);
+    std::list<int> lst = {1, 2, 3};
+    v.assign(lst.begin(), lst.end());
+    v.insert(v.begin(), lst.begin(), lst.end());
+    EXPECT_EQ(v, (sg14::small_vector<int, 0>{1, 2, 3, 1, 2, 3}));
+    v.clear();
+    v.shrink_to_fit();
+    EXPECT_EQ(v.capacity(), 0u);
+}
+
+TEST(small_vector, FlatMapContainer)
+{
+    using KC = sg14::small_vector<int, 8>;
+    using MC = sg14::small_vector<std::string, 8>;
+    sg14::flat_map<int, std::string, std::less<int>, KC, MC> fm;
+    for (int i = 0; i < 20; ++i) {
+        fm.emplace(19 - i, std::to_string(i));
+    }
+    EXPECT_EQ(fm.size(), 20u);
+    EXPECT_EQ(fm.begin()->first, 0);
+    EXPECT_EQ(fm[5], "14");
+    fm.erase(fm.begin(), fm.begin() + 15);
+    EXPECT_EQ(fm.size(), 5u);
+    auto keys = std::move(fm).extract().keys;
+    keys.shrink_to_fit();
+    EXPECT_TRUE(is_inline(keys));
+    EXPECT_EQ(keys, (KC{15, 16, 17, 18, 19}));
+}
+
+#endif // __cplusplus >= 201703
@@ -90,3 +90,87 @@ TEST(uninitialized_default_construct, Basic)
         free(mem2);
     }
 }
+
+TEST(uninitialized_relocate, Basic)
+{
+    for (int n = 0; n < 256; ++n) {
+        auto mem1 = (lifetest*)malloc(sizeof(lifetest) * n);
+        auto mem2 = (lifetest*)malloc(sizeof(lifetest) * n);
+        sg14::uninitialized_default_construct(mem1, mem1 + n);
+        lifetest::reset();
+
+        auto end = sg14::uninitialized_relocate(mem1, mem1 + n, mem2);
+        ASSERT_EQ(end, mem2 + n);
+        lifetest::test(0, n, n);
+
+        sg14::destroy(mem2, mem2 + n);
+        lifetest::test(0, 2 * n, n);
+
+        free(mem1);
+        free(mem2);
+    }
+
+    // Trivially relocatable types are memmoved, so the ranges may overlap either way.
+    std::array<int, 10> a = {1, 2, 3, 4, 5, 6, 7, 8, 9, 10};
+    int *end = sg14::uninitialized_relocate(a.data(), a.data() + 6, a.data() + 2);
+    EXPECT_EQ(end, a.data() + 8);
+    EXPECT_EQ(a, (std::array<int, 10>{1, 2, 1, 2, 3, 4, 5, 6, 9, 10}));
+    sg14::uninitialized_relocate(a.data() + 4, a.data() + 10, a.data());
+    EXPECT_EQ(a, (std::array<int, 10>{3, 4, 5, 6, 9, 10, 5, 6, 9, 10}));
+
+    // Non-pointer iterators take the element-wise path.
+    std::vector<std::unique_ptr<int>> v;
+    v.push_back(std::make_unique<int>(1));
+    v.push_back(std::make_unique<int>(2));
+    alignas(std::unique_ptr<int>) unsigned char buf[2 * sizeof(std::unique_ptr<int>)];
+    auto *dst = reinterpret_cast<std::unique_ptr<int>*>(buf);
+    sg14::uninitialized_relocate(v.begin(), v.end(), dst);
+    EXPECT_EQ(*dst[1], 2);
+    sg14::destroy(dst, dst + 2);
+    ::new (static_cast<void*>(&v[0])) std::unique_ptr<int>();  // v's elements were destroyed
+    ::new (static_cast<void*>(&v[1])) std::unique_ptr<int>();
+}
+
+namespace {
+    struct thrower {
+        static int live;
+        int i_;
+        explicit thrower(int i) : i_(i) { ++live; }
+        thrower(thrower&& rhs) : i_(rhs.i_) { if (i_ == 3) throw 42; ++live; }
+        ~thrower() { --live; }
+    };
+    int thrower::live = 0;
+} // namespace
+
+TEST(uninitialized_relocate, Throwing)
+{
+    alignas(thrower) unsigned char src[5 * sizeof(thrower)];
+    alignas(thrower) unsigned char dst[5 * sizeof(thrower)];
+    auto *s = reinterpret_cast<thrower*>(src);
+    for (int i = 0; i < 5; ++i) {
+        ::new (static_cast<void*>(s + i)) thrower(i);
+    }
+    EXPECT_EQ(thrower::live, 5);
+    EXPECT_THROW(sg14::uninitialized_relocate(s, s + 5, reinterpret_cast<thrower*>(dst)), int);
+    EXPECT_EQ(thrower::live, 0);  // both the relocated and the unrelocated elements are gone
+}
+
+TEST(relocate_at, Basic)
+{
+    {
+        auto mem = (lifetest*)malloc(sizeof(lifetest) * 2);
+        sg14::uninitialized_default_construct(mem, mem + 1);
+        lifetest::reset();
+        lifetest *p = sg14::relocate_at(mem, mem + 1);
+        EXPECT_EQ(p, mem + 1);
+        lifetest::test(0, 1, 1);
+        sg14::destroy(p, p + 1);
+        free(mem);
+    }
+    {
+        double d[2] = {3.5, 0};
+        double *p = sg14::relocate_at(&d[0], &d[1]);
+        EXPECT_EQ(p, &d[1]);
+        EXPECT_EQ(d[1], 3.5);
+    }
+}
@@ -124,3 +124,57 @@ TEST(unstable_remove, DequeExamples)
         EXPECT_TRUE(std::is_permutation(dq.begin(), dq.end(), expected.begin(), expected.end()));
     }
 }
+
+TEST(unstable_remove, ManySizesAndDensities)
+{
+    // Random-access ranges of trivially copyable types are processed 64 elements at a time;
+    // this covers the seams between blocks and the scalar tail.
+    std::mt19937 g;
+    for (int n : {0, 1, 63, 64, 65, 127, 128, 129, 200, 1000, 4099}) {
+        for (int density : {0, 1, 50, 99, 100}) {
+            std::vector<int> original;
+            for (int i = 0; i < n; ++i) {
+                original.push_back(int(g() % 100) < density ? -1 : int(g() % 1000));
+            }
+            auto expected = original;
+            expected.erase(std::remove(expected.begin(), expected.end(), -1), expected.end());
+
+            auto v = original;
+            auto it = sg14::unstable_remove(v.begin(), v.end(), -1);
+            EXPECT_TRUE(std::is_permutation(v.begin(), it, expected.begin(), expected.end()));
+
+            v = original;
+            it = sg14::unstable_remove_if(v.begin(), v.end(), [](int x) { return x < 0; });
+            EXPECT_TRUE(std::is_permutation(v.begin(), it, expected.begin(), expected.end()));
+
+            // Elements before the first "p" stay where they were.
+            auto prefix = std::find(original.begin(), original.end(), -1) - original.begin();
+            EXPECT_TRUE(std::equal(v.begin(), v.begin() + prefix, original.begin()));
+        }
+    }
+}
+
+#if SG14_EXECUTION_POLICIES
+TEST(unstable_remove, ParallelRemoveIf)
+{
+    std::mt19937 g;
+    for (int n : {100, 1 << 14, 100'000, 1'000'000}) {
+        for (int density : {0, 3, 50, 97, 100}) {
+            std::vector<int> original;
+            for (int i = 0; i < n; ++i) {
+                original.push_back(int(g() % 100) < density ? -int(g() % 1000) - 1 : int(g() % 1000));
+            }
+            auto pred = [](int x) { return x < 0; };
+            auto expected = original;
+            expected.erase(std::remove_if(expected.begin(), expected.end(), pred), expected.end());
+            std::sort(expected.begin(), expected.end());
+
+            auto v = original;
+            auto it = sg14::unstable_remove_if(std::execution::par, v.begin(), v.end(), pred);
+            ASSERT_EQ(it - v.begin(), ptrdiff_t(expected.size()));
+            std::sort(v.begin(), it);
+            EXPECT_TRUE(std::equal(v.begin(), it, expected.begin(), expected.end()));
+        }
+    }
+}
+#endif // SG14_EXECUTION_POLICIES